@@ -24,7 +24,25 @@
 #include <Protocol/Dhcp4.h>
 #include <Protocol/Mtftp4.h>
 
-#define MAX_TFTP_FILE_SIZE    0x01000000
+#include <Library/TimerLib.h>
+
+#define MAX_TFTP_FILE_SIZE    0x10000000
+
+/* Type and defines to set up the TFTP options */
+
+#define TFTP_DEFAULT_BLKSIZE    512
+
+#define TFTP_OPTION_TSIZE       BIT0
+#define TFTP_OPTION_BLKSIZE     BIT1
+#define TFTP_OPTION_WINDOWSIZE  BIT2
+
+typedef struct {
+  UINT32             Mask;
+  UINT32             Count;
+  EFI_MTFTP4_OPTION  List[3];
+  CHAR8              BlkSize[6];
+  CHAR8              WindowSize[6];
+} BDS_TFTP_OPTIONS;
 
 /* Type and defines to set up the DHCP4 options */
 
@@ -828,11 +846,55 @@ BdsTftpSupport (
 }
 
 /**
-  Worker function that get the size in numbers of bytes of a file from a TFTP
-  server before to download the file.
+  Fill in the list of TFTP options to send with a request.
+
+  The block size and window size values are taken from the PCDs the first
+  time and from the server OACK once the options have been negotiated.
+
+  @param[in]      OptionMask  Bitmask of the TFTP_OPTION_* options to send
+  @param[in, out] Options     Option list and value storage to fill in
+
+**/
+STATIC
+VOID
+Mtftp4SetOptions (
+  IN     UINT32            OptionMask,
+  IN OUT BDS_TFTP_OPTIONS  *Options
+  )
+{
+  Options->Mask  = OptionMask;
+  Options->Count = 0;
+
+  if ((OptionMask & TFTP_OPTION_TSIZE) != 0) {
+    Options->List[Options->Count].OptionStr = (UINT8*)"tsize";
+    Options->List[Options->Count].ValueStr  = (UINT8*)"0";
+    Options->Count++;
+  }
+  if ((OptionMask & TFTP_OPTION_BLKSIZE) != 0) {
+    Options->List[Options->Count].OptionStr = (UINT8*)"blksize";
+    Options->List[Options->Count].ValueStr  = (UINT8*)Options->BlkSize;
+    Options->Count++;
+  }
+  if ((OptionMask & TFTP_OPTION_WINDOWSIZE) != 0) {
+    Options->List[Options->Count].OptionStr = (UINT8*)"windowsize";
+    Options->List[Options->Count].ValueStr  = (UINT8*)Options->WindowSize;
+    Options->Count++;
+  }
+}
+
+/**
+  Worker function that negotiates the TFTP options with the server before to
+  download the file, and gets the size in numbers of bytes of the file.
+
+  The RFC 2349 tsize, RFC 2348 blksize and RFC 7440 windowsize options are
+  requested together. If either the local MTFTP4 driver or the server rejects
+  the request, the window size and then the block size are dropped and the
+  request is retried, down to a plain tsize query.
 
   @param[in]   Mtftp4    MTFTP4 protocol interface
   @param[in]   FilePath  Path of the file, Ascii encoded
+  @param[out]  Options   Options acknowledged by the server, to be sent with
+                         the read request.
   @param[out]  FileSize  Address where to store the file size in number of
                          bytes.
 
@@ -842,39 +904,63 @@ BdsTftpSupport (
 **/
 STATIC
 EFI_STATUS
-Mtftp4GetFileSize (
+Mtftp4NegotiateOptions (
   IN  EFI_MTFTP4_PROTOCOL  *Mtftp4,
   IN  CHAR8                *FilePath,
+  OUT BDS_TFTP_OPTIONS     *Options,
   OUT UINT64               *FileSize
   )
 {
   EFI_STATUS         Status;
-  EFI_MTFTP4_OPTION  ReqOpt[1];
   EFI_MTFTP4_PACKET  *Packet;
   UINT32             PktLen;
   EFI_MTFTP4_OPTION  *TableOfOptions;
   EFI_MTFTP4_OPTION  *Option;
   UINT32             OptCnt;
-  UINT8              OptBuf[128];
-
-  ReqOpt[0].OptionStr = (UINT8*)"tsize";
-  OptBuf[0] = '0';
-  OptBuf[1] = 0;
-  ReqOpt[0].ValueStr = OptBuf;
-
-  Status = Mtftp4->GetInfo (
-             Mtftp4,
-             NULL,
-             (UINT8*)FilePath,
-             NULL,
-             1,
-             ReqOpt,
-             &PktLen,
-             &Packet
-             );
+  UINT32             OptionMask;
+  UINT32             Accepted;
 
-  if (EFI_ERROR (Status)) {
-    goto Error;
+  AsciiSPrint (Options->BlkSize, sizeof (Options->BlkSize), "%d", PcdGet16 (PcdTftpBlockSize));
+  AsciiSPrint (Options->WindowSize, sizeof (Options->WindowSize), "%d", PcdGet16 (PcdTftpWindowSize));
+
+  OptionMask = TFTP_OPTION_TSIZE;
+  if (PcdGet16 (PcdTftpBlockSize) > TFTP_DEFAULT_BLKSIZE) {
+    OptionMask |= TFTP_OPTION_BLKSIZE;
+  }
+  if (PcdGet16 (PcdTftpWindowSize) > 1) {
+    OptionMask |= TFTP_OPTION_WINDOWSIZE;
+  }
+
+  while (TRUE) {
+    Mtftp4SetOptions (OptionMask, Options);
+    Status = Mtftp4->GetInfo (
+               Mtftp4,
+               NULL,
+               (UINT8*)FilePath,
+               NULL,
+               (UINT8)Options->Count,
+               Options->List,
+               &PktLen,
+               &Packet
+               );
+    if (!EFI_ERROR (Status)) {
+      break;
+    }
+
+    //
+    // EFI_UNSUPPORTED is returned when the local MTFTP4 driver does not know
+    // one of the options, EFI_TFTP_ERROR when the server refused the request.
+    //
+    if ((Status != EFI_UNSUPPORTED) && (Status != EFI_TFTP_ERROR)) {
+      goto Error;
+    }
+    if ((OptionMask & TFTP_OPTION_WINDOWSIZE) != 0) {
+      OptionMask &= ~TFTP_OPTION_WINDOWSIZE;
+    } else if ((OptionMask & TFTP_OPTION_BLKSIZE) != 0) {
+      OptionMask &= ~TFTP_OPTION_BLKSIZE;
+    } else {
+      goto Error;
+    }
   }
 
   Status = Mtftp4->ParseOptions (
@@ -885,29 +971,82 @@ Mtftp4GetFileSize (
                      &TableOfOptions
                      );
   if (EFI_ERROR (Status)) {
+    FreePool (Packet);
     goto Error;
   }
 
-  Option = TableOfOptions;
-  while (OptCnt != 0) {
-    if (AsciiStrnCmp ((CHAR8 *)Option->OptionStr, "tsize", 5) == 0) {
+  //
+  // Only keep the options the server acknowledged, with the values it chose.
+  //
+  Accepted = 0;
+  for (Option = TableOfOptions; OptCnt != 0; OptCnt--, Option++) {
+    if (AsciiStriCmp ((CHAR8 *)Option->OptionStr, "tsize") == 0) {
       *FileSize = AsciiStrDecimalToUint64 ((CHAR8 *)Option->ValueStr);
-      break;
+      Accepted |= TFTP_OPTION_TSIZE;
+    } else if ((AsciiStriCmp ((CHAR8 *)Option->OptionStr, "blksize") == 0) &&
+               (AsciiStrSize ((CHAR8 *)Option->ValueStr) <= sizeof (Options->BlkSize))) {
+      AsciiStrCpyS (Options->BlkSize, sizeof (Options->BlkSize), (CHAR8 *)Option->ValueStr);
+      Accepted |= TFTP_OPTION_BLKSIZE;
+    } else if ((AsciiStriCmp ((CHAR8 *)Option->OptionStr, "windowsize") == 0) &&
+               (AsciiStrSize ((CHAR8 *)Option->ValueStr) <= sizeof (Options->WindowSize))) {
+      AsciiStrCpyS (Options->WindowSize, sizeof (Options->WindowSize), (CHAR8 *)Option->ValueStr);
+      Accepted |= TFTP_OPTION_WINDOWSIZE;
     }
-    OptCnt--;
-    Option++;
   }
   FreePool (TableOfOptions);
+  FreePool (Packet);
 
-  if (OptCnt == 0) {
+  Mtftp4SetOptions (Accepted & OptionMask & ~TFTP_OPTION_TSIZE, Options);
+
+  if ((Accepted & TFTP_OPTION_TSIZE) == 0) {
     Status = EFI_UNSUPPORTED;
   }
+  return Status;
 
 Error :
+  Mtftp4SetOptions (0, Options);
 
   return Status;
 }
 
+/**
+  Convert an interval measured with the performance counter to milliseconds.
+
+  @param[in]  Start  Performance counter value at the start of the interval
+  @param[in]  End    Performance counter value at the end of the interval
+
+  @return  Duration of the interval in milliseconds
+
+**/
+STATIC
+UINT64
+BdsElapsedMilliseconds (
+  IN UINT64  Start,
+  IN UINT64  End
+  )
+{
+  UINT64  CounterStart;
+  UINT64  CounterEnd;
+  UINT64  Ticks;
+
+  GetPerformanceCounterProperties (&CounterStart, &CounterEnd);
+  if (CounterStart < CounterEnd) {
+    if (End >= Start) {
+      Ticks = End - Start;
+    } else {
+      Ticks = (CounterEnd - Start) + (End - CounterStart);
+    }
+  } else {
+    if (Start >= End) {
+      Ticks = Start - End;
+    } else {
+      Ticks = (CounterStart - End) + (Start - CounterEnd);
+    }
+  }
+
+  return DivU64x32 (GetTimeInNanoSecond (Ticks), 1000000);
+}
+
 /**
   Update the progress of a file download
   This procedure is called each time a new TFTP packet is received.
@@ -1040,10 +1179,13 @@ BdsTftpLoadImage (
   CHAR16                   *PathName;
   CHAR8                    *AsciiFilePath;
   EFI_MTFTP4_TOKEN         Mtftp4Token;
+  BDS_TFTP_OPTIONS         TftpOptions;
   UINT64                   FileSize;
   UINT64                   TftpBufferSize;
   BDS_TFTP_CONTEXT         *TftpContext;
   UINTN                    PathNameLen;
+  UINT64                   StartTicks;
+  UINT64                   ElapsedMs;
 
   ASSERT(IS_DEVICE_PATH_NODE (RemainingDevicePath, MESSAGING_DEVICE_PATH, MSG_IPv4_DP));
   IPv4DevicePathNode = (IPv4_DEVICE_PATH*)RemainingDevicePath;
@@ -1164,8 +1306,8 @@ BdsTftpLoadImage (
 
   ZeroMem (&Mtftp4CfgData, sizeof (EFI_MTFTP4_CONFIG_DATA));
   Mtftp4CfgData.UseDefaultSetting = FALSE;
-  Mtftp4CfgData.TimeoutValue      = 4;
-  Mtftp4CfgData.TryCount          = 6;
+  Mtftp4CfgData.TimeoutValue      = PcdGet16 (PcdTftpTimeout);
+  Mtftp4CfgData.TryCount          = PcdGet16 (PcdTftpTryCount);
 
   if (IPv4DevicePathNode->StaticIpAddress) {
     CopyMem (&Mtftp4CfgData.StationIp , &IPv4DevicePathNode->LocalIpAddress, sizeof (EFI_IPv4_ADDRESS));
@@ -1192,11 +1334,12 @@ BdsTftpLoadImage (
   UnicodeStrToAsciiStrS (PathName, AsciiFilePath, PathNameLen);
 
   //
-  // Try to get the size of the file in bytes from the server. If it fails,
-  // start with a 8MB buffer to download the file.
+  // Negotiate the block and window sizes and try to get the size of the file
+  // in bytes from the server. If the size is not known, start with a 16MB
+  // buffer to download the file.
   //
   FileSize = 0;
-  if (Mtftp4GetFileSize (Mtftp4, AsciiFilePath, &FileSize) == EFI_SUCCESS) {
+  if (Mtftp4NegotiateOptions (Mtftp4, AsciiFilePath, &TftpOptions, &FileSize) == EFI_SUCCESS) {
     TftpBufferSize = FileSize;
   } else {
     TftpBufferSize = SIZE_16MB;
@@ -1209,10 +1352,11 @@ BdsTftpLoadImage (
   }
   TftpContext->FileSize = FileSize;
 
-  for (; TftpBufferSize <= MAX_TFTP_FILE_SIZE;
-         TftpBufferSize = (TftpBufferSize + SIZE_16MB) & (~(SIZE_16MB-1))) {
+  Status = EFI_BUFFER_TOO_SMALL;
+  while (TftpBufferSize <= MAX_TFTP_FILE_SIZE) {
     //
-    // Allocate a buffer to hold the whole file.
+    // Allocate a buffer to hold the whole file. MTFTP4 writes every data
+    // block straight into it.
     //
     Status = gBS->AllocatePages (
                     Type,
@@ -1234,14 +1378,24 @@ BdsTftpLoadImage (
     Mtftp4Token.Buffer      = (VOID *)(UINTN)*Image;
     Mtftp4Token.CheckPacket = Mtftp4CheckPacket;
     Mtftp4Token.Context     = (VOID*)TftpContext;
+    Mtftp4Token.OptionCount = (UINT8)TftpOptions.Count;
+    Mtftp4Token.OptionList  = TftpOptions.List;
 
     Print (L"Downloading the file <%a> from the TFTP server\n", AsciiFilePath);
+    StartTicks = GetPerformanceCounter ();
     Status = Mtftp4->ReadFile (Mtftp4, &Mtftp4Token);
+    ElapsedMs = BdsElapsedMilliseconds (StartTicks, GetPerformanceCounter ());
     Print (L"\n");
     if (EFI_ERROR (Status)) {
       gBS->FreePages (*Image, EFI_SIZE_TO_PAGES (TftpBufferSize));
       if (Status == EFI_BUFFER_TOO_SMALL) {
         Print (L"Downloading failed, file larger than expected.\n");
+        TftpBufferSize = (TftpBufferSize + SIZE_16MB) & (~(SIZE_16MB-1));
+        continue;
+      } else if (((Status == EFI_TFTP_ERROR) || (Status == EFI_UNSUPPORTED)) &&
+                 (TftpOptions.Count != 0)) {
+        Print (L"TFTP options rejected, retrying with the default block size.\n");
+        Mtftp4SetOptions (0, &TftpOptions);
         continue;
       } else {
         goto Error;
@@ -1249,6 +1403,23 @@ BdsTftpLoadImage (
     }
 
     *ImageSize = Mtftp4Token.BufferSize;
+
+    Print (
+      L"Downloaded %ld bytes in %ld ms",
+      (UINT64)*ImageSize,
+      ElapsedMs
+      );
+    if (ElapsedMs != 0) {
+      Print (
+        L" (%ld KB/s)",
+        DivU64x64Remainder (MultU64x32 (*ImageSize, 1000), MultU64x32 (ElapsedMs, 1024), NULL)
+        );
+    }
+    Print (
+      L", blksize %a, windowsize %a\n",
+      ((TftpOptions.Mask & TFTP_OPTION_BLKSIZE) != 0) ? TftpOptions.BlkSize : "512",
+      ((TftpOptions.Mask & TFTP_OPTION_WINDOWSIZE) != 0) ? TftpOptions.WindowSize : "1"
+      );
     break;
   }
 
@@ -19,6 +19,8 @@
 STATIC EFI_EVENT mFlashFvbVirtualAddrChangeEvent;
 STATIC UINTN     mFlashNvStorageVariableBase;
 
+STATIC FLASH_INSTANCE*  mFlashShadowInstance;
+
 
 //
 // Global variable declarations
@@ -103,7 +105,9 @@ FLASH_INSTANCE  mFlashInstanceTemplate =
             {sizeof (EFI_DEVICE_PATH_PROTOCOL),
             0}
         }
-    } // DevicePath
+    }, // DevicePath
+
+    NULL // Shadow
 };
 
 HISI_SPI_FLASH_PROTOCOL* mFlash;
@@ -455,6 +459,85 @@ FvbReset(
   return EFI_SUCCESS;
 }
 
+/**
+ Reloads blocks of the DRAM shadow from the flash.
+
+ Used when the flash was changed without going through the shadow, or when
+ an operation failed and left the flash contents unknown. If the flash can
+ not be read back, the shadow is dropped and reads go to the flash again.
+
+ @param Instance             The flash instance.
+ @param Lba                  The first block of the region to reload.
+ @param Size                 Number of bytes to reload, a multiple of the block size.
+
+ **/
+STATIC
+VOID
+FlashShadowReload (
+    IN FLASH_INSTANCE*       Instance,
+    IN EFI_LBA               Lba,
+    IN UINTN                 Size
+)
+{
+    EFI_STATUS  Status;
+
+    if (Instance->Shadow == NULL)
+    {
+        return;
+    }
+
+    Status = FlashReadBlocks (Instance, Lba, Size, Instance->Shadow + Lba * Instance->Media.BlockSize);
+    if (EFI_ERROR (Status))
+    {
+        DEBUG ((EFI_D_ERROR, "[%a]:[%dL] Dropping the shadow. Status=%r\n", __FUNCTION__, __LINE__, Status));
+        if (!EfiAtRuntime ())
+        {
+            FreePool (Instance->Shadow);
+        }
+        Instance->Shadow = NULL;
+    }
+}
+
+/**
+ Sets up the DRAM shadow of the region.
+
+ From then on FvbRead is served from the shadow. FvbWrite and FvbEraseBlocks
+ still go to the flash before they return, and update the shadow after, so
+ the flash and its memory mapped window never lag behind. The shadow only
+ lets FvbWrite skip the bytes that would not change in the flash.
+
+ If the shadow can not be set up, the flash is used for reads too.
+
+ @param Instance             The flash instance.
+
+ **/
+STATIC
+VOID
+FlashShadowInitialize (
+    IN FLASH_INSTANCE* Instance
+)
+{
+    EFI_STATUS  Status;
+
+    Instance->Shadow = AllocateRuntimePool (Instance->Size);
+    if (Instance->Shadow == NULL)
+    {
+        DEBUG ((EFI_D_ERROR, "[%a]:[%dL] No shadow, reading from the flash.\n", __FUNCTION__, __LINE__));
+        return;
+    }
+
+    Status = FlashReadBlocks (Instance, 0, Instance->Size, Instance->Shadow);
+    if (EFI_ERROR (Status))
+    {
+        DEBUG ((EFI_D_ERROR, "[%a]:[%dL] No shadow, reading from the flash. Status=%r\n", __FUNCTION__, __LINE__, Status));
+        FreePool (Instance->Shadow);
+        Instance->Shadow = NULL;
+        return;
+    }
+
+    mFlashShadowInstance = Instance;
+}
+
 
 /**
  Reads the specified number of bytes into a buffer from the specified block.
@@ -547,6 +630,17 @@ FvbRead (
         return EFI_BAD_BUFFER_SIZE;
     }
 
+    if (Instance->Shadow != NULL)
+    {
+        if (Lba > Instance->Media.LastBlock)
+        {
+            return EFI_BAD_BUFFER_SIZE;
+        }
+
+        CopyMem (Buffer, Instance->Shadow + Lba * BlockSize + Offset, *NumBytes);
+        return EFI_SUCCESS;
+    }
+
     // Get the address to start reading from
     StartAddress = GET_BLOCK_ADDRESS (Instance->RegionBaseAddress,
                                       Lba,
@@ -635,6 +729,9 @@ FvbWrite (
     FLASH_INSTANCE*              Instance;
     UINTN                    BlockAddress;
     UINTN                    WriteAddress;
+    UINT8*                         Shadow;
+    UINTN                           First;
+    UINTN                            Last;
 
     Instance = INSTANCE_FROM_FVB_THIS(This);
     if (NULL == Instance)
@@ -683,16 +780,52 @@ FvbWrite (
         return EFI_BAD_BUFFER_SIZE;
     }
 
+    First = 0;
+    Last = *NumBytes;
+    Shadow = NULL;
+    if (Instance->Shadow != NULL)
+    {
+        if (Lba > Instance->Media.LastBlock)
+        {
+            return EFI_BAD_BUFFER_SIZE;
+        }
+
+        // A write can only clear bits in the flash, so the leading and
+        // trailing bytes that would keep their value need not be programmed
+        Shadow = Instance->Shadow + Lba * BlockSize + Offset;
+        while ((First < Last) && ((Shadow[First] & Buffer[First]) == Shadow[First]))
+        {
+            First++;
+        }
+        while ((Last > First) && ((Shadow[Last - 1] & Buffer[Last - 1]) == Shadow[Last - 1]))
+        {
+            Last--;
+        }
+        if (First == Last)
+        {
+            return EFI_SUCCESS;
+        }
+    }
+
     BlockAddress = GET_BLOCK_ADDRESS (Instance->RegionBaseAddress, Lba, BlockSize);
-    WriteAddress = BlockAddress - Instance->DeviceBaseAddress + Offset;
+    WriteAddress = BlockAddress - Instance->DeviceBaseAddress + Offset + First;
 
-    Status = mFlash->Write(mFlash, (UINT32)WriteAddress, (UINT8*)Buffer, *NumBytes);
+    Status = mFlash->Write(mFlash, (UINT32)WriteAddress, (UINT8*)Buffer + First, (UINT32)(Last - First));
     if (EFI_SUCCESS != Status)
     {
         DEBUG((EFI_D_ERROR, "%s - %d Status=%r\n", __FILE__, __LINE__, Status));
+        FlashShadowReload (Instance, Lba, BlockSize);
         return Status;
     }
 
+    if (Shadow != NULL)
+    {
+        for (; First < Last; First++)
+        {
+            Shadow[First] &= Buffer[First];
+        }
+    }
+
     return Status;
 
 }
@@ -828,11 +961,18 @@ FvbEraseBlocks (
             Status = FlashUnlockAndEraseSingleBlock (Instance, BlockAddress);
             if (EFI_ERROR(Status))
             {
+                FlashShadowReload (Instance, Instance->StartLba + StartingLba, Instance->Media.BlockSize);
                 VA_END (Args);
                 Status = EFI_DEVICE_ERROR;
                 goto EXIT;
             }
 
+            if (Instance->Shadow != NULL)
+            {
+                SetMem (Instance->Shadow + (Instance->StartLba + StartingLba) * Instance->Media.BlockSize,
+                        Instance->Media.BlockSize, 0xFF);
+            }
+
             // Move to the next Lba
             StartingLba++;
             NumOfLba--;
@@ -880,6 +1020,12 @@ FvbInitialize (
             return Status;
         }
     }
+
+    // The shadow has to be allocated at boot time
+    if (!EfiAtRuntime ())
+    {
+        FlashShadowInitialize (Instance);
+    }
     return Status;
 }
 
@@ -1095,6 +1241,10 @@ FlashWriteBlocks (
     WriteAddress = BlockAddress - Instance->DeviceBaseAddress;
 
     Status = mFlash->Write(mFlash, (UINT32)WriteAddress, (UINT8*)Buffer, BufferSizeInBytes);
+
+    // Pick up the result in the FVB shadow
+    FlashShadowReload (Instance, Lba, BufferSizeInBytes);
+
     if (EFI_SUCCESS != Status)
     {
         DEBUG((EFI_D_ERROR, "%s - %d Status=%r\n", __FILE__, __LINE__, Status));
@@ -1171,6 +1321,11 @@ FlashFvbVirtualNotifyEvent (
 {
   EfiConvertPointer (0x0, (VOID**)&mFlash);
   EfiConvertPointer (0x0, (VOID**)&mFlashNvStorageVariableBase);
+  if (mFlashShadowInstance != NULL)
+  {
+    EfiConvertPointer (0x0, (VOID**)&mFlashShadowInstance->Shadow);
+    EfiConvertPointer (0x0, (VOID**)&mFlashShadowInstance);
+  }
   return;
 }
 
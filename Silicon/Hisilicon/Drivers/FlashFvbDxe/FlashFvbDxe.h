@@ -93,6 +93,10 @@ struct _FLASH_INSTANCE
     EFI_FIRMWARE_VOLUME_BLOCK2_PROTOCOL FvbProtocol;
 
     FLASH_DEVICE_PATH                   DevicePath;
+
+    // DRAM copy of the region, kept in step with the flash.
+    // NULL when reads go to the flash.
+    UINT8*                              Shadow;
 };
 
 
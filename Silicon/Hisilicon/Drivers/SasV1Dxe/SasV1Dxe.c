@@ -191,6 +191,9 @@
 #define lower_32_bits(n) ((UINT32)(n))
 #define MAX_TARGET_ID 4
 
+// Completion reaper period for non-blocking requests, in 100ns units
+#define SAS_COMPLETION_POLL_PERIOD      10000
+
 // Generic HW DMA host memory structures
 struct hisi_sas_cmd_hdr {
     UINT32 dw0;
@@ -263,6 +266,12 @@ UINT32 status[260];
 
 struct hisi_sas_slot {
     BOOLEAN used;
+    BOOLEAN done;
+    BOOLEAN sense;
+    EFI_STATUS status;
+    EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET *packet;
+    EFI_EVENT event;
+    VOID *buffer_map;
 };
 
 struct hisi_hba {
@@ -275,6 +284,7 @@ struct hisi_hba {
     struct hisi_sas_itct         *itct;
     struct hisi_sas_breakpoint   *breakpoint;
     struct hisi_sas_slot         *slots;
+    UINT32 outstanding;
     UINT32 base;
     int queue;
     int port_id;
@@ -304,7 +314,9 @@ typedef struct {
 
 STATIC EFI_STATUS prepare_cmd (
   struct hisi_hba *hba,
-  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET    *Packet,
+  EFI_EVENT                                     Event,
+  UINT32                                        *slot_out
   )
 {
   struct hisi_sas_slot *slot;
@@ -315,15 +327,19 @@ STATIC EFI_STATUS prepare_cmd (
   EFI_SCSI_SENSE_DATA *SensePtr = Packet->SenseData;
   VOID   *Buffer = NULL;
   UINTN BufferSize = 0;
-  int queue = hba->queue;
+  int queue;
   UINT32 r, w = 0, slot_idx = 0;
   UINT32 base = hba->base;
-  UINT8 *p;
   EFI_PHYSICAL_ADDRESS  BufferAddress;
   EFI_STATUS            Status = EFI_SUCCESS;
   VOID                  *BufferMap = NULL;
   DMA_MAP_OPERATION DmaOperation = MapOperationBusMasterCommonBuffer;
+  EFI_TPL               OldTpl;
+
+  // Keep the completion reaper away while a slot is claimed and posted
+  OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
 
+  queue = hba->queue;
   while (1) {
     w = READ_REG32(base, DLVRY_Q_0_WR_PTR + (queue * 0x14));
     r = READ_REG32(base, DLVRY_Q_0_RD_PTR + (queue * 0x14));
@@ -333,6 +349,7 @@ STATIC EFI_STATUS prepare_cmd (
       queue = (queue + 1) % QUEUE_CNT;
       if (queue == hba->queue) {
         DEBUG ((EFI_D_ERROR, "could not find free slot\n"));
+        gBS->RestoreTPL (OldTpl);
         return EFI_NOT_READY;
       }
       continue;
@@ -350,9 +367,6 @@ STATIC EFI_STATUS prepare_cmd (
   if (SensePtr)
     ZeroMem (SensePtr, sizeof (EFI_SCSI_SENSE_DATA));
 
-  slot->used = TRUE;
-  hba->queue = (queue + 1) % QUEUE_CNT;
-
   // Only consider ssp
   hdr->dw0 = (1 << CMD_HDR_RESP_REPORT_OFF) |
        (0x2 << CMD_HDR_TLR_CTRL_OFF) |
@@ -394,6 +408,7 @@ STATIC EFI_STATUS prepare_cmd (
 
     Status = DmaMap (DmaOperation, Buffer, &BufferSize, &BufferAddress, &BufferMap);
     if (EFI_ERROR (Status)) {
+      gBS->RestoreTPL (OldTpl);
       return Status;
     }
     remain = len = BufferSize;
@@ -416,58 +431,153 @@ STATIC EFI_STATUS prepare_cmd (
     hdr->sg_len = i << CMD_HDR_DATA_SGL_LEN_OFF;
   }
 
+  slot->used = TRUE;
+  slot->done = FALSE;
+  slot->status = EFI_SUCCESS;
+  slot->packet = Packet;
+  slot->event = Event;
+  slot->buffer_map = BufferMap;
+  if (Event != NULL) {
+    hba->outstanding++;
+  }
+  hba->queue = (queue + 1) % QUEUE_CNT;
+
   // Ensure descriptor effective before start dma
   MemoryFence();
 
   // Start dma
   WRITE_REG32(base, DLVRY_Q_0_WR_PTR + queue * 0x14, ++w % QUEUE_SLOTS);
 
-  // Wait for dma complete
-  while (slot->used) {
-    if (READ_REG32(base, OQ_INT_SRC) & BIT(queue)) {
-      struct hisi_sas_complete_hdr *complete_hdr;
-      UINT32 data, rd;
-      rd = READ_REG32(base, COMPL_Q_0_RD_PTR + (0x14 * queue));
+  gBS->RestoreTPL (OldTpl);
 
-      complete_hdr = &hba->complete_hdr[queue][rd];
-      data = complete_hdr->data;
-
-      // Check whether dma transfer error
-      if ((data & CMPLT_HDR_ERR_RCRD_XFRD_MSK) &&
-        !(data & CMPLT_HDR_RSPNS_XFRD_MSK)) {
-        DEBUG ((EFI_D_VERBOSE, "sas retry data=0x%x\n", data));
-        DEBUG ((EFI_D_VERBOSE, "sts[0]=0x%x\n", sts->status[0]));
-        DEBUG ((EFI_D_VERBOSE, "sts[1]=0x%x\n", sts->status[1]));
-        DEBUG ((EFI_D_VERBOSE, "sts[2]=0x%x\n", sts->status[2]));
-        Status = EFI_NOT_READY;
-        // wait 1 second and retry, some disk need long time to be ready
-        // and ScsiDisk treat retry over 3 times as error
-        MicroSecondDelay(1000000);
-      }
-       // Update read point
-       WRITE_REG32(base, COMPL_Q_0_RD_PTR + (0x14 * queue), w);
-       // Clear int
-       WRITE_REG32(base, OQ_INT_SRC, BIT(queue));
-       slot->used = FALSE;
-       break;
-    }
-    // Wait for status change in polling
-    NanoSecondDelay (100);
+  *slot_out = slot_idx;
+  return EFI_SUCCESS;
+}
+
+//
+// Finish the command in slot_idx from its completion header. Non-blocking
+// requests are released and signalled here, blocking ones are left for
+// the waiter in SasV1ExtScsiPassThruFunction to collect.
+//
+STATIC VOID complete_slot (
+  struct hisi_hba *hba,
+  UINT32 slot_idx,
+  UINT32 data
+  )
+{
+  struct hisi_sas_slot *slot;
+  struct hisi_sas_sts *sts;
+  EFI_EXT_SCSI_PASS_THRU_SCSI_REQUEST_PACKET *Packet;
+  EFI_SCSI_SENSE_DATA *SensePtr;
+  EFI_EVENT Event;
+  UINT8 *p;
+
+  if (slot_idx >= SLOT_ENTRIES) {
+    DEBUG ((EFI_D_ERROR, "sas: bad completion iptt=%d\n", slot_idx));
+    return;
+  }
+
+  slot = &hba->slots[slot_idx];
+  if (!slot->used || slot->done) {
+    DEBUG ((EFI_D_ERROR, "sas: stray completion iptt=%d\n", slot_idx));
+    return;
+  }
+
+  Packet = slot->packet;
+  SensePtr = Packet->SenseData;
+  sts = &hba->status_buf[slot_idx / QUEUE_SLOTS][slot_idx % QUEUE_SLOTS];
+
+  Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_OK;
+  Packet->TargetStatus = EFI_EXT_SCSI_STATUS_TARGET_GOOD;
+  slot->status = EFI_SUCCESS;
+
+  // Check whether dma transfer error
+  if ((data & CMPLT_HDR_ERR_RCRD_XFRD_MSK) &&
+    !(data & CMPLT_HDR_RSPNS_XFRD_MSK)) {
+    DEBUG ((EFI_D_VERBOSE, "sas retry data=0x%x\n", data));
+    DEBUG ((EFI_D_VERBOSE, "sts[0]=0x%x\n", sts->status[0]));
+    DEBUG ((EFI_D_VERBOSE, "sts[1]=0x%x\n", sts->status[1]));
+    DEBUG ((EFI_D_VERBOSE, "sts[2]=0x%x\n", sts->status[2]));
+    slot->status = EFI_NOT_READY;
+    // Non-blocking requests have no return status, report a command
+    // timeout so that the caller retries the request
+    Packet->HostAdapterStatus = EFI_EXT_SCSI_STATUS_HOST_ADAPTER_TIMEOUT_COMMAND;
   }
 
-  if (BufferMap)
-       DmaUnmap (BufferMap);
+  if (slot->buffer_map)
+    DmaUnmap (slot->buffer_map);
 
   p = (UINT8 *)&sts->status[0];
-  if (p[SENSE_DATA_PRES]) {
+  slot->sense = p[SENSE_DATA_PRES] ? TRUE : FALSE;
+  if (slot->sense && SensePtr != NULL) {
     // Disk not ready normal return for ScsiDiskTestUnitReady do next try
     SensePtr->Sense_Key = EFI_SCSI_SK_NOT_READY;
     SensePtr->Addnl_Sense_Code = EFI_SCSI_ASC_NOT_READY;
     SensePtr->Addnl_Sense_Code_Qualifier = EFI_SCSI_ASCQ_IN_PROGRESS;
-    // wait 1 second for disk spin up, refer drivers/scsi/sd.c
-    MicroSecondDelay(1000000);
   }
-  return Status;
+
+  if (slot->event == NULL) {
+    slot->done = TRUE;
+    return;
+  }
+
+  Event = slot->event;
+  slot->used = FALSE;
+  hba->outstanding--;
+  gBS->SignalEvent (Event);
+}
+
+//
+// Drain the completion queues of every delivery queue that has signalled.
+// Must be called at TPL_NOTIFY.
+//
+STATIC VOID reap_completions (
+  struct hisi_hba *hba
+  )
+{
+  struct hisi_sas_complete_hdr *complete_hdr;
+  UINT32 base = hba->base;
+  UINT32 irq, rd, wr;
+  int queue;
+
+  irq = READ_REG32(base, OQ_INT_SRC);
+  if (irq == 0)
+    return;
+
+  for (queue = 0; queue < QUEUE_CNT; queue++) {
+    if (!(irq & BIT(queue)))
+      continue;
+
+    // Clear int before sampling the write pointer so no entry is missed
+    WRITE_REG32(base, OQ_INT_SRC, BIT(queue));
+
+    rd = READ_REG32(base, COMPL_Q_0_RD_PTR + (0x14 * queue));
+    wr = READ_REG32(base, COMPL_Q_0_WR_PTR + (0x14 * queue));
+    while (rd != wr) {
+      complete_hdr = &hba->complete_hdr[queue][rd];
+      complete_slot (hba,
+        (complete_hdr->data & CMPLT_HDR_IPTT_MSK) >> CMPLT_HDR_IPTT_OFF,
+        complete_hdr->data);
+      rd = (rd + 1) % QUEUE_SLOTS;
+    }
+    // Update read point
+    WRITE_REG32(base, COMPL_Q_0_RD_PTR + (0x14 * queue), rd);
+  }
+}
+
+STATIC
+VOID
+EFIAPI
+SasV1CompletionTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  struct hisi_hba *hba = Context;
+
+  if (hba->outstanding != 0) {
+    reap_completions (hba);
+  }
 }
 
 STATIC VOID hisi_sas_v1_init(struct hisi_hba *hba, PLATFORM_SAS_PROTOCOL *plat)
@@ -677,8 +787,42 @@ SasV1ExtScsiPassThruFunction (
 {
   SAS_V1_INFO *SasV1Info = SAS_FROM_PASS_THRU(This);
   struct hisi_hba *hba = SasV1Info->hba;
+  struct hisi_sas_slot *slot;
+  UINT32 slot_idx;
+  EFI_STATUS Status;
+  EFI_TPL OldTpl;
+
+  Status = prepare_cmd(hba, Packet, Event, &slot_idx);
+  if (EFI_ERROR (Status) || Event != NULL) {
+    // Non-blocking requests complete from SasV1CompletionTimer
+    return Status;
+  }
+
+  // Wait for dma complete
+  slot = &hba->slots[slot_idx];
+  while (1) {
+    OldTpl = gBS->RaiseTPL (TPL_NOTIFY);
+    reap_completions (hba);
+    gBS->RestoreTPL (OldTpl);
+    if (slot->done)
+      break;
+
+    // Wait for status change in polling
+    NanoSecondDelay (100);
+  }
 
-  return prepare_cmd(hba, Packet);
+  Status = slot->status;
+  slot->used = FALSE;
+
+  if (Status == EFI_NOT_READY) {
+    // wait 1 second and retry, some disk need long time to be ready
+    // and ScsiDisk treat retry over 3 times as error
+    MicroSecondDelay(1000000);
+  } else if (slot->sense) {
+    // wait 1 second for disk spin up, refer drivers/scsi/sd.c
+    MicroSecondDelay(1000000);
+  }
+  return Status;
 }
 
 STATIC
@@ -922,7 +1066,9 @@ SasDriverBindingStart (
 
   CopyMem (&SasV1Info->ExtScsiPassThru, &SasV1ExtScsiPassThruProtocolTemplate, sizeof (EFI_EXT_SCSI_PASS_THRU_PROTOCOL));
   SasV1Info->ExtScsiPassThruMode.AdapterId = 2;
-  SasV1Info->ExtScsiPassThruMode.Attributes = EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_PHYSICAL | EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_LOGICAL;
+  SasV1Info->ExtScsiPassThruMode.Attributes = EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_PHYSICAL |
+                                              EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_LOGICAL |
+                                              EFI_EXT_SCSI_PASS_THRU_ATTRIBUTES_NONBLOCKIO;
   SasV1Info->ExtScsiPassThruMode.IoAlign  = 64; //cache line align
   SasV1Info->ExtScsiPassThru.Mode = &SasV1Info->ExtScsiPassThruMode;
 
@@ -939,6 +1085,18 @@ SasDriverBindingStart (
                            sizeof (*DevicePath) - sizeof (DevicePath->End));
   SetDevicePathEndNode (&DevicePath->End);
 
+  // Reap completions of non-blocking requests in the background
+  Status = gBS->CreateEvent (
+                  EVT_TIMER | EVT_NOTIFY_SIGNAL,
+                  TPL_NOTIFY,
+                  SasV1CompletionTimer,
+                  hba,
+                  &SasV1Info->TimerEvent
+                  );
+  ASSERT_EFI_ERROR (Status);
+  Status = gBS->SetTimer (SasV1Info->TimerEvent, TimerPeriodic, SAS_COMPLETION_POLL_PERIOD);
+  ASSERT_EFI_ERROR (Status);
+
   Status = gBS->InstallMultipleProtocolInterfaces (
                 &Controller,
                 &gEfiDevicePathProtocolGuid, DevicePath,
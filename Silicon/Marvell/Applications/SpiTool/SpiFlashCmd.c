@@ -414,7 +414,7 @@ EFI_STATUS              Status;
   switch (Flag) {
   case READ:
   case READ_FILE:
-    Status = SpiFlashProtocol->Read (mSlave, Offset, ByteCount, Buffer);
+    Status = SpiFlashProtocol->ReadBulk (mSlave, Offset, ByteCount, Buffer);
     break;
   case ERASE:
     Status = SpiFlashProtocol->Erase (mSlave, Offset, ByteCount);
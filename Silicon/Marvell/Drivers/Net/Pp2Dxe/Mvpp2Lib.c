@@ -2698,12 +2698,26 @@ Mvpp2ClsOversizeRxqSet (
   IN PP2DXE_PORT *Port
   )
 {
+  UINT32 Val;
+  INT32 Rxq;
+
+  Rxq = Port->FirstRxq;
 
   Mvpp2Write (
           Port->Priv,
           MVPP2_CLS_OVERSIZE_RXQ_LOW_REG(Port->Id),
-          Port->FirstRxq & MVPP2_CLS_OVERSIZE_RXQ_LOW_MASK
+          Rxq & MVPP2_CLS_OVERSIZE_RXQ_LOW_MASK
         );
+
+  Mvpp2Write (
+          Port->Priv,
+          MVPP2_CLS_SWFWD_P2HQ_REG(Port->Id),
+          Rxq >> MVPP2_CLS_OVERSIZE_RXQ_LOW_BITS
+        );
+
+  Val = Mvpp2Read (Port->Priv, MVPP2_CLS_SWFWD_PCTRL_REG);
+  Val |= MVPP2_CLS_SWFWD_PCTRL_MASK (Port->Id);
+  Mvpp2Write (Port->Priv, MVPP2_CLS_SWFWD_PCTRL_REG, Val);
 }
 
 /* BM helper routines */
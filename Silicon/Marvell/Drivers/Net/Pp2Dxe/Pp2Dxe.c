@@ -170,6 +170,37 @@ QueueRemove (
   return Buffer;
 }
 
+/*
+ * Hand frames already sent by HW over to the completion queue, oldest
+ * first. Reading the TXQ sent counter clears it, so frames which do not
+ * fit into a full completion queue are kept in TxDoneCount until the
+ * next call.
+ */
+STATIC
+VOID
+Pp2DxeTxReap (
+  IN PP2DXE_CONTEXT *Pp2Context
+  )
+{
+  PP2DXE_PORT *Port = &Pp2Context->Port;
+  VOID *Buffer;
+
+  Pp2Context->TxDoneCount += Mvpp2TxqSentDescProc (Port, &Port->Txqs[0]);
+  ASSERT (Pp2Context->TxDoneCount <= Pp2Context->TxInFlightCount);
+
+  while (Pp2Context->TxDoneCount > 0) {
+    Buffer = Pp2Context->TxInFlightQueue[Pp2Context->TxInFlightHead];
+    if (EFI_ERROR (QueueInsert (Pp2Context, Buffer))) {
+      break;
+    }
+
+    Pp2Context->TxInFlightQueue[Pp2Context->TxInFlightHead] = NULL;
+    Pp2Context->TxInFlightHead = (Pp2Context->TxInFlightHead + 1) % Port->TxRingSize;
+    Pp2Context->TxInFlightCount--;
+    Pp2Context->TxDoneCount--;
+  }
+}
+
 STATIC
 EFI_STATUS
 Pp2DxeBmPoolInit (
@@ -418,7 +449,7 @@ Pp2DxeLatePortInitialize (
   MVPP2_SHARED *Mvpp2Shared = Pp2Context->Port.Priv;
   INTN Queue;
 
-  Port->TxRingSize = MVPP2_MAX_TXD;
+  Port->TxRingSize = MVPP2_TXD_NUM;
   Port->RxRingSize = MVPP2_MAX_RXD;
 
   Mvpp2EgressDisable(Port);
@@ -431,6 +462,12 @@ Pp2DxeLatePortInitialize (
     return EFI_OUT_OF_RESOURCES;
   }
 
+  Pp2Context->TxInFlightQueue = AllocateZeroPool (sizeof(VOID *) * Port->TxRingSize);
+  if (Pp2Context->TxInFlightQueue == NULL) {
+    DEBUG((DEBUG_ERROR, "Failed to allocate Tx in-flight queue\n"));
+    return EFI_OUT_OF_RESOURCES;
+  }
+
   /* Use preallocated area */
   Port->Txqs[0].Descs = Mvpp2Shared->BufferLocation.TxDescs[Port->Id];
 
@@ -448,11 +485,11 @@ Pp2DxeLatePortInitialize (
     return EFI_OUT_OF_RESOURCES;
   }
 
-  Port->Rxqs[0].Descs = Mvpp2Shared->BufferLocation.RxDescs[Port->Id];
-
-  for (Queue = 0; Queue < TxqNumber; Queue++) {
+  for (Queue = 0; Queue < RxqNumber; Queue++) {
     MVPP2_RX_QUEUE *Rxq = &Port->Rxqs[Queue];
 
+    /* Use preallocated area */
+    Rxq->Descs = Mvpp2Shared->BufferLocation.RxDescs[Port->Id] + Queue * MVPP2_MAX_RXD;
     Rxq->Id = Queue + Port->FirstRxq;
     Rxq->Size = Port->RxRingSize;
   }
@@ -472,6 +509,7 @@ Pp2DxeLateInitialize (
 {
   PP2DXE_PORT *Port = &Pp2Context->Port;
   EFI_STATUS Status;
+  INTN Queue;
 
   if (!Pp2Context->LateInitialized) {
     /* Full init on first call */
@@ -481,9 +519,11 @@ Pp2DxeLateInitialize (
       return Status;
     }
 
-    /* Attach pool to Rxq */
-    Mvpp2RxqLongPoolSet(Port, 0, Port->Id);
-    Mvpp2RxqShortPoolSet(Port, 0, Port->Id);
+    /* Attach pool to Rxqs */
+    for (Queue = 0; Queue < RxqNumber; Queue++) {
+      Mvpp2RxqLongPoolSet(Port, Queue, Port->Id);
+      Mvpp2RxqShortPoolSet(Port, Queue, Port->Id);
+    }
 
     /*
      * Mark this port being fully initialized,
@@ -623,6 +663,68 @@ Pp2SnpStart (
   ReturnUnlock (SavedTpl, EFI_SUCCESS);
 }
 
+/* Pass buffer of a received packet back to BM */
+STATIC
+VOID
+Pp2DxeRxBufferPut (
+  IN PP2DXE_CONTEXT *Pp2Context,
+  IN PP2DXE_RX_PACKET *Packet
+  )
+{
+  INTN PoolId;
+
+  PoolId = (Packet->Status & MVPP2_RXD_BM_POOL_ID_MASK) >> MVPP2_RXD_BM_POOL_ID_OFFS;
+  Mvpp2BmPoolPut(Pp2Context->Port.Priv, PoolId, Packet->PhysAddr, Packet->VirtAddr);
+}
+
+/*
+ * Return buffers of an already consumed batch to the BM pool. This is done
+ * for the whole batch at once, after all its packets were copied out, and
+ * for a partially consumed batch on Shutdown and ExitBootServices.
+ * Buffers lent out with the Rx loan protocol are returned on release.
+ */
+STATIC
+VOID
+Pp2DxeRxRefill (
+  IN PP2DXE_CONTEXT *Pp2Context
+  )
+{
+  PP2DXE_RX_PACKET *Packet;
+  UINTN Index;
+
+  for (Index = 0; Index < Pp2Context->RxStageCount; Index++) {
+    Packet = &Pp2Context->RxStage[Index];
+    if (!Packet->Loaned) {
+      Pp2DxeRxBufferPut (Pp2Context, Packet);
+    }
+  }
+
+  Pp2Context->RxStageHead = 0;
+  Pp2Context->RxStageCount = 0;
+}
+
+/*
+ * Take back the buffers of all frames still on loan, so that a consumer which
+ * goes away without releasing them does not shrink the BM pool for good.
+ */
+STATIC
+VOID
+Pp2DxeRxLoansReclaim (
+  IN PP2DXE_CONTEXT *Pp2Context
+  )
+{
+  UINTN Index;
+
+  for (Index = 0; Index < MVPP2_RX_LOANS_MAX; Index++) {
+    if (Pp2Context->RxLoans[Index].PhysAddr != 0) {
+      Pp2DxeRxBufferPut (Pp2Context, &Pp2Context->RxLoans[Index]);
+      ZeroMem (&Pp2Context->RxLoans[Index], sizeof (PP2DXE_RX_PACKET));
+    }
+  }
+
+  Pp2Context->RxLoanCount = 0;
+}
+
 EFI_STATUS
 EFIAPI
 Pp2SnpStop (
@@ -645,6 +747,10 @@ Pp2SnpStop (
     }
   }
 
+  /* Stop is also accepted without a prior Shutdown */
+  Pp2DxeRxRefill (Pp2Context);
+  Pp2DxeRxLoansReclaim (Pp2Context);
+
   This->Mode->State = EfiSimpleNetworkStopped;
   ReturnUnlock (SavedTpl, EFI_SUCCESS);
 }
@@ -668,17 +774,6 @@ Pp2DxeHalt (
 {
   PP2DXE_CONTEXT *Pp2Context = Context;
   PP2DXE_PORT *Port = &Pp2Context->Port;
-  MVPP2_SHARED *Mvpp2Shared = Pp2Context->Port.Priv;
-  STATIC BOOLEAN CommonPartHalted = FALSE;
-  INTN Index;
-
-  if (!CommonPartHalted) {
-    for (Index = 0; Index < MVPP2_MAX_PORT; Index++) {
-      Mvpp2BmStop(Mvpp2Shared, Index);
-    }
-
-    CommonPartHalted = TRUE;
-  }
 
   Mvpp2TxqDrainSet(Port, 0, TRUE);
   Mvpp2IngressDisable(Port);
@@ -686,6 +781,30 @@ Pp2DxeHalt (
 
   MvGop110PortEventsMask(Port);
   MvGop110PortDisable(Port);
+
+  /* Give staged and lent buffers back, Pp2DxeBmHalt stops the pools afterwards */
+  Pp2DxeRxRefill (Pp2Context);
+  Pp2DxeRxLoansReclaim (Pp2Context);
+}
+
+/*
+ * Stop the BM pools of a controller at ExitBootServices. The event runs at
+ * TPL_CALLBACK, so after Pp2DxeHalt (TPL_NOTIFY) of every port.
+ */
+STATIC
+VOID
+EFIAPI
+Pp2DxeBmHalt (
+  IN EFI_EVENT Event,
+  IN VOID *Context
+  )
+{
+  MVPP2_SHARED *Mvpp2Shared = Context;
+  INTN Index;
+
+  for (Index = 0; Index < MVPP2_MAX_PORT; Index++) {
+    Mvpp2BmStop(Mvpp2Shared, Index);
+  }
 }
 
 EFI_STATUS
@@ -712,6 +831,10 @@ Pp2SnpShutdown (
     }
   }
 
+  /* Buffers of a partially consumed batch and frames on loan go back to BM */
+  Pp2DxeRxRefill (Pp2Context);
+  Pp2DxeRxLoansReclaim (Pp2Context);
+
   ReturnUnlock (SavedTpl, EFI_SUCCESS);
 }
 
@@ -860,6 +983,11 @@ Pp2SnpGetStatus (
   }
   Snp->Mode->MediaPresent = LinkUp;
 
+  /* Collect frames sent since the last call */
+  if (Pp2Context->LateInitialized) {
+    Pp2DxeTxReap (Pp2Context);
+  }
+
   if (TxBuf != NULL) {
     *TxBuf = QueueRemove (Pp2Context);
   }
@@ -884,9 +1012,6 @@ Pp2SnpTransmit (
   MVPP2_SHARED *Mvpp2Shared = Pp2Context->Port.Priv;
   MVPP2_TX_QUEUE *AggrTxq = Mvpp2Shared->AggrTxqs;
   MVPP2_TX_DESC *TxDesc;
-  EFI_STATUS Status;
-  INTN PollingCount;
-  INTN TxSent;
   UINT8 *DataPtr = Buffer;
   UINT16 EtherType;
   UINT32 State = This->Mode->State;
@@ -926,6 +1051,23 @@ Pp2SnpTransmit (
 
   EtherType = HTONS (*EtherTypePtr);
 
+  /* Make room in the in-flight ring, if the caller did not reap yet */
+  if (Pp2Context->TxInFlightCount == Port->TxRingSize) {
+    Pp2DxeTxReap (Pp2Context);
+    if (Pp2Context->TxInFlightCount == Port->TxRingSize) {
+      ReturnUnlock (SavedTpl, EFI_NOT_READY);
+    }
+  }
+
+  /*
+   * The aggregated TXQ is shared by all ports of the controller, so the
+   * per port limit above does not keep it from lapping descriptors the HW
+   * has not moved to the physical TXQ yet.
+   */
+  if (Mvpp2AggrDescNumCheck (Mvpp2Shared, AggrTxq, 1, 0) != 0) {
+    ReturnUnlock (SavedTpl, EFI_NOT_READY);
+  }
+
   /* Fetch next descriptor */
   TxDesc = Mvpp2TxqNextDescGet(AggrTxq);
 
@@ -955,41 +1097,63 @@ Pp2SnpTransmit (
 
   InvalidateDataCacheRange (DataPtr, BufferSize);
 
-  /* Issue send */
-  Mvpp2AggrTxqPendDescAdd(Port, 1);
-
   /*
-   * Egress processing:
-   * Wait until packet is passed from per-cpu aggregated queue
-   * to physical per-port TXQ.
+   * Issue send and return without waiting for the HW. The buffer is kept
+   * in the in-flight ring and moved to the completion queue by GetStatus,
+   * once the TXQ sent counter reports it.
    */
-  PollingCount = 0;
-  TxSent = Mvpp2AggrTxqPendDescNumGet(Mvpp2Shared, 0);
-  do {
-    if (PollingCount++ > MVPP2_TX_SEND_MAX_POLLING_COUNT) {
-      DEBUG((DEBUG_ERROR, "Pp2Dxe: transmit polling failed\n"));
-      ReturnUnlock(SavedTpl, EFI_TIMEOUT);
-    }
-    TxSent = Mvpp2AggrTxqPendDescNumGet(Mvpp2Shared, 0);
-  } while (TxSent);
-
-  /* Wait for packet to be transmitted by hardware. */
-  PollingCount = 0;
-  TxSent = Mvpp2TxqSentDescProc(Port, &Port->Txqs[0]);
-  while (!TxSent) {
-    if (PollingCount++ > MVPP2_TX_SEND_MAX_POLLING_COUNT) {
-      DEBUG((DEBUG_ERROR, "Pp2Dxe: transmit polling failed\n"));
-      ReturnUnlock(SavedTpl, EFI_TIMEOUT);
-    }
-    TxSent = Mvpp2TxqSentDescProc(Port, &Port->Txqs[0]);
+  Pp2Context->TxInFlightQueue[(Pp2Context->TxInFlightHead + Pp2Context->TxInFlightCount) %
+                              Port->TxRingSize] = Buffer;
+  Pp2Context->TxInFlightCount++;
+
+  Mvpp2AggrTxqPendDescAdd(Port, 1);
+  AggrTxq->count++;
+
+  ReturnUnlock (SavedTpl, EFI_SUCCESS);
+}
+
+/*
+ * Move a batch of received descriptors from the RXQ to the staging ring.
+ * The descriptors are handed back to HW at once, with a single status update.
+ */
+STATIC
+VOID
+Pp2DxeRxFill (
+  IN PP2DXE_CONTEXT *Pp2Context
+  )
+{
+  PP2DXE_PORT *Port = &Pp2Context->Port;
+  MVPP2_RX_QUEUE *Rxq = &Port->Rxqs[0];
+  PP2DXE_RX_PACKET *Packet;
+  MVPP2_RX_DESC *RxDesc;
+  INTN ReceivedPackets;
+  INTN Index;
+
+  ReceivedPackets = Mvpp2RxqReceived(Port, Rxq->Id);
+  if (ReceivedPackets == 0) {
+    return;
   }
 
-  /*
-   * At this point TxSent has increased - HW sent the packet
-   * Add buffer to completion queue and return.
-   */
-  Status = QueueInsert (Pp2Context, Buffer);
-  ReturnUnlock (SavedTpl, Status);
+  ReceivedPackets = MIN (ReceivedPackets, MVPP2_RX_BATCH_SIZE);
+
+  for (Index = 0; Index < ReceivedPackets; Index++) {
+    RxDesc = Mvpp2RxqNextDescGet(Rxq);
+    Packet = &Pp2Context->RxStage[Index];
+
+    Packet->Status = RxDesc->status;
+    Packet->DataSize = RxDesc->DataSize;
+    Packet->Loaned = FALSE;
+
+    /* extract addresses from descriptor */
+    Packet->PhysAddr = RxDesc->BufPhysAddrKeyHash & MVPP22_ADDR_MASK;
+    Packet->VirtAddr = RxDesc->BufCookieBmQsetClsInfo & MVPP22_ADDR_MASK;
+  }
+
+  /* Update counters with the whole batch received and its descriptors freed */
+  Mvpp2RxqStatusUpdate(Port, Rxq->Id, ReceivedPackets, ReceivedPackets);
+
+  Pp2Context->RxStageHead = 0;
+  Pp2Context->RxStageCount = ReceivedPackets;
 }
 
 EFI_STATUS
@@ -1004,54 +1168,49 @@ Pp2SnpReceive (
   OUT UINT16                     *EtherType OPTIONAL
   )
 {
-  INTN ReceivedPackets;
   PP2DXE_CONTEXT *Pp2Context = INSTANCE_FROM_SNP(This);
   PP2DXE_PORT *Port = &Pp2Context->Port;
-  MVPP2_SHARED *Mvpp2Shared = Pp2Context->Port.Priv;
-  UINTN PhysAddr, VirtAddr;
-  EFI_STATUS Status = EFI_SUCCESS;
+  PP2DXE_RX_PACKET *Packet;
   EFI_TPL SavedTpl;
-  UINT32 StatusReg;
-  INTN PoolId;
   UINTN PktLength;
   UINT8 *DataPtr;
-  MVPP2_RX_DESC *RxDesc;
-  MVPP2_RX_QUEUE *Rxq = &Port->Rxqs[0];
 
   ASSERT (Port != NULL);
-  ASSERT (Rxq != NULL);
+  ASSERT (Port->Rxqs != NULL);
 
   SavedTpl = gBS->RaiseTPL (TPL_CALLBACK);
-  ReceivedPackets = Mvpp2RxqReceived(Port, Rxq->Id);
 
-  if (ReceivedPackets == 0) {
-    ReturnUnlock(SavedTpl, EFI_NOT_READY);
+  /* Fetch next batch, once all packets of the previous one are consumed */
+  if (Pp2Context->RxStageHead == Pp2Context->RxStageCount) {
+    Pp2DxeRxRefill (Pp2Context);
+    Pp2DxeRxFill (Pp2Context);
+
+    if (Pp2Context->RxStageCount == 0) {
+      ReturnUnlock(SavedTpl, EFI_NOT_READY);
+    }
   }
 
   /* Process one packet per call */
-  RxDesc = Mvpp2RxqNextDescGet(Rxq);
-  StatusReg = RxDesc->status;
-
-  /* extract addresses from descriptor */
-  PhysAddr = RxDesc->BufPhysAddrKeyHash & MVPP22_ADDR_MASK;
-  VirtAddr = RxDesc->BufCookieBmQsetClsInfo & MVPP22_ADDR_MASK;
+  Packet = &Pp2Context->RxStage[Pp2Context->RxStageHead];
 
   /* Drop packets with error or with buffer header (MC, SG) */
-  if ((StatusReg & MVPP2_RXD_BUF_HDR) || (StatusReg & MVPP2_RXD_ERR_SUMMARY)) {
+  if ((Packet->Status & MVPP2_RXD_BUF_HDR) || (Packet->Status & MVPP2_RXD_ERR_SUMMARY)) {
     DEBUG((DEBUG_WARN, "Pp2Dxe: dropping packet\n"));
-    Status = EFI_DEVICE_ERROR;
-    goto drop;
+    Pp2Context->RxStageHead++;
+    ReturnUnlock(SavedTpl, EFI_DEVICE_ERROR);
   }
 
-  PktLength = (UINTN) RxDesc->DataSize - 2;
+  /* Keep the packet staged, so that it can be fetched with bigger buffer */
+  PktLength = (UINTN) Packet->DataSize - 2;
   if (PktLength > *BufferSize) {
     *BufferSize = PktLength;
     DEBUG((DEBUG_ERROR, "Pp2Dxe: buffer too small\n"));
     ReturnUnlock(SavedTpl, EFI_BUFFER_TOO_SMALL);
   }
 
-  CopyMem (Buffer, (VOID*) (PhysAddr + 2), PktLength);
+  CopyMem (Buffer, (VOID*) (Packet->PhysAddr + 2), PktLength);
   *BufferSize = PktLength;
+  Pp2Context->RxStageHead++;
 
   if (HeaderSize != NULL) {
     *HeaderSize = Pp2Context->Snp.Mode->MediaHeaderSize;
@@ -1076,15 +1235,101 @@ Pp2SnpReceive (
     *EtherType = NTOHS (*(UINT16 *)(&DataPtr[12]));
   }
 
-drop:
-  /* Refill: pass packet back to BM */
-  PoolId = (StatusReg & MVPP2_RXD_BM_POOL_ID_MASK) >> MVPP2_RXD_BM_POOL_ID_OFFS;
-  Mvpp2BmPoolPut(Mvpp2Shared, PoolId, PhysAddr, VirtAddr);
+  ReturnUnlock(SavedTpl, EFI_SUCCESS);
+}
 
-  /* Update counters with 1 packet received and 1 packet refilled */
-  Mvpp2RxqStatusUpdate(Port, Rxq->Id, 1, 1);
+EFI_STATUS
+EFIAPI
+Pp2RxLoanReceive (
+  IN MARVELL_PP2_RX_LOAN_PROTOCOL *This,
+  OUT VOID                        **Frame,
+  OUT UINTN                       *FrameSize,
+  OUT UINT64                      *LoanId
+  )
+{
+  PP2DXE_CONTEXT *Pp2Context = INSTANCE_FROM_RX_LOAN(This);
+  PP2DXE_RX_PACKET *Packet;
+  EFI_TPL SavedTpl;
+  UINTN Index;
+
+  if (Frame == NULL || FrameSize == NULL || LoanId == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  SavedTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
-  ReturnUnlock(SavedTpl, Status);
+  if (Pp2Context->Snp.Mode->State != EfiSimpleNetworkInitialized) {
+    ReturnUnlock (SavedTpl, EFI_NOT_STARTED);
+  }
+
+  if (Pp2Context->RxLoanCount == MVPP2_RX_LOANS_MAX) {
+    ReturnUnlock (SavedTpl, EFI_OUT_OF_RESOURCES);
+  }
+
+  /* Take next good packet from the staging ring */
+  for (;;) {
+    if (Pp2Context->RxStageHead == Pp2Context->RxStageCount) {
+      Pp2DxeRxRefill (Pp2Context);
+      Pp2DxeRxFill (Pp2Context);
+
+      if (Pp2Context->RxStageCount == 0) {
+        ReturnUnlock (SavedTpl, EFI_NOT_READY);
+      }
+    }
+
+    Packet = &Pp2Context->RxStage[Pp2Context->RxStageHead++];
+    if (!(Packet->Status & MVPP2_RXD_BUF_HDR) && !(Packet->Status & MVPP2_RXD_ERR_SUMMARY)) {
+      break;
+    }
+
+    DEBUG((DEBUG_WARN, "Pp2Dxe: dropping packet\n"));
+  }
+
+  for (Index = 0; Index < MVPP2_RX_LOANS_MAX; Index++) {
+    if (Pp2Context->RxLoans[Index].PhysAddr == 0) {
+      break;
+    }
+  }
+  ASSERT (Index < MVPP2_RX_LOANS_MAX);
+
+  /* The buffer is kept out of BM until the loan is released */
+  CopyMem (&Pp2Context->RxLoans[Index], Packet, sizeof (PP2DXE_RX_PACKET));
+  Packet->Loaned = TRUE;
+  Pp2Context->RxLoanCount++;
+
+  /* Skip 2 bytes of Marvell header */
+  *Frame = (VOID *) (Packet->PhysAddr + 2);
+  *FrameSize = (UINTN) Packet->DataSize - 2;
+  *LoanId = Index;
+
+  ReturnUnlock (SavedTpl, EFI_SUCCESS);
+}
+
+EFI_STATUS
+EFIAPI
+Pp2RxLoanRelease (
+  IN MARVELL_PP2_RX_LOAN_PROTOCOL *This,
+  IN UINT64                       LoanId
+  )
+{
+  PP2DXE_CONTEXT *Pp2Context = INSTANCE_FROM_RX_LOAN(This);
+  EFI_TPL SavedTpl;
+
+  if (LoanId >= MVPP2_RX_LOANS_MAX) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  SavedTpl = gBS->RaiseTPL (TPL_CALLBACK);
+
+  if (Pp2Context->RxLoans[LoanId].PhysAddr == 0) {
+    ReturnUnlock (SavedTpl, EFI_INVALID_PARAMETER);
+  }
+
+  Pp2DxeRxBufferPut (Pp2Context, &Pp2Context->RxLoans[LoanId]);
+  ZeroMem (&Pp2Context->RxLoans[LoanId], sizeof (PP2DXE_RX_PACKET));
+  Pp2Context->RxLoanCount--;
+
+  ReturnUnlock (SavedTpl, EFI_SUCCESS);
 }
 
 EFI_STATUS
@@ -1125,11 +1370,18 @@ Pp2DxeSnpInstall (
 
   Pp2Context->Snp.Mode = SnpMode;
 
+  /* Expose Rx buffers for consumers which can process frames in place */
+  Pp2Context->RxLoan.Revision = MARVELL_PP2_RX_LOAN_PROTOCOL_REVISION;
+  Pp2Context->RxLoan.Receive = Pp2RxLoanReceive;
+  Pp2Context->RxLoan.Release = Pp2RxLoanRelease;
+  Pp2Context->RxLoan.MaxLoans = MVPP2_RX_LOANS_MAX;
+
   /* Install protocol */
   Status = gBS->InstallMultipleProtocolInterfaces (
       &Handle,
       &gEfiSimpleNetworkProtocolGuid, &Pp2Context->Snp,
       &gEfiDevicePathProtocolGuid, Pp2DevicePath,
+      &gMarvellPp2RxLoanProtocolGuid, &Pp2Context->RxLoan,
       NULL
       );
 
@@ -1195,6 +1447,12 @@ Pp2DxeInitialiseController (
   Mvpp2Shared->SmiBase = Mvpp2Shared->Base + MVPP22_SMI_OFFSET;
   Mvpp2Shared->Tclk = ClockFrequency;
 
+  if (MVPP2_TXD_NUM == 0 || MVPP2_TXD_NUM > MVPP2_AGGR_TXQ_SIZE ||
+      (MVPP2_TXD_NUM % MVPP2_TXD_ALIGN) != 0) {
+    DEBUG ((DEBUG_ERROR, "Pp2Dxe: invalid Tx ring size %d\n", MVPP2_TXD_NUM));
+    return EFI_INVALID_PARAMETER;
+  }
+
   /* Prepare buffers */
   Status = DmaAllocateAlignedBuffer (EfiBootServicesData,
                                      EFI_SIZE_TO_PAGES (BD_SPACE),
@@ -1209,21 +1467,21 @@ Pp2DxeInitialiseController (
 
   for (Index = 0; Index < MVPP2_MAX_PORT; Index++) {
     Mvpp2Shared->BufferLocation.TxDescs[Index] = (MVPP2_TX_DESC *)
-      (BufferSpace + Index * MVPP2_MAX_TXD * sizeof(MVPP2_TX_DESC));
+      (BufferSpace + Index * MVPP2_TXD_NUM * sizeof(MVPP2_TX_DESC));
   }
 
   Mvpp2Shared->BufferLocation.AggrTxDescs = (MVPP2_TX_DESC *)
-    ((UINTN)BufferSpace + MVPP2_MAX_TXD * MVPP2_MAX_PORT * sizeof(MVPP2_TX_DESC));
+    ((UINTN)BufferSpace + MVPP2_TXD_NUM * MVPP2_MAX_PORT * sizeof(MVPP2_TX_DESC));
 
   for (Index = 0; Index < MVPP2_MAX_PORT; Index++) {
     Mvpp2Shared->BufferLocation.RxDescs[Index] = (MVPP2_RX_DESC *)
-      ((UINTN)BufferSpace + (MVPP2_MAX_TXD * MVPP2_MAX_PORT + MVPP2_AGGR_TXQ_SIZE) *
+      ((UINTN)BufferSpace + (MVPP2_TXD_NUM * MVPP2_MAX_PORT + MVPP2_AGGR_TXQ_SIZE) *
       sizeof(MVPP2_TX_DESC) + Index * MVPP2_MAX_RXD * sizeof(MVPP2_RX_DESC));
   }
 
   for (Index = 0; Index < MVPP2_MAX_PORT; Index++) {
     Mvpp2Shared->BufferLocation.RxBuffers[Index] = (DmaAddrT)
-      (BufferSpace + (MVPP2_MAX_TXD * MVPP2_MAX_PORT + MVPP2_AGGR_TXQ_SIZE) *
+      (BufferSpace + (MVPP2_TXD_NUM * MVPP2_MAX_PORT + MVPP2_AGGR_TXQ_SIZE) *
       sizeof(MVPP2_TX_DESC) + MVPP2_MAX_RXD * MVPP2_MAX_PORT * sizeof(MVPP2_RX_DESC) +
       Index * MVPP2_BM_SIZE * RX_BUFFER_SIZE);
   }
@@ -1329,6 +1587,18 @@ Pp2DxeInitialiseController (
     }
   }
 
+  Status = gBS->CreateEvent (
+               EVT_SIGNAL_EXIT_BOOT_SERVICES,
+               TPL_CALLBACK,
+               Pp2DxeBmHalt,
+               Mvpp2Shared,
+               &Mvpp2Shared->EfiExitBootServicesEvent
+             );
+
+  if (EFI_ERROR(Status)) {
+    return Status;
+  }
+
   MvGop110NetcInit(&Pp2Context->Port, NetCompConfig, MV_NETC_FIRST_PHASE);
   MvGop110NetcInit(&Pp2Context->Port, NetCompConfig, MV_NETC_SECOND_PHASE);
 
@@ -41,6 +41,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <Protocol/Ip4.h>
 #include <Protocol/Ip6.h>
 #include <Protocol/MvPhy.h>
+#include <Protocol/Pp2RxLoan.h>
 #include <Protocol/SimpleNetwork.h>
 
 #include <Library/BaseLib.h>
@@ -60,6 +61,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define PP2DXE_SIGNATURE                    SIGNATURE_32('P', 'P', '2', 'D')
 #define INSTANCE_FROM_SNP(a)                CR((a), PP2DXE_CONTEXT, Snp, PP2DXE_SIGNATURE)
+#define INSTANCE_FROM_RX_LOAN(a)            CR((a), PP2DXE_CONTEXT, RxLoan, PP2DXE_SIGNATURE)
 
 /* OS API */
 #define Mvpp2Alloc(v)                       AllocateZeroPool(v)
@@ -163,15 +165,28 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define BM_ALIGN                           32
 #define ETH_HLEN                           14
 
+/*
+ * Number of descriptors moved from the RXQs to the staging ring at once.
+ * The buffers stay out of the BM pool until the whole batch is consumed,
+ * so it has to be well below MVPP2_BM_SIZE.
+ */
+#define MVPP2_RX_BATCH_SIZE                16
+
+/* Number of Rx buffers which can be lent out through the Rx loan protocol */
+#define MVPP2_RX_LOANS_MAX                 16
+
 /* 2(HW hdr) 14(MAC hdr) 4(CRC) 32(extra for cache prefetch) */
 #define WRAP                              (2 + ETH_HLEN + 4 + 32)
 #define MTU                               1500
 
 /*
- * Maximum retries of checking, wheter HW really sent the packet
- * after it was done is software.
+ * TX constants
+ * Number of descriptors in each port's TXQ, which also bounds the number
+ * of frames in flight before they are reaped by GetStatus. All ports
+ * share the aggregated queue, so the ring may not exceed its size.
  */
-#define MVPP2_TX_SEND_MAX_POLLING_COUNT   10000
+#define MVPP2_TXD_NUM                     FixedPcdGet32 (PcdPp2TxRingSize)
+#define MVPP2_TXD_ALIGN                   32
 
 /* Structures */
 typedef struct {
@@ -298,6 +313,9 @@ typedef struct {
 
   /* Tclk value */
   UINT32 Tclk;
+
+  /* Stops the BM pools, after all ports are halted */
+  EFI_EVENT EfiExitBootServicesEvent;
 } MVPP2_SHARED;
 
 /* Individual Port structure */
@@ -347,6 +365,15 @@ typedef struct {
   EFI_DEVICE_PATH_PROTOCOL  End;
 } PP2_DEVICE_PATH;
 
+/* Rx descriptor contents saved in the staging ring */
+typedef struct {
+  UINT32 Status;
+  UINT16 DataSize;
+  UINTN  PhysAddr;
+  UINTN  VirtAddr;
+  BOOLEAN Loaned;
+} PP2DXE_RX_PACKET;
+
 #define QUEUE_DEPTH 64
 typedef struct {
   UINT32                      Signature;
@@ -354,6 +381,7 @@ typedef struct {
   EFI_HANDLE                  Controller;
   EFI_LOCK                    Lock;
   EFI_SIMPLE_NETWORK_PROTOCOL Snp;
+  MARVELL_PP2_RX_LOAN_PROTOCOL RxLoan;
   MARVELL_PHY_PROTOCOL        *Phy;
   PHY_DEVICE                  *PhyDev;
   PP2DXE_PORT                 Port;
@@ -362,6 +390,15 @@ typedef struct {
   VOID                        *CompletionQueue[QUEUE_DEPTH];
   UINTN                       CompletionQueueHead;
   UINTN                       CompletionQueueTail;
+  VOID                        **TxInFlightQueue;
+  UINTN                       TxInFlightHead;
+  UINTN                       TxInFlightCount;
+  UINTN                       TxDoneCount;
+  PP2DXE_RX_PACKET            RxStage[MVPP2_RX_BATCH_SIZE];
+  UINTN                       RxStageHead;
+  UINTN                       RxStageCount;
+  PP2DXE_RX_PACKET            RxLoans[MVPP2_RX_LOANS_MAX];
+  UINTN                       RxLoanCount;
   EFI_EVENT                   EfiExitBootServicesEvent;
   PP2_DEVICE_PATH             *DevicePath;
 } PP2DXE_CONTEXT;
@@ -619,4 +656,21 @@ Pp2SnpReceive (
   OUT EFI_MAC_ADDRESS            *DstAddr OPTIONAL,
   OUT UINT16                     *EtherType OPTIONAL
   );
+
+/* Rx loan callbacks */
+EFI_STATUS
+EFIAPI
+Pp2RxLoanReceive (
+  IN MARVELL_PP2_RX_LOAN_PROTOCOL *This,
+  OUT VOID                        **Frame,
+  OUT UINTN                       *FrameSize,
+  OUT UINT64                      *LoanId
+  );
+
+EFI_STATUS
+EFIAPI
+Pp2RxLoanRelease (
+  IN MARVELL_PP2_RX_LOAN_PROTOCOL *This,
+  IN UINT64                       LoanId
+  );
 #endif
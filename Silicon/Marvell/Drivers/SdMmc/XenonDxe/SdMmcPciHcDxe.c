@@ -1012,12 +1012,13 @@ SdMmcPassThruPassThru (
   }
 
 Done:
-  if ((Trb != NULL) && (Trb->AdmaDesc != NULL)) {
-    FreePages (Trb->AdmaDesc, Trb->AdmaPages);
-  }
-
+  //
+  // Unmap the data buffer so that DMA reads are visible to the caller,
+  // and release the descriptor table through the PCI I/O protocol that
+  // allocated it.
+  //
   if (Trb != NULL) {
-    FreePool (Trb);
+    SdMmcFreeTrb (Trb);
   }
 
   return Status;
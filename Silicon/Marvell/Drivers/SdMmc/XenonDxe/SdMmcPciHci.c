@@ -16,6 +16,7 @@
 **/
 
 #include "SdMmcPciHcDxe.h"
+#include "XenonSdhci.h"
 
 /**
   Dump the content of SD/MMC host controller's Capability Register.
@@ -1093,6 +1094,8 @@ SdMmcHcLedOnOff (
   Build ADMA descriptor table for transfer.
 
   Refer to SD Host Controller Simplified spec 3.0 Section 1.13 for details.
+  The 96-bit descriptor format is used for SdMmcAdma64Mode transfers, which
+  allows both the data buffer and the table itself to live above 4GB.
 
   @param[in] Trb            The pointer to the SD_MMC_HC_TRB instance.
 
@@ -1110,31 +1113,33 @@ BuildAdmaDescTable (
   UINT64                    Entries;
   UINT32                    Index;
   UINT64                    Remaining;
-  UINT32                    Address;
+  UINT64                    Address;
   UINTN                     TableSize;
+  UINTN                     DescSize;
   EFI_PCI_IO_PROTOCOL       *PciIo;
   EFI_STATUS                Status;
   UINTN                     Bytes;
+  SD_MMC_HC_ADMA_DESC_LINE    *AdmaDesc;
+  SD_MMC_HC_ADMA_64_DESC_LINE *Adma64Desc;
 
   Data    = Trb->DataPhy;
   DataLen = Trb->DataLen;
   PciIo   = Trb->Private->PciIo;
-  //
-  // Only support 32bit ADMA Descriptor Table
-  //
-  if ((Data >= 0x100000000ul) || ((Data + DataLen) > 0x100000000ul)) {
-    return EFI_INVALID_PARAMETER;
-  }
-  //
-  // Address field shall be set on 32-bit boundary (Lower 2-bit is always set to 0)
-  // for 32-bit address descriptor table.
-  //
-  if ((Data & (BIT0 | BIT1)) != 0) {
-    DEBUG ((DEBUG_INFO, "The buffer [0x%x] to construct ADMA desc is not aligned to 4 bytes boundary!\n", Data));
+
+  if (Trb->Mode == SdMmcAdma64Mode) {
+    DescSize = sizeof (SD_MMC_HC_ADMA_64_DESC_LINE);
+  } else {
+    //
+    // 32-bit descriptor table can only address the low 4GB
+    //
+    if ((Data >= 0x100000000ul) || ((Data + DataLen) > 0x100000000ul)) {
+      return EFI_INVALID_PARAMETER;
+    }
+    DescSize = sizeof (SD_MMC_HC_ADMA_DESC_LINE);
   }
 
   Entries   = DivU64x32 ((DataLen + ADMA_MAX_DATA_PER_LINE - 1), ADMA_MAX_DATA_PER_LINE);
-  TableSize = (UINTN)MultU64x32 (Entries, sizeof (SD_MMC_HC_ADMA_DESC_LINE));
+  TableSize = (UINTN)MultU64x32 (Entries, (UINT32)DescSize);
   Trb->AdmaPages = (UINT32)EFI_SIZE_TO_PAGES (TableSize);
   Status = PciIo->AllocateBuffer (
                     PciIo,
@@ -1145,6 +1150,7 @@ BuildAdmaDescTable (
                     0
                     );
   if (EFI_ERROR (Status)) {
+    Trb->AdmaDesc = NULL;
     return EFI_OUT_OF_RESOURCES;
   }
   ZeroMem (Trb->AdmaDesc, TableSize);
@@ -1167,10 +1173,12 @@ BuildAdmaDescTable (
              EFI_SIZE_TO_PAGES (TableSize),
              Trb->AdmaDesc
              );
+    Trb->AdmaDesc = NULL;
     return EFI_OUT_OF_RESOURCES;
   }
 
-  if ((UINT64)(UINTN)Trb->AdmaDescPhy > 0x100000000ul) {
+  if ((Trb->Mode != SdMmcAdma64Mode) &&
+      ((UINT64)(UINTN)Trb->AdmaDescPhy > 0x100000000ul)) {
     //
     // The ADMA doesn't support 64bit addressing.
     //
@@ -1183,23 +1191,34 @@ BuildAdmaDescTable (
       EFI_SIZE_TO_PAGES (TableSize),
       Trb->AdmaDesc
     );
+    Trb->AdmaMap  = NULL;
+    Trb->AdmaDesc = NULL;
     return EFI_DEVICE_ERROR;
   }
 
-  Remaining = DataLen;
-  Address   = (UINT32)Data;
+  AdmaDesc   = Trb->AdmaDesc;
+  Adma64Desc = Trb->AdmaDesc;
+  Remaining  = DataLen;
+  Address    = Data;
   for (Index = 0; Index < Entries; Index++) {
+    //
+    // Length field of 0 means 64KB of data in the descriptor line
+    //
+    if (Trb->Mode == SdMmcAdma64Mode) {
+      Adma64Desc[Index].Valid        = 1;
+      Adma64Desc[Index].Act          = 2;
+      Adma64Desc[Index].Length       = (UINT16)MIN (Remaining, ADMA_MAX_DATA_PER_LINE);
+      Adma64Desc[Index].LowerAddress = (UINT32)Address;
+      Adma64Desc[Index].UpperAddress = (UINT32)RShiftU64 (Address, 32);
+    } else {
+      AdmaDesc[Index].Valid   = 1;
+      AdmaDesc[Index].Act     = 2;
+      AdmaDesc[Index].Length  = (UINT16)MIN (Remaining, ADMA_MAX_DATA_PER_LINE);
+      AdmaDesc[Index].Address = (UINT32)Address;
+    }
+
     if (Remaining <= ADMA_MAX_DATA_PER_LINE) {
-      Trb->AdmaDesc[Index].Valid = 1;
-      Trb->AdmaDesc[Index].Act   = 2;
-      Trb->AdmaDesc[Index].Length  = (UINT16)Remaining;
-      Trb->AdmaDesc[Index].Address = Address;
       break;
-    } else {
-      Trb->AdmaDesc[Index].Valid = 1;
-      Trb->AdmaDesc[Index].Act   = 2;
-      Trb->AdmaDesc[Index].Length  = 0;
-      Trb->AdmaDesc[Index].Address = Address;
     }
 
     Remaining -= ADMA_MAX_DATA_PER_LINE;
@@ -1209,7 +1228,11 @@ BuildAdmaDescTable (
   //
   // Set the last descriptor line as end of descriptor table
   //
-  Trb->AdmaDesc[Index].End = 1;
+  if (Trb->Mode == SdMmcAdma64Mode) {
+    Adma64Desc[Index].End = 1;
+  } else {
+    AdmaDesc[Index].End = 1;
+  }
   return EFI_SUCCESS;
 }
 
@@ -1287,7 +1310,9 @@ SdMmcCreateTrb (
     }
 
     PciIo = Private->PciIo;
-    if (Trb->DataLen != 0) {
+    if (Trb->DataLen == 0) {
+      Trb->Mode = SdMmcNoData;
+    } else {
       MapLength = Trb->DataLen;
       Status = PciIo->Map (
                         PciIo,
@@ -1297,25 +1322,42 @@ SdMmcCreateTrb (
                         &Trb->DataPhy,
                         &Trb->DataMap
                         );
-      if (EFI_ERROR (Status) || (Trb->DataLen != MapLength)) {
-        Status = EFI_BAD_BUFFER_SIZE;
-        goto Error;
-      }
-    }
-
-    if (Trb->DataLen == 0) {
-      Trb->Mode = SdMmcNoData;
-    } else if (Private->Capability[Slot].Adma2 != 0) {
-      Trb->Mode = SdMmcAdmaMode;
-      Status = BuildAdmaDescTable (Trb);
       if (EFI_ERROR (Status)) {
+        Trb->DataMap = NULL;
+      } else if (Trb->DataLen != MapLength) {
         PciIo->Unmap (PciIo, Trb->DataMap);
-        goto Error;
+        Trb->DataMap = NULL;
       }
-    } else if (Private->Capability[Slot].Sdma != 0) {
-      Trb->Mode = SdMmcSdmaMode;
-    } else {
+
+      //
+      // Prefer ADMA2, using 64-bit descriptors whenever the controller can
+      // master the whole system bus, then SDMA. PIO is only used when the
+      // buffer cannot be handed to either DMA engine.
+      //
       Trb->Mode = SdMmcPioMode;
+      if (Trb->DataMap != NULL) {
+        if ((Private->Capability[Slot].Adma2 != 0) &&
+            ((Trb->DataPhy & (BIT0 | BIT1)) == 0)) {
+          if (Private->Capability[Slot].SysBus64 != 0) {
+            Trb->Mode = SdMmcAdma64Mode;
+          } else {
+            Trb->Mode = SdMmcAdmaMode;
+          }
+          Status = BuildAdmaDescTable (Trb);
+          if (EFI_ERROR (Status)) {
+            DEBUG ((DEBUG_INFO, "SdMmcCreateTrb: ADMA desc table build failed (%r)\n", Status));
+            Trb->Mode = SdMmcPioMode;
+          }
+        } else if ((Private->Capability[Slot].Sdma != 0) &&
+                   ((Trb->DataPhy + Trb->DataLen) <= 0x100000000ul)) {
+          Trb->Mode = SdMmcSdmaMode;
+        }
+
+        if (Trb->Mode == SdMmcPioMode) {
+          PciIo->Unmap (PciIo, Trb->DataMap);
+          Trb->DataMap = NULL;
+        }
+      }
     }
   }
 
@@ -1525,8 +1567,22 @@ SdMmcExecTrb (
   //
   // Set Host Control 1 register DMA Select field
   //
-  if (Trb->Mode == SdMmcAdmaMode) {
-    HostCtrl1 = BIT4;
+  if ((Trb->Mode == SdMmcSdmaMode) ||
+      (Trb->Mode == SdMmcAdmaMode) ||
+      (Trb->Mode == SdMmcAdma64Mode)) {
+    HostCtrl1 = (UINT8)~SD_MMC_HC_DMA_SEL_MASK;
+    Status = SdMmcHcAndMmio (PciIo, Trb->Slot, SD_MMC_HC_HOST_CTRL1, sizeof (HostCtrl1), &HostCtrl1);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    if (Trb->Mode == SdMmcAdmaMode) {
+      HostCtrl1 = SD_MMC_HC_DMA_SEL_ADMA32;
+    } else if (Trb->Mode == SdMmcAdma64Mode) {
+      HostCtrl1 = SD_MMC_HC_DMA_SEL_ADMA64;
+    } else {
+      HostCtrl1 = SD_MMC_HC_DMA_SEL_SDMA;
+    }
     Status = SdMmcHcOrMmio (PciIo, Trb->Slot, SD_MMC_HC_HOST_CTRL1, sizeof (HostCtrl1), &HostCtrl1);
     if (EFI_ERROR (Status)) {
       return Status;
@@ -1545,7 +1601,7 @@ SdMmcExecTrb (
     if (EFI_ERROR (Status)) {
       return Status;
     }
-  } else if (Trb->Mode == SdMmcAdmaMode) {
+  } else if ((Trb->Mode == SdMmcAdmaMode) || (Trb->Mode == SdMmcAdma64Mode)) {
     AdmaAddr = (UINT64)(UINTN)Trb->AdmaDescPhy;
     Status   = SdMmcHcRwMmio (PciIo, Trb->Slot, SD_MMC_HC_ADMA_SYS_ADDR, FALSE, sizeof (AdmaAddr), &AdmaAddr);
     if (EFI_ERROR (Status)) {
@@ -1843,6 +1899,36 @@ SdMmcCheckTrbResult (
     }
   }
 
+  //
+  // Move the next block through the Buffer Data Port register once the
+  // controller signals Buffer Write Ready or Buffer Read Ready.
+  //
+  if ((Trb->Mode == SdMmcPioMode) &&
+      ((IntStatus & (BIT4 | BIT5)) != 0) &&
+      (Trb->PioBlockIndex < (Trb->DataLen / Trb->BlockSize))) {
+    IntStatus &= BIT4 | BIT5;
+    Status = SdMmcHcRwMmio (
+               Private->PciIo,
+               Trb->Slot,
+               SD_MMC_HC_NOR_INT_STS,
+               FALSE,
+               sizeof (IntStatus),
+               &IntStatus
+               );
+    if (EFI_ERROR (Status)) {
+      goto Done;
+    }
+
+    XenonTransferPio (
+      Private,
+      Trb->Slot,
+      (UINT8 *)Trb->Data + Trb->PioBlockIndex * Trb->BlockSize,
+      Trb->BlockSize,
+      Trb->Read
+      );
+    Trb->PioBlockIndex++;
+  }
+
   Status = EFI_NOT_READY;
 Done:
   //
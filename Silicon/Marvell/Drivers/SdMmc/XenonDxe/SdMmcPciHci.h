@@ -70,7 +70,8 @@ typedef enum {
   SdMmcNoData,
   SdMmcPioMode,
   SdMmcSdmaMode,
-  SdMmcAdmaMode
+  SdMmcAdmaMode,
+  SdMmcAdma64Mode
 } SD_MMC_HC_TRANSFER_MODE;
 
 //
@@ -89,6 +90,32 @@ typedef struct {
   UINT32 Address;
 } SD_MMC_HC_ADMA_DESC_LINE;
 
+//
+// 96-bit descriptor line used by 64-bit ADMA2,
+// Simplified Spec 3.0 Figure 1-11
+//
+#pragma pack(1)
+typedef struct {
+  UINT32 Valid:1;
+  UINT32 End:1;
+  UINT32 Int:1;
+  UINT32 Reserved:1;
+  UINT32 Act:2;
+  UINT32 Reserved1:10;
+  UINT32 Length:16;
+  UINT32 LowerAddress;
+  UINT32 UpperAddress;
+} SD_MMC_HC_ADMA_64_DESC_LINE;
+#pragma pack()
+
+//
+// DMA Select field of the Host Control 1 register
+//
+#define SD_MMC_HC_DMA_SEL_MASK        (BIT3 | BIT4)
+#define SD_MMC_HC_DMA_SEL_SDMA        0
+#define SD_MMC_HC_DMA_SEL_ADMA32      BIT4
+#define SD_MMC_HC_DMA_SEL_ADMA64      (BIT3 | BIT4)
+
 #define SD_MMC_SDMA_BOUNDARY          512 * 1024
 #define SD_MMC_SDMA_ROUND_UP(x, n)    (((x) + n) & ~(n - 1))
 
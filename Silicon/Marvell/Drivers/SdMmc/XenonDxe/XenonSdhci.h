@@ -321,14 +321,12 @@ XenonReset (
   IN UINT8 Mask
   );
 
-EFI_STATUS
-XenonTransferData (
+VOID
+XenonTransferPio (
   IN SD_MMC_HC_PRIVATE_DATA *Private,
   IN UINT8 Slot,
   IN OUT VOID *Buffer,
-  IN UINT32 DataLen,
   IN UINT16 BlockSize,
-  IN UINT16 Blocks,
   IN BOOLEAN Read
   );
 
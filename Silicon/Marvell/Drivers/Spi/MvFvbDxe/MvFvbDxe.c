@@ -43,6 +43,8 @@ STATIC CONST FVB_DEVICE mMvFvbFlashInstanceTemplate = {
     NULL, // SpiFlash detailed information ... NEED TO BE FILLED
     0,    // HostRegisterBaseAddress ... NEED TO BE FILLED
     0,    // CoreClock ... NEED TO BE FILLED
+    0,    // MemoryBaseAddress ... NEED TO BE FILLED
+    0,    // MemorySize ... NEED TO BE FILLED
   }, // SpiDevice
 
   NULL, // SpiFlashProtocol ... NEED TO BE FILLED
@@ -266,6 +266,76 @@ MvSpiFlashRead (
   return Status;
 }
 
+STATIC
+VOID
+MvSpiFlashCopyFromWindow (
+  IN  UINTN   Source,
+  OUT UINT8   *Buf,
+  IN  UINTN   Length
+  )
+{
+  //
+  // The window is mapped as device memory, so use naturally aligned
+  // accesses only and let the destination buffer take the misalignment.
+  //
+  while (Length > 0 && (Source & (sizeof (UINT32) - 1)) != 0) {
+    *Buf++ = MmioRead8 (Source++);
+    Length--;
+  }
+
+  while (Length >= sizeof (UINT32)) {
+    WriteUnaligned32 ((UINT32 *)Buf, MmioRead32 (Source));
+    Buf += sizeof (UINT32);
+    Source += sizeof (UINT32);
+    Length -= sizeof (UINT32);
+  }
+
+  while (Length > 0) {
+    *Buf++ = MmioRead8 (Source++);
+    Length--;
+  }
+}
+
+EFI_STATUS
+EFIAPI
+MvSpiFlashReadBulk (
+  IN SPI_DEVICE   *Slave,
+  IN UINT32       Offset,
+  IN UINTN        Length,
+  IN VOID         *Buf
+  )
+{
+  UINTN WindowEnd, WindowLength;
+
+  //
+  // The direct access window is not mapped for the OS, and it only covers
+  // the first bank of the device, so anything else goes through the
+  // regular read command path.
+  //
+  WindowEnd = MIN (Slave->MemorySize, SPI_FLASH_16MB_BOUN);
+  if (EfiAtRuntime () ||
+      Slave->MemoryBaseAddress == 0 ||
+      Offset >= WindowEnd) {
+    return MvSpiFlashRead (Slave, Offset, Length, Buf);
+  }
+
+  WindowLength = MIN (Length, WindowEnd - Offset);
+
+  // Make sure the window decodes the first bank
+  SpiFlashBank (Slave, 0);
+
+  MvSpiFlashCopyFromWindow (Slave->MemoryBaseAddress + Offset, Buf, WindowLength);
+
+  if (WindowLength == Length) {
+    return EFI_SUCCESS;
+  }
+
+  return MvSpiFlashRead (Slave,
+           Offset + WindowLength,
+           Length - WindowLength,
+           (UINT8 *)Buf + WindowLength);
+}
+
 EFI_STATUS
 MvSpiFlashWrite (
   IN SPI_DEVICE *Slave,
@@ -321,12 +391,17 @@ MvSpiFlashUpdateBlock (
   EFI_STATUS Status;
 
   // Read backup
-  Status = MvSpiFlashRead (Slave, Offset, EraseSize, TmpBuf);
+  Status = MvSpiFlashReadBulk (Slave, Offset, EraseSize, TmpBuf);
     if (EFI_ERROR (Status)) {
       DEBUG((DEBUG_ERROR, "SpiFlash: Update: Error while reading old data\n"));
       return Status;
     }
 
+  // Sector already holds the new data
+  if (CompareMem (TmpBuf, Buf, ToUpdate) == 0) {
+    return EFI_SUCCESS;
+  }
+
   // Erase entire sector
   Status = MvSpiFlashErase (Slave, Offset, EraseSize);
   if (EFI_ERROR (Status)) {
@@ -500,6 +575,7 @@ MvSpiFlashInitProtocol (
   SpiFlashProtocol->Write = MvSpiFlashWrite;
   SpiFlashProtocol->Erase = MvSpiFlashErase;
   SpiFlashProtocol->Update = MvSpiFlashUpdate;
+  SpiFlashProtocol->ReadBulk = MvSpiFlashReadBulk;
 
   return EFI_SUCCESS;
 }
@@ -186,6 +186,56 @@ SpiSetupTransfer (
   EfiReleaseLock (&SpiMaster->Lock);
 }
 
+STATIC
+VOID
+SpiSetWordLength (
+  IN UINTN   SpiRegBase,
+  IN BOOLEAN WordMode
+  )
+{
+  UINT32 Reg;
+
+  Reg = MmioRead32 (SpiRegBase + SPI_CONF_REG);
+  if (WordMode) {
+    Reg |= SPI_BYTE_LENGTH;
+  } else {
+    Reg &= ~SPI_BYTE_LENGTH;
+  }
+  MmioWrite32 (SpiRegBase + SPI_CONF_REG, Reg);
+}
+
+/**
+  Shift one 8-bit or 16-bit frame through the controller.
+
+  In 16-bit mode the frame is shifted out MSB first, so the first byte of the
+  buffer has to be placed in the upper half of the data register in order to
+  keep the byte order on the wire identical to the 8-bit mode.
+**/
+STATIC
+EFI_STATUS
+SpiTransferFrame (
+  IN  UINTN   SpiRegBase,
+  IN  UINT32  DataToSend,
+  OUT UINT32  *DataReceived
+  )
+{
+  UINT32  Iterator;
+
+  MmioWrite32 (SpiRegBase + SPI_INT_CAUSE_REG, 0x0);
+  MmioWrite32 (SpiRegBase + SPI_DATA_OUT_REG, DataToSend);
+
+  // Wait for memory ready
+  for (Iterator = 0; Iterator < SPI_TIMEOUT; Iterator++) {
+    if (MmioRead32 (SpiRegBase + SPI_INT_CAUSE_REG)) {
+      *DataReceived = MmioRead32 (SpiRegBase + SPI_DATA_IN_REG);
+      return EFI_SUCCESS;
+    }
+  }
+
+  DEBUG ((DEBUG_ERROR, "%a: Timeout\n", __FUNCTION__));
+  return EFI_TIMEOUT;
+}
+
 EFI_STATUS
 EFIAPI
 MvSpiTransfer (
@@ -198,18 +248,19 @@ MvSpiTransfer (
   )
 {
   SPI_MASTER *SpiMaster;
-  UINT64  Length;
-  UINT32  Iterator, Reg;
+  EFI_STATUS Status;
+  UINTN   Length;
+  UINT32  DataToSend, DataReceived;
   UINT8   *DataOutPtr = (UINT8 *)DataOut;
   UINT8   *DataInPtr  = (UINT8 *)DataIn;
-  UINT8   DataToSend  = 0;
   UINTN   SpiRegBase;
 
   SpiMaster = SPI_MASTER_FROM_SPI_MASTER_PROTOCOL (This);
 
   SpiRegBase = Slave->HostRegisterBaseAddress;
 
-  Length = 8 * DataByteCount;
+  Length = DataByteCount;
+  Status = EFI_SUCCESS;
 
   if (!EfiAtRuntime ()) {
     EfiAcquireLock (&SpiMaster->Lock);
@@ -219,39 +270,59 @@ MvSpiTransfer (
     SpiActivateCs (Slave);
   }
 
+  //
+  // Move the bulk of the data in 16-bit frames, which halves the number
+  // of interrupt cause polls, and finish an odd trailing byte in 8-bit mode.
+  //
+  if (Length >= SPI_WORD_BYTES) {
+    SpiSetWordLength (SpiRegBase, TRUE);
+
+    while (Length >= SPI_WORD_BYTES) {
+      DataToSend = 0;
+      if (DataOutPtr != NULL) {
+        DataToSend = (DataOutPtr[0] << 8) | DataOutPtr[1];
+        DataOutPtr += SPI_WORD_BYTES;
+      }
+
+      Status = SpiTransferFrame (SpiRegBase, DataToSend, &DataReceived);
+      if (EFI_ERROR (Status)) {
+        SpiSetWordLength (SpiRegBase, FALSE);
+        goto Exit;
+      }
+
+      if (DataInPtr != NULL) {
+        DataInPtr[0] = (UINT8)(DataReceived >> 8);
+        DataInPtr[1] = (UINT8)DataReceived;
+        DataInPtr += SPI_WORD_BYTES;
+      }
+      Length -= SPI_WORD_BYTES;
+    }
+  }
+
   // Set 8-bit mode
-  Reg = MmioRead32 (SpiRegBase + SPI_CONF_REG);
-  Reg &= ~SPI_BYTE_LENGTH;
-  MmioWrite32 (SpiRegBase + SPI_CONF_REG, Reg);
+  SpiSetWordLength (SpiRegBase, FALSE);
 
-  while (Length > 0) {
-    if (DataOut != NULL) {
-      DataToSend = *DataOutPtr & 0xFF;
+  if (Length > 0) {
+    DataToSend = 0;
+    if (DataOutPtr != NULL) {
+      DataToSend = *DataOutPtr;
     }
-    // Transmit Data
-    MmioWrite32 (SpiRegBase + SPI_INT_CAUSE_REG, 0x0);
-    MmioWrite32 (SpiRegBase + SPI_DATA_OUT_REG, DataToSend);
-    // Wait for memory ready
-    for (Iterator = 0; Iterator < SPI_TIMEOUT; Iterator++) {
-      if (MmioRead32 (SpiRegBase + SPI_INT_CAUSE_REG)) {
-        if (DataInPtr != NULL) {
-          *DataInPtr = MmioRead32 (SpiRegBase + SPI_DATA_IN_REG);
-          DataInPtr++;
-        }
-        if (DataOutPtr != NULL) {
-          DataOutPtr++;
-        }
-        Length -= 8;
-        break;
-      }
+
+    Status = SpiTransferFrame (SpiRegBase, DataToSend, &DataReceived);
+    if (EFI_ERROR (Status)) {
+      goto Exit;
     }
 
-    if (Iterator >= SPI_TIMEOUT) {
-      DEBUG ((DEBUG_ERROR, "%a: Timeout\n", __FUNCTION__));
-      return EFI_TIMEOUT;
+    if (DataInPtr != NULL) {
+      *DataInPtr = (UINT8)DataReceived;
     }
   }
 
+Exit:
+  //
+  // Release chip select on failure too, otherwise the flash would take the
+  // next command as part of this one.
+  //
   if (Flag & SPI_TRANSFER_END) {
     SpiDeactivateCs (Slave);
   }
@@ -260,7 +331,7 @@ MvSpiTransfer (
     EfiReleaseLock (&SpiMaster->Lock);
   }
 
-  return EFI_SUCCESS;
+  return Status;
 }
 
 EFI_STATUS
@@ -326,6 +397,18 @@ MvSpiSetupSlave (
   Slave->CoreClock = PcdGet32 (PcdSpiClockFrequency);
   Slave->MaxFreq = PcdGet32 (PcdSpiMaxFrequency);
 
+  //
+  // The boot flash is also visible through the direct access window
+  // of the controller, which allows reading it without issuing commands.
+  //
+  if (Slave->Cs == PcdGet32 (PcdSpiFlashCs)) {
+    Slave->MemoryBaseAddress = PcdGet32 (PcdSpiMemoryBase);
+    Slave->MemorySize = PcdGet32 (PcdSpiMemorySize);
+  } else {
+    Slave->MemoryBaseAddress = 0;
+    Slave->MemorySize = 0;
+  }
+
   SpiSetupTransfer (This, Slave);
 
   return Slave;
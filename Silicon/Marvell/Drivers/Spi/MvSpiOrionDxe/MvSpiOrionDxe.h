@@ -66,6 +66,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 // Serial Memory Interface Configuration Register Masks
 #define SPI_BYTE_LENGTH_OFFSET          5
 #define SPI_BYTE_LENGTH                 (0x1  << SPI_BYTE_LENGTH_OFFSET)
+#define SPI_WORD_BYTES                  2
 #define SPI_CPOL_OFFSET                 11
 #define SPI_CPOL_MASK                   (0x1 << SPI_CPOL_OFFSET)
 #define SPI_CPHA_OFFSET                 12
@@ -0,0 +1,63 @@
+/** @file
+  Marvell Pp2 Rx buffer loan protocol
+
+  Lets a consumer receive Ethernet frames in place, in the BM pool buffer
+  the hardware received them into, instead of having them copied out by the
+  SNP Receive () function. The buffer has to be returned with Release ()
+  once the consumer is done with the frame. Frames still on loan when the
+  interface is shut down or stopped are taken back by the driver, and their
+  LoanId becomes invalid.
+
+  Copyright (c) 2026, Marvell International Ltd.<BR>
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __MARVELL_PP2_RX_LOAN_PROTOCOL_H__
+#define __MARVELL_PP2_RX_LOAN_PROTOCOL_H__
+
+#define MARVELL_PP2_RX_LOAN_PROTOCOL_GUID { 0x566ad105, 0x35de, 0x4430, { 0x80, 0x65, 0xa0, 0xda, 0xd2, 0x3e, 0x25, 0xeb }}
+
+#define MARVELL_PP2_RX_LOAN_PROTOCOL_REVISION  0x00010000
+
+typedef struct _MARVELL_PP2_RX_LOAN_PROTOCOL MARVELL_PP2_RX_LOAN_PROTOCOL;
+
+/*
+ * Return the next received frame, starting with its Ethernet header.
+ * EFI_NOT_READY is returned if no frame is pending and EFI_OUT_OF_RESOURCES
+ * if MaxLoans frames are not released yet.
+ */
+typedef
+EFI_STATUS
+(EFIAPI *MARVELL_PP2_RX_LOAN_RECEIVE) (
+  IN MARVELL_PP2_RX_LOAN_PROTOCOL *This,
+  OUT VOID **Frame,
+  OUT UINTN *FrameSize,
+  OUT UINT64 *LoanId
+  );
+
+/* Give the buffer of a loaned frame back to the BM pool */
+typedef
+EFI_STATUS
+(EFIAPI *MARVELL_PP2_RX_LOAN_RELEASE) (
+  IN MARVELL_PP2_RX_LOAN_PROTOCOL *This,
+  IN UINT64 LoanId
+  );
+
+struct _MARVELL_PP2_RX_LOAN_PROTOCOL {
+  UINT64 Revision;
+  /* Maximum number of frames that can be on loan at the same time */
+  UINT32 MaxLoans;
+  MARVELL_PP2_RX_LOAN_RECEIVE Receive;
+  MARVELL_PP2_RX_LOAN_RELEASE Release;
+};
+
+extern EFI_GUID gMarvellPp2RxLoanProtocolGuid;
+#endif
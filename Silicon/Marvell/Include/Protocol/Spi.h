@@ -55,6 +55,8 @@ typedef struct {
   NOR_FLASH_INFO *Info;
   UINTN HostRegisterBaseAddress;
   UINTN CoreClock;
+  UINTN MemoryBaseAddress;  // Direct access read window, 0 if not mapped
+  UINTN MemorySize;
 } SPI_DEVICE;
 
 typedef
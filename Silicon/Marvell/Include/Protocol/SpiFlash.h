@@ -63,6 +63,20 @@ EFI_STATUS
   IN VOID       *Buffer
   );
 
+/**
+  Read a large region of the SPI flash. Whatever part of the region is covered
+  by the direct access window of the controller is copied straight from the
+  memory mapped flash, the rest is read with regular read commands.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *MV_SPI_FLASH_READ_BULK) (
+  IN SPI_DEVICE *SpiDev,
+  IN UINT32     Address,
+  IN UINTN      DataByteCount,
+  IN VOID       *Buffer
+  );
+
 typedef
 EFI_STATUS
 (EFIAPI *MV_SPI_FLASH_WRITE) (
@@ -96,6 +110,7 @@ struct _MARVELL_SPI_FLASH_PROTOCOL {
   MV_SPI_FLASH_WRITE   Write;
   MV_SPI_FLASH_ERASE   Erase;
   MV_SPI_FLASH_UPDATE  Update;
+  MV_SPI_FLASH_READ_BULK ReadBulk;
 };
 
 #endif // __MV_SPI_FLASH__
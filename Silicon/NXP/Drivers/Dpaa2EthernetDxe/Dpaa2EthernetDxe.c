@@ -26,6 +26,7 @@
 #include <Library/NetLib.h>
 #include <Library/PcdLib.h>
 #include <Library/SysEepromLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiRuntimeServicesTableLib.h>
 #include <Protocol/ComponentName2.h>
@@ -43,7 +44,14 @@ CHAR8  * CONST gDpaaDebugString = "DPAA2";
 STATIC DPAA2_ETHERNET_DRIVER gDpaa2Driver = {
   .DpmacsList = INITIALIZE_LIST_HEAD_VARIABLE (gDpaa2Driver.DpmacsList),
   .Dpaa2EthernetDevicesList = INITIALIZE_LIST_HEAD_VARIABLE (gDpaa2Driver.Dpaa2EthernetDevicesList),
-  .ExitBootServicesEvent = NULL
+  .ExitBootServicesEvent = NULL,
+  .PacketTrace = {
+    .Revision = DPAA2_PACKET_TRACE_PROTOCOL_REVISION,
+    .MaxRecords = DPAA2_PACKET_TRACE_RING_SIZE,
+    .TimestampFrequency = 0,
+    .GetRecords = Dpaa2PacketTraceGetRecords,
+    .Dump = Dpaa2PacketTraceDump,
+  }
 };
 
 /**
@@ -119,6 +127,13 @@ STATIC const DPAA2_ETHERNET_DEVICE gDpaa2EthernetDeviceInitTemplate = {
     }
   },
 
+  .RxLoan = {
+    .Revision = DPAA2_RX_LOAN_PROTOCOL_REVISION,
+    .MaxLoans = DPAA2_ETH_MAX_RX_LOANS,
+    .Receive = Dpaa2RxLoanReceive,
+    .Release = Dpaa2RxLoanRelease,
+  },
+
   .WriopDpmac = NULL,
   .PhyInitialized = FALSE,
   .Dpaa2NetInterface = {
@@ -159,6 +174,26 @@ Dpaa2SnpValidateParameters (
   return EFI_SUCCESS;
 }
 
+/**
+ * Mark all entries of the Tx frames in flight slab of a DPAA2 Ethernet
+ * device as free
+ */
+STATIC
+VOID
+Dpaa2ResetTxFramesInFlight (
+  IN DPAA2_ETHERNET_DEVICE *Dpaa2EthDev
+  )
+{
+  UINT32 I;
+
+  ZeroMem (Dpaa2EthDev->TxFramesInFlight, sizeof (Dpaa2EthDev->TxFramesInFlight));
+  for (I = 0; I < DPAA2_MAX_TX_FRAMES_IN_FLIGHT; I++) {
+    Dpaa2EthDev->TxFramesInFlightFreeStack[I] = DPAA2_MAX_TX_FRAMES_IN_FLIGHT - 1 - I;
+  }
+
+  Dpaa2EthDev->TxFramesInFlightFreeCount = DPAA2_MAX_TX_FRAMES_IN_FLIGHT;
+}
+
 /**
    SNP protocol Start () function
 
@@ -293,25 +328,14 @@ Dpaa2SnpStop (
 
   EfiAcquireLock (&Dpaa2EthDev->TxFramesInFlightLock);
 
-  if (!IsListEmpty (&Dpaa2EthDev->TxFramesInFlightList)) {
+  if (Dpaa2EthDev->TxFramesInFlightFreeCount != DPAA2_MAX_TX_FRAMES_IN_FLIGHT) {
     /*
-     * Destroy outstanding TxFrameInFlight objects:
+     * Discard outstanding Tx frames in flight:
      */
-    DPAA2_TX_FRAME_IN_FLIGHT *TxFrameInFlight;
-    LIST_ENTRY *ListNode;
-    LIST_ENTRY *NextNode;
-
     DPAA_WARN_MSG ("WARNING: There were pending transmits for %a\n",
                    gWriopDpmacStrings[WriopDpmac->Id]);
 
-    for (ListNode = GetFirstNode (&Dpaa2EthDev->TxFramesInFlightList);
-         ListNode != &Dpaa2EthDev->TxFramesInFlightList;
-         ListNode = NextNode) {
-      TxFrameInFlight = CR (ListNode, DPAA2_TX_FRAME_IN_FLIGHT, ListNode,
-                           DPAA2_TX_FRAME_IN_FLIGHT_SIGNATURE);
-      NextNode = RemoveEntryList (&TxFrameInFlight->ListNode);
-      FreePool (TxFrameInFlight);
-    }
+    Dpaa2ResetTxFramesInFlight (Dpaa2EthDev);
   }
 
   EfiReleaseLock (&Dpaa2EthDev->TxFramesInFlightLock);
@@ -504,6 +528,10 @@ Dpaa2SnpShutdown (
     SnpMode->MCastFilterCount = 0;
   }
 
+  DPAA_INFO_MSG ("Peak number of Tx frames in flight for %a: %u\n",
+                 gWriopDpmacStrings[WriopDpmac->Id],
+                 Dpaa2EthDev->TxFramesInFlightPeak);
+
   Dpaa2PhyShutdown (&WriopDpmac->Phy);
   SnpMode->State = EfiSimpleNetworkStarted;
   return EFI_SUCCESS;
@@ -861,8 +889,8 @@ Dpaa2SnpNvData (
 
 /**
  * Check arrival of Tx completions for Tx frames in flight.
- * If a Tx completion was received from the hardware, free corresponding
- * TxFrameInFlight object
+ * If a Tx completion was received from the hardware, free the corresponding
+ * entry of the Tx frames in flight slab
  */
 STATIC
 VOID
@@ -872,17 +900,17 @@ Dpaa2CheckTxCompletion (
   )
 {
   UINT64 QBmanTxBufferAddr;
+  UINT32 TxFrameIndex;
   EFI_STATUS Status;
-  LIST_ENTRY *ListNode;
-  BOOLEAN TxBufferFound = FALSE;
-  DPAA2_TX_FRAME_IN_FLIGHT *TxFrameInFlight = NULL;
+  DPAA2_TX_FRAME_IN_FLIGHT *TxFrameInFlight;
 
-  if (IsListEmpty (&Dpaa2EthDev->TxFramesInFlightList)) {
+  if (Dpaa2EthDev->TxFramesInFlightFreeCount == DPAA2_MAX_TX_FRAMES_IN_FLIGHT) {
     return;
   }
 
   Status = Dpaa2McNetworkInterfaceCheckTxCompletion (&Dpaa2EthDev->Dpaa2NetInterface,
-                                                    &QBmanTxBufferAddr);
+                                                    &QBmanTxBufferAddr,
+                                                    &TxFrameIndex);
   if (EFI_ERROR (Status)) {
     return;
   }
@@ -890,36 +918,28 @@ Dpaa2CheckTxCompletion (
   EfiAcquireLock (&Dpaa2EthDev->TxFramesInFlightLock);
 
   /*
-   * Find corresponding UEFI networking stack's Tx data buffer:
+   * The Tx frame cookie is the index of the frame in flight in the slab:
    */
-  for (ListNode = GetFirstNode (&Dpaa2EthDev->TxFramesInFlightList);
-       ListNode != &Dpaa2EthDev->TxFramesInFlightList;
-       ListNode = GetNextNode (&Dpaa2EthDev->TxFramesInFlightList, ListNode)) {
-    TxFrameInFlight = CR (ListNode, DPAA2_TX_FRAME_IN_FLIGHT, ListNode,
-                         DPAA2_TX_FRAME_IN_FLIGHT_SIGNATURE);
-    if (TxFrameInFlight->QBmanTxBufferAddr == QBmanTxBufferAddr) {
-      TxBufferFound = TRUE;
-      break;
-    }
-  }
-
-  if (!TxBufferFound) {
+  if (TxFrameIndex >= DPAA2_MAX_TX_FRAMES_IN_FLIGHT ||
+      Dpaa2EthDev->TxFramesInFlight[TxFrameIndex].UefiTxBuffer == NULL ||
+      Dpaa2EthDev->TxFramesInFlight[TxFrameIndex].QBmanTxBufferAddr != QBmanTxBufferAddr) {
     DPAA_ERROR_MSG ("Frame in flight not found for Ethernet device 0x%p (%a) \n",
                     Dpaa2EthDev, gWriopDpmacStrings[Dpaa2EthDev->WriopDpmac->Id]);
     EfiReleaseLock (&Dpaa2EthDev->TxFramesInFlightLock);
     return;
   }
 
-  ASSERT (TxFrameInFlight != NULL);
-  ASSERT (TxFrameInFlight->QBmanTxBufferAddr == QBmanTxBufferAddr);
-
+  TxFrameInFlight = &Dpaa2EthDev->TxFramesInFlight[TxFrameIndex];
   if (TxBuff != NULL) {
     *TxBuff = TxFrameInFlight->UefiTxBuffer;
   }
 
-  (VOID)RemoveEntryList (&TxFrameInFlight->ListNode);
+  TxFrameInFlight->UefiTxBuffer = NULL;
+  TxFrameInFlight->QBmanTxBufferAddr = 0;
+  ASSERT (Dpaa2EthDev->TxFramesInFlightFreeCount < DPAA2_MAX_TX_FRAMES_IN_FLIGHT);
+  Dpaa2EthDev->TxFramesInFlightFreeStack[Dpaa2EthDev->TxFramesInFlightFreeCount++] =
+    TxFrameIndex;
   EfiReleaseLock (&Dpaa2EthDev->TxFramesInFlightLock);
-  FreePool (TxFrameInFlight);
 }
 
 /**
@@ -1011,6 +1031,8 @@ Dpaa2SnpTransmit (
   DPAA2_ETHERNET_DEVICE *Dpaa2EthDev;
   WRIOP_DPMAC *WriopDpmac;
   DPAA2_TX_FRAME_IN_FLIGHT *TxFrameInFlight;
+  UINT32 TxFrameIndex;
+  UINT32 NumTxFramesInFlight;
   UINT64 QBmanTxBufferAddr;
 
   Status = Dpaa2SnpValidateParameters (Snp);
@@ -1065,12 +1087,30 @@ Dpaa2SnpTransmit (
       return EFI_BUFFER_TOO_SMALL;
   }
 
-  TxFrameInFlight = AllocateZeroPool (sizeof (*TxFrameInFlight));
-  if (TxFrameInFlight == NULL) {
-    DPAA_ERROR_MSG ("Could not allocate DPAA2 TxFrameInFlight object\n");
-    return EFI_OUT_OF_RESOURCES;
+  /*
+   * Reserve an entry in the Tx frames in flight slab:
+   */
+  EfiAcquireLock (&Dpaa2EthDev->TxFramesInFlightLock);
+  if (Dpaa2EthDev->TxFramesInFlightFreeCount == 0) {
+    EfiReleaseLock (&Dpaa2EthDev->TxFramesInFlightLock);
+    return EFI_NOT_READY;
+  }
+
+  TxFrameIndex =
+    Dpaa2EthDev->TxFramesInFlightFreeStack[--Dpaa2EthDev->TxFramesInFlightFreeCount];
+  TxFrameInFlight = &Dpaa2EthDev->TxFramesInFlight[TxFrameIndex];
+  ASSERT (TxFrameInFlight->UefiTxBuffer == NULL);
+  TxFrameInFlight->UefiTxBuffer = Data;
+  NumTxFramesInFlight = DPAA2_MAX_TX_FRAMES_IN_FLIGHT -
+                        Dpaa2EthDev->TxFramesInFlightFreeCount;
+  if (NumTxFramesInFlight > Dpaa2EthDev->TxFramesInFlightPeak) {
+    Dpaa2EthDev->TxFramesInFlightPeak = NumTxFramesInFlight;
   }
 
+  /*
+   * Keep the slab locked until the QBman buffer address is recorded, so that
+   * a Tx completion polled in between still finds the frame in flight:
+   */
   Status = Dpaa2McNetworkInterfaceTransmit (&Dpaa2EthDev->Dpaa2NetInterface,
                                            Dpaa2EthDev->WriopDpmac,
                                            HdrSize,
@@ -1079,23 +1119,22 @@ Dpaa2SnpTransmit (
                                            SrcAddr,
                                            DstAddr,
                                            Protocol,
+                                           TxFrameIndex,
                                            &QBmanTxBufferAddr);
+
   if (EFI_ERROR (Status)) {
     goto ErrorExit;
   }
 
-  TxFrameInFlight->Signature = DPAA2_TX_FRAME_IN_FLIGHT_SIGNATURE;
-  TxFrameInFlight->UefiTxBuffer = Data;
   TxFrameInFlight->QBmanTxBufferAddr = QBmanTxBufferAddr;
-  InitializeListHead (&TxFrameInFlight->ListNode);
-  EfiAcquireLock (&Dpaa2EthDev->TxFramesInFlightLock);
-  InsertTailList (&Dpaa2EthDev->TxFramesInFlightList, &TxFrameInFlight->ListNode);
   EfiReleaseLock (&Dpaa2EthDev->TxFramesInFlightLock);
-
   return EFI_SUCCESS;
 
 ErrorExit:
-  FreePool (TxFrameInFlight);
+  TxFrameInFlight->UefiTxBuffer = NULL;
+  Dpaa2EthDev->TxFramesInFlightFreeStack[Dpaa2EthDev->TxFramesInFlightFreeCount++] =
+    TxFrameIndex;
+  EfiReleaseLock (&Dpaa2EthDev->TxFramesInFlightLock);
   return Status;
 }
 
@@ -1181,6 +1220,170 @@ Dpaa2SnpReceive (
   return EFI_SUCCESS;
  }
 
+/**
+   Rx loan protocol Receive () function
+
+   @param RxLoan    A pointer to the DPAA2_RX_LOAN_PROTOCOL instance.
+
+   @retval EFI_SUCCESS, on success
+   @retval error code, on failure
+ **/
+STATIC
+EFI_STATUS
+EFIAPI
+Dpaa2RxLoanReceive (
+  IN        DPAA2_RX_LOAN_PROTOCOL        *RxLoan,
+  OUT       VOID                          **Frame,
+  OUT       UINTN                         *FrameSize,
+  OUT       UINT64                        *LoanId
+  )
+{
+  DPAA2_ETHERNET_DEVICE *Dpaa2EthDev;
+
+  if (RxLoan == NULL || Frame == NULL || FrameSize == NULL || LoanId == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Dpaa2EthDev = RX_LOAN_TO_DPAA2_DEV (RxLoan);
+  if (Dpaa2EthDev->SnpMode.State != EfiSimpleNetworkInitialized) {
+    return EFI_NOT_STARTED;
+  }
+
+  return Dpaa2McNetworkInterfaceReceiveLoan (&Dpaa2EthDev->Dpaa2NetInterface,
+                                             Frame,
+                                             FrameSize,
+                                             LoanId);
+}
+
+/**
+   Rx loan protocol Release () function
+
+   @param RxLoan    A pointer to the DPAA2_RX_LOAN_PROTOCOL instance.
+   @param LoanId    Loan ID returned by Dpaa2RxLoanReceive ()
+
+   @retval EFI_SUCCESS, on success
+   @retval error code, on failure
+ **/
+STATIC
+EFI_STATUS
+EFIAPI
+Dpaa2RxLoanRelease (
+  IN        DPAA2_RX_LOAN_PROTOCOL        *RxLoan,
+  IN        UINT64                        LoanId
+  )
+{
+  DPAA2_ETHERNET_DEVICE *Dpaa2EthDev;
+
+  if (RxLoan == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Dpaa2EthDev = RX_LOAN_TO_DPAA2_DEV (RxLoan);
+  return Dpaa2McNetworkInterfaceReturnLoan (&Dpaa2EthDev->Dpaa2NetInterface, LoanId);
+}
+
+/**
+   Packet trace protocol GetRecords () function
+
+   @param PacketTrace A pointer to the DPAA2_PACKET_TRACE_PROTOCOL instance.
+   @param Records     Array where the records are to be copied
+   @param NumRecords  On input, size of Records. On output, records copied.
+
+   @retval EFI_SUCCESS, on success
+   @retval error code, on failure
+ **/
+STATIC
+EFI_STATUS
+EFIAPI
+Dpaa2PacketTraceGetRecords (
+  IN        DPAA2_PACKET_TRACE_PROTOCOL   *PacketTrace,
+  OUT       DPAA2_PACKET_TRACE_RECORD     *Records,
+  IN OUT    UINT32                        *NumRecords
+  )
+{
+  if (PacketTrace == NULL || NumRecords == NULL ||
+      (Records == NULL && *NumRecords != 0)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Dpaa2McPacketTraceGetRecords (Records, NumRecords);
+  return EFI_SUCCESS;
+}
+
+/**
+   Packet trace protocol Dump () function
+
+   Prints one line per record: sequence number, time since the oldest
+   record, direction, frame length, QBman buffer address, then the
+   Ethernet header and the first payload bytes.
+
+   @param PacketTrace A pointer to the DPAA2_PACKET_TRACE_PROTOCOL instance.
+
+   @retval EFI_SUCCESS, on success
+   @retval error code, on failure
+ **/
+STATIC
+EFI_STATUS
+EFIAPI
+Dpaa2PacketTraceDump (
+  IN        DPAA2_PACKET_TRACE_PROTOCOL   *PacketTrace
+  )
+{
+  STATIC CONST CHAR8 *CONST DirectionStrings[] = { "??", "Rx", "Tx", "Tc" };
+  DPAA2_PACKET_TRACE_RECORD *Records;
+  DPAA2_PACKET_TRACE_RECORD *Record;
+  UINT32 NumRecords;
+  UINT32 DataSize;
+  UINT32 I;
+  UINT32 J;
+  UINT8 *Data;
+
+  if (PacketTrace == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  /*
+   * Take a copy first, so that the ring keeps up while we print:
+   */
+  NumRecords = DPAA2_PACKET_TRACE_RING_SIZE;
+  Records = AllocatePool (NumRecords * sizeof (DPAA2_PACKET_TRACE_RECORD));
+  if (Records == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  Dpaa2McPacketTraceGetRecords (Records, &NumRecords);
+
+  AsciiPrint ("DPAA2 packet trace: %u records\n", NumRecords);
+  for (I = 0; I < NumRecords; I++) {
+    Record = &Records[I];
+    AsciiPrint ("%8u %10lu us %a %4u 0x%011lx",
+                Record->Sequence,
+                DivU64x32 (GetTimeInNanoSecond (Record->Timestamp - Records[0].Timestamp), 1000),
+                DirectionStrings[Record->Direction & 0x3],
+                Record->Length,
+                Record->FrameBufferAddr);
+
+    if (Record->Direction != DPAA2_PACKET_TRACE_TX_CONFIRM &&
+        Record->Length >= sizeof (ETHER_HEAD)) {
+      Data = Record->Data;
+      AsciiPrint (" %02x:%02x:%02x:%02x:%02x:%02x > %02x:%02x:%02x:%02x:%02x:%02x %04x",
+                  Data[6], Data[7], Data[8], Data[9], Data[10], Data[11],
+                  Data[0], Data[1], Data[2], Data[3], Data[4], Data[5],
+                  (Data[12] << 8) | Data[13]);
+
+      DataSize = MIN (Record->Length, DPAA2_PACKET_TRACE_DATA_SIZE);
+      for (J = sizeof (ETHER_HEAD); J < DataSize; J++) {
+        AsciiPrint ("%a%02x", (J - sizeof (ETHER_HEAD)) % 4 == 0 ? " " : "", Data[J]);
+      }
+    }
+
+    AsciiPrint ("\n");
+  }
+
+  FreePool (Records);
+  return EFI_SUCCESS;
+}
+
 STATIC
 EFI_STATUS
 EFIAPI
@@ -1207,7 +1410,7 @@ CreateDpaa2EthernetDevice (
   Dpaa2EthDev->Snp.Mode = &Dpaa2EthDev->SnpMode;
   Dpaa2EthDev->WriopDpmac = Dpmac;
   InitializeListHead (&Dpaa2EthDev->ListNode);
-  InitializeListHead (&Dpaa2EthDev->TxFramesInFlightList);
+  Dpaa2ResetTxFramesInFlight (Dpaa2EthDev);
 
   /*
    * Set MAC address for the DPAA2 Ethernet device:
@@ -1248,6 +1451,7 @@ CreateDpaa2EthernetDevice (
                   &Dpaa2EthDev->ControllerHandle,
                   &gEfiSimpleNetworkProtocolGuid, &Dpaa2EthDev->Snp,
                   &gEfiDevicePathProtocolGuid, &Dpaa2EthDev->DevicePath,
+                  &gDpaa2RxLoanProtocolGuid, &Dpaa2EthDev->RxLoan,
                   NULL
                   );
   if (EFI_ERROR (Status)) {
@@ -1285,6 +1489,7 @@ DestroyDpaa2EthernetDevice (
                    Dpaa2EthDev->ControllerHandle,
                    &gEfiSimpleNetworkProtocolGuid, &Dpaa2EthDev->Snp,
                    &gEfiDevicePathProtocolGuid, &Dpaa2EthDev->DevicePath,
+                   &gDpaa2RxLoanProtocolGuid, &Dpaa2EthDev->RxLoan,
                    NULL
                    );
 
@@ -1295,7 +1500,7 @@ DestroyDpaa2EthernetDevice (
   }
 
   ASSERT (!Dpaa2EthDev->Dpaa2NetInterface.CreatedInMc);
-  ASSERT (IsListEmpty (&Dpaa2EthDev->TxFramesInFlightList));
+  ASSERT (Dpaa2EthDev->TxFramesInFlightFreeCount == DPAA2_MAX_TX_FRAMES_IN_FLIGHT);
   FreePool (Dpaa2EthDev);
 }
 
@@ -1435,6 +1640,12 @@ Dpaa2EthernetUnload (
   ASSERT (IsListEmpty (&gDpaa2Driver.Dpaa2EthernetDevicesList));
   InitializeListHead (&gDpaa2Driver.DpmacsList);
 
+  if (gDpaaDebugFlags & DPAA_DEBUG_TRACE_NET_PACKETS) {
+    gBS->UninstallProtocolInterface (ImageHandle,
+                                     &gDpaa2PacketTraceProtocolGuid,
+                                     &gDpaa2Driver.PacketTrace);
+  }
+
   Status = gBS->CloseEvent (gDpaa2Driver.ExitBootServicesEvent);
   if (EFI_ERROR (Status)) {
     DPAA_ERROR_MSG ("Failed to close UEFI event x0x%p (error %u)\n",
@@ -1543,6 +1754,22 @@ Dpaa2EthernetInitialize (
     goto ErrorExitCleanupDpaa2EthDevices;
   }
 
+  /*
+   * Frames are traced to an in-memory ring, which is dumped on demand
+   * through this protocol:
+   */
+  if (gDpaaDebugFlags & DPAA_DEBUG_TRACE_NET_PACKETS) {
+    gDpaa2Driver.PacketTrace.TimestampFrequency = GetPerformanceCounterProperties (NULL, NULL);
+    Status = gBS->InstallMultipleProtocolInterfaces (
+                    &ImageHandle,
+                    &gDpaa2PacketTraceProtocolGuid, &gDpaa2Driver.PacketTrace,
+                    NULL
+                    );
+    if (EFI_ERROR (Status)) {
+      DPAA_WARN_MSG ("Failed to install packet trace protocol (error %u)\n", Status);
+    }
+  }
+
   return EFI_SUCCESS;
 
 ErrorExitCleanupDpaa2EthDevices:
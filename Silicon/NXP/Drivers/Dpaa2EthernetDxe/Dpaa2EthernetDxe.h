@@ -20,10 +20,34 @@
 #include <Library/Dpaa2EthernetMacLib.h>
 #include <Library/Dpaa2ManagementComplexLib.h>
 #include <Library/UefiLib.h>
+#include <Protocol/Dpaa2PacketTrace.h>
+#include <Protocol/Dpaa2RxLoan.h>
 #include <Protocol/SimpleNetwork.h>
 
 #define DPAA2_ETHERNET_DRIVER_VERSION   0x1
 
+/**
+ * Maximum number of Tx frames that can be in flight at the same time
+ * for a DPAA2 Ethernet device (size of the Tx frames in flight slab)
+ */
+#define DPAA2_MAX_TX_FRAMES_IN_FLIGHT   64
+
+/**
+ * Information kept for a Tx frame that is in flight
+ */
+typedef struct _DPAA2_TX_FRAME_IN_FLIGHT {
+  /**
+   * Pointer to the UEFI networking stack's Tx buffer associated with the frame
+   * (NULL if this slot of the slab is free)
+   */
+  VOID *UefiTxBuffer;
+
+  /**
+   * Address of QBMAN buffer ssociated with the frame
+   */
+  UINT64 QBmanTxBufferAddr;
+} DPAA2_TX_FRAME_IN_FLIGHT;
+
 /**
  * DPAA2 Ethernet Device Path
  */
@@ -67,6 +91,11 @@ typedef struct _DPAA2_ETHERNET_DEVICE {
    */
   DPAA2_DEVICE_PATH DevicePath;
 
+  /**
+   * Rx buffer loan protocol instance
+   */
+  DPAA2_RX_LOAN_PROTOCOL RxLoan;
+
   /**
    * Pointer to corresponding WRIOP DPMAC
    */
@@ -90,42 +119,32 @@ typedef struct _DPAA2_ETHERNET_DEVICE {
   LIST_ENTRY ListNode;
 
   /**
-   * Head of the linked list of Tx frames in flight
+   * Slab of Tx frames in flight. The index of an entry is passed to the
+   * hardware along with the frame, and handed back with its Tx completion.
    */
-  LIST_ENTRY TxFramesInFlightList;
+  DPAA2_TX_FRAME_IN_FLIGHT TxFramesInFlight[DPAA2_MAX_TX_FRAMES_IN_FLIGHT];
 
   /**
-   * TPL-based lock to serialize access to TxFramesInFlightList
+   * Stack of indices of free entries in TxFramesInFlight
    */
-  EFI_LOCK TxFramesInFlightLock;
-
-} DPAA2_ETHERNET_DEVICE;
+  UINT32 TxFramesInFlightFreeStack[DPAA2_MAX_TX_FRAMES_IN_FLIGHT];
 
-/**
- * Information kept for a Tx frame that is in flight
- */
-typedef struct _DPAA2_TX_FRAME_IN_FLIGHT {
   /**
-   * Signature for run-time type checking
+   * Number of entries in TxFramesInFlightFreeStack
    */
-  UINT32 Signature;
-# define DPAA2_TX_FRAME_IN_FLIGHT_SIGNATURE SIGNATURE_32('D', 'P', 'T', 'X')
+  UINT32 TxFramesInFlightFreeCount;
 
   /**
-   * Pointer to the UEFI networking stack's Tx buffer associated with the frame
+   * Highest number of Tx frames in flight seen at the same time
    */
-  VOID *UefiTxBuffer;
+  UINT32 TxFramesInFlightPeak;
 
   /**
-   * Address of QBMAN buffer ssociated with the frame
+   * TPL-based lock to serialize access to the Tx frames in flight slab
    */
-  UINT64 QBmanTxBufferAddr;
+  EFI_LOCK TxFramesInFlightLock;
 
-  /**
-   * Node in the list of Tx frames in flight for the corresponding Ethernet device
-   */
-  LIST_ENTRY ListNode;
-} DPAA2_TX_FRAME_IN_FLIGHT;
+} DPAA2_ETHERNET_DEVICE;
 
 /**
  * DPAA2 Ethernet driver global control block
@@ -151,6 +170,12 @@ typedef struct _DPAA2_ETHERNET_DRIVER {
    */
   EFI_STATUS McStatus;
 
+  /**
+   * Packet trace protocol, installed on the driver image handle if
+   * DPAA_DEBUG_TRACE_NET_PACKETS is set
+   */
+  DPAA2_PACKET_TRACE_PROTOCOL PacketTrace;
+
 } DPAA2_ETHERNET_DRIVER;
 
 STATIC
@@ -279,11 +304,48 @@ Dpaa2SnpReceive (
   OUT       UINT16 *Protocol              OPTIONAL
   );
 
+STATIC
+EFI_STATUS
+EFIAPI
+Dpaa2RxLoanReceive (
+  IN        DPAA2_RX_LOAN_PROTOCOL        *RxLoan,
+  OUT       VOID                          **Frame,
+  OUT       UINTN                         *FrameSize,
+  OUT       UINT64                        *LoanId
+  );
+
+STATIC
+EFI_STATUS
+EFIAPI
+Dpaa2RxLoanRelease (
+  IN        DPAA2_RX_LOAN_PROTOCOL        *RxLoan,
+  IN        UINT64                        LoanId
+  );
+
+STATIC
+EFI_STATUS
+EFIAPI
+Dpaa2PacketTraceGetRecords (
+  IN        DPAA2_PACKET_TRACE_PROTOCOL   *PacketTrace,
+  OUT       DPAA2_PACKET_TRACE_RECORD     *Records,
+  IN OUT    UINT32                        *NumRecords
+  );
+
+STATIC
+EFI_STATUS
+EFIAPI
+Dpaa2PacketTraceDump (
+  IN        DPAA2_PACKET_TRACE_PROTOCOL   *PacketTrace
+  );
+
 extern DPAA2_PHY_MDIO_BUS gDpaa2MdioBuses[];
 extern VOID ProbeDpaaLanes (VOID *Arg);
 
 #define SNP_TO_DPAA2_DEV(_SnpPtr) \
         CR(_SnpPtr, DPAA2_ETHERNET_DEVICE, Snp, DPAA2_ETHERNET_DEVICE_SIGNATURE)
 
+#define RX_LOAN_TO_DPAA2_DEV(_RxLoanPtr) \
+        CR(_RxLoanPtr, DPAA2_ETHERNET_DEVICE, RxLoan, DPAA2_ETHERNET_DEVICE_SIGNATURE)
+
 #endif /* __DPAA2_ETHERTNET_DXE_H__ */
 
@@ -262,6 +262,18 @@ FspiTransaction (
     DEBUG ((DEBUG_ERROR, "Error in Parsing SPI request\n"));
     return Status;
   }
+
+  // Flash reads are served from the AMBA window while boot services are up.
+  // The window is not mapped for runtime, where the IP command path is used.
+  if ((Request.Type == SPI_REQUEST_WRITE_THEN_READ) && Request.HasAddress &&
+      FixedPcdGetBool (PcdFlexSpiAhbReadEnable) && !EfiAtRuntime ()) {
+    Status = AhbReadTransaction (Fspi, &Request);
+    if (Status != EFI_UNSUPPORTED) {
+      return Status;
+    }
+  }
+
+  FspiWriteLut (Fspi, Request.LutId, Request.Lut);
   ArmInstructionSynchronizationBarrier ();
   ArmDataSynchronizationBarrier ();
 
@@ -80,6 +80,7 @@
 #define LUT_PAD_4             2
 #define LUT_PAD_8             3
 
+#define SEQ_ID_AHB_READ      (0) // LUT entry used for AHB (memory mapped) reads
 #define SEQ_ID_IP_MODE       (1) // LUT entry to use
 
 /* Module Configuration */
@@ -105,6 +106,8 @@
 #define FLSHCR0_FLSHSZ_MASK    0x7FFFFF // Flash Size in KByte.
 #define FLSHCR1_WA             BIT10 // Word Addressable.
 #define FLSHCR1_CAS_MASK       (BIT11|BIT12|BIT13|BIT14) // Column Address Size.
+#define FLSHCR2_ARDSEQID_MASK  0x1F // Sequence Index for AHB Read triggered Command in LUT.
+#define FLSHCR2_ARDSEQNUM_MASK (BIT5|BIT6|BIT7) // Sequence Number for AHB Read triggered Command in LUT.
 
 #define AHBCR_APAREN           BIT0 // Parallel mode enabled for AHB triggered Command (both read and write).
 #define AHBCR_PREFETCHEN       BIT5 // AHB Read Prefetch Enable.
@@ -197,6 +200,14 @@ typedef struct {
   /// Lut Index (0..15) to use to complete this request
   ///
   UINT8              LutId;
+  ///
+  /// Lut sequence generated for this request
+  ///
+  UINT32             Lut[4];
+  ///
+  /// Request sends a flash address
+  ///
+  BOOLEAN            HasAddress;
 } FSPI_REQUEST;
 
 ///
@@ -401,6 +412,10 @@ typedef struct {
   /// if the Fspi controller is runtime, then VirtualNotifyEvent
   ///
   EFI_EVENT                          Event;
+  ///
+  /// Read sequence currently programmed in the AHB read LUT entry
+  ///
+  UINT32                             AhbLut[4];
 } FSPI_MASTER;
 
 /**
@@ -484,6 +499,44 @@ ReadTransaction (
   IN  FSPI_REQUEST     *Request
   );
 
+/**
+  This function performs the WRITE_THEN_READ operation on SPI flash through the
+  memory mapped AHB window of the FlexSPI controller.
+
+  The read sequence of the request is programmed in the AHB read LUT entry (only
+  when it differs from the one already there) and the data is copied out of the
+  AMBA window. The controller fetches the flash data through its AHB RX buffer
+  with prefetch enabled, so large reads run back to back on the SPI bus.
+
+  @param[in]   Fspi          FSPI_MASTER structure of a FSPI controller
+  @param[in]   Request       FSPI Request structure which provides the LUT sequence,
+                             Address to read from, number of data bytes to read and buffer
+                             in which data is to be read.
+
+  @retval EFI_UNSUPPORTED       The request falls outside the AMBA window of the chip select.
+  @retval EFI_DEVICE_ERROR      There was an SPI error during the transaction.
+  @retval EFI_SUCCESS           The transaction completed successfully.
+**/
+EFI_STATUS
+AhbReadTransaction (
+  IN  FSPI_MASTER      *Fspi,
+  IN  FSPI_REQUEST     *Request
+  );
+
+/**
+  Program a sequence in the LUT of the FlexSPI controller.
+
+  @param[in]   Fspi          FSPI_MASTER structure of a FSPI controller
+  @param[in]   LutId         Lut Index (0..15) to program
+  @param[in]   Lut           Lut sequence to program
+**/
+VOID
+FspiWriteLut (
+  IN  FSPI_MASTER      *Fspi,
+  IN  UINT8            LutId,
+  IN  UINT32           *Lut
+  );
+
 /**
   This function performs the WRITE_ONLY operation on SPI device.
 
@@ -523,8 +576,8 @@ WriteTransaction (
   if the request is supported by FSPI controller, FSPI request data structure is
   filled with values needed to complete the request.
 
-  Additionally the LUT table entries are also programmed, which will be required
-  to complete the request. Which LUT entry is used, is specified by Request parameter.
+  Additionally the LUT sequence which will be required to complete the request is
+  generated in Request. It is programmed in the LUT by the caller.
 
   @param[in]   Fspi                FSPI_MASTER structure of a FSPI controller
   @param[in]   RequestPacket          Incoming SPI request packet
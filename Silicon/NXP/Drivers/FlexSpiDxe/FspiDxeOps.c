@@ -15,6 +15,8 @@
   THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
   WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
 **/
+#include <Library/ArmLib.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/TimerLib.h>
 
@@ -460,6 +462,85 @@ ReadTransaction (
   return Status;
 }
 
+/**
+  This function performs the WRITE_THEN_READ operation on SPI flash through the
+  memory mapped AHB window of the FlexSPI controller.
+
+  The read sequence of the request is programmed in the AHB read LUT entry (only
+  when it differs from the one already there) and the data is copied out of the
+  AMBA window. The controller fetches the flash data through its AHB RX buffer
+  with prefetch enabled, so large reads run back to back on the SPI bus.
+
+  Any program or erase goes through WriteTransaction, which resets the controller
+  afterwards and so drops the stale AHB RX buffer contents.
+
+  @param[in]   Fspi          FSPI_MASTER structure of a FSPI controller
+  @param[in]   Request       FSPI Request structure which provides the LUT sequence,
+                             Address to read from, number of data bytes to read and buffer
+                             in which data is to be read.
+
+  @retval EFI_UNSUPPORTED       The request falls outside the AMBA window of the chip select.
+  @retval EFI_DEVICE_ERROR      There was an SPI error during the transaction.
+  @retval EFI_SUCCESS           The transaction completed successfully.
+**/
+EFI_STATUS
+AhbReadTransaction (
+  IN   FSPI_MASTER     *Fspi,
+  IN   FSPI_REQUEST    *Request
+  )
+{
+  FSPI_REGISTERS        *Regs;
+  UINT32                ChipSelect;
+  UINT64                ChipSelectOffset;
+  UINT64                FlashSize;
+
+  Regs = Fspi->Regs;
+  FlashSize = 0;
+
+  // Find the size of the AMBA window of the current chip select
+  for (ChipSelect = FSPI_CHIP_SELECT_0, ChipSelectOffset = 0;
+       ChipSelect < Fspi->NumChipselect;
+       ChipSelect++, ChipSelectOffset += FlashSize) {
+    FlashSize = Fspi->Read32 ( (UINTN)(&Regs->FlshA1Cr0 + ChipSelect)) & FLSHCR0_FLSHSZ_MASK;
+    FlashSize *= SIZE_1KB;
+    if (ChipSelectOffset == Fspi->CurCSOffset) {
+      break;
+    }
+  }
+
+  if ((ChipSelect == Fspi->NumChipselect) ||
+      (((UINT64)Request->Address + Request->Length) > FlashSize)) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (CompareMem (Fspi->AhbLut, Request->Lut, sizeof (Fspi->AhbLut)) != 0) {
+    // Wait while controller is busy
+    while (!(Fspi->Read32 ((UINTN)&Regs->Sts0) & STS0_ARBIDLE));
+
+    FspiWriteLut (Fspi, SEQ_ID_AHB_READ, Request->Lut);
+    CopyMem (Fspi->AhbLut, Request->Lut, sizeof (Fspi->AhbLut));
+
+    // Data prefetched with the previous read sequence is stale now.
+    // Invalidate the AHB buffer contents using software reset
+    Fspi->Or32 ( (UINTN)&Regs->Mcr0, MCR0_SWRESET);
+    while (Fspi->Read32 ( (UINTN)&Regs->Mcr0) & MCR0_SWRESET) {
+      MicroSecondDelay (1);
+    }
+  }
+
+  // Clear all flags before reading the AMBA window
+  Fspi->Or32 ((UINTN)&Regs->Intr, FLEXSPI_ERR_MASK);
+  ArmDataSynchronizationBarrier ();
+
+  CopyMem (
+    Request->Buffer,
+    (VOID *)(UINTN)(Fspi->AmbaBase + Fspi->CurCSOffset + Request->Address),
+    Request->Length
+    );
+
+  return CheckFlagRegister (Fspi);
+}
+
 /**
  Configure The Fspi controller at startup
  FlexSPI controller iniitialization sequence is as following:
@@ -551,6 +632,12 @@ FspiSetup (
               ( (UINTN)(&Regs->FlshA1Cr1 + Index)),
               ~(FLSHCR1_CAS_MASK | FLSHCR1_WA)
               );
+      // AHB reads run the single sequence in the AHB read LUT entry
+      Fspi->AndThenOr32 (
+              ( (UINTN)(&Regs->FlshA1Cr2 + Index)),
+              ~(FLSHCR2_ARDSEQID_MASK | FLSHCR2_ARDSEQNUM_MASK),
+              SEQ_ID_AHB_READ
+              );
     }
   } else {
     Status = EFI_DEVICE_ERROR;
@@ -168,8 +168,8 @@ CheckTransaction (
   if the request is supported by FSPI controller, FSPI request data structure is
   filled with values needed to complete the request.
 
-  Additionally the LUT table entries are also programmed, which will be required
-  to complete the request. Which LUT entry is used, is specified by Request parameter.
+  Additionally the LUT sequence which will be required to complete the request is
+  generated in Request. It is programmed in the LUT by the caller.
 
   @param[in]   Fspi                FSPI_MASTER structure of a FSPI controller
   @param[in]   RequestPacket          Incoming SPI request packet
@@ -199,9 +199,6 @@ ParseRequest (
   UINT8                             Instruction;
   UINT8                             Pins;
   UINT8                             Operand;
-  FSPI_REGISTERS                    *Regs;
-  UINT32                            *LutBase;
-  UINT32                            LutId;
   EFI_SPI_HC_PROTOCOL               *SpiHc;
   EFI_STATUS                        Status;
   UINT64                            TransferBytes;
@@ -223,8 +220,6 @@ ParseRequest (
 
   Status = EFI_SUCCESS;
   SpiHc = &Fspi->FspiHcProtocol;
-  Regs = Fspi->Regs;
-  LutBase = Regs->Lut;
   TransferBytes = 0;
   Request->Type = SPI_REQUEST_NONE;
   Pins = 0; // All SPI controllers must support single data bus width.
@@ -294,6 +289,7 @@ ParseRequest (
         Operand = SpiTransaction->Length << 3; // convert bytes to bits
         Lut[LutIndex++] = Instruction << LUT_INSTR0_SHIFT | Pins << LUT_PAD0_SHIFT | Operand << LUT_OPRND0_SHIFT;
         CopyMem (&Request->Address, SpiTransaction->WriteBuffer, SpiTransaction->Length);
+        Request->HasAddress = TRUE;
         Request->Type = SPI_REQUEST_WRITE_ONLY;
         break;
 
@@ -347,19 +343,44 @@ ParseRequest (
     Lut[LutIndex++] = 0x00;
   }
 
+  Request->Lut[0] = Lut[1] << LUT_OPRND1_SHIFT | Lut[0];
+  Request->Lut[1] = Lut[3] << LUT_OPRND1_SHIFT | Lut[2];
+  Request->Lut[2] = Lut[5] << LUT_OPRND1_SHIFT | Lut[4];
+  Request->Lut[3] = Lut[7] << LUT_OPRND1_SHIFT | Lut[6];
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Program a sequence in the LUT of the FlexSPI controller.
+
+  @param[in]   Fspi          FSPI_MASTER structure of a FSPI controller
+  @param[in]   LutId         Lut Index (0..15) to program
+  @param[in]   Lut           Lut sequence to program
+**/
+VOID
+FspiWriteLut (
+  IN  FSPI_MASTER      *Fspi,
+  IN  UINT8            LutId,
+  IN  UINT32           *Lut
+  )
+{
+  FSPI_REGISTERS                    *Regs;
+  UINT32                            *LutBase;
+  UINT32                            Index;
+
+  Regs = Fspi->Regs;
+  LutBase = &Regs->Lut[LutId * 4];
+
   /* Unlock The LUT */
   Fspi->Write32 ( (UINTN)&Regs->LutKey, LUT_KEY);
   Fspi->Write32 ( (UINTN)&Regs->LutCr, LUTCR_UNLOCK);
 
-  LutId = Request->LutId * 4;
-  Fspi->Write32 ( (UINTN)&LutBase[LutId], Lut[1] << LUT_OPRND1_SHIFT | Lut[0]);
-  Fspi->Write32 ( (UINTN)&LutBase[LutId + 1], Lut[3] << LUT_OPRND1_SHIFT | Lut[2]);
-  Fspi->Write32 ( (UINTN)&LutBase[LutId + 2], Lut[5] << LUT_OPRND1_SHIFT | Lut[4]);
-  Fspi->Write32 ( (UINTN)&LutBase[LutId + 3], Lut[7] << LUT_OPRND1_SHIFT | Lut[6]);
+  for (Index = 0; Index < 4; Index++) {
+    Fspi->Write32 ( (UINTN)&LutBase[Index], Lut[Index]);
+  }
 
   /* Lock The LUT */
   Fspi->Write32 ( (UINTN)&Regs->LutKey, LUT_KEY);
   Fspi->Write32 ( (UINTN)&Regs->LutCr, LUTCR_LOCK);
-
-  return EFI_SUCCESS;
 }
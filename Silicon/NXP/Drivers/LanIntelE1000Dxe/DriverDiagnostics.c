@@ -1197,11 +1197,23 @@ Returns:
   PXE_CPB_RECEIVE CpbReceive;
   PXE_DB_RECEIVE  DbReceive;
   EFI_STATUS      Status;
-  UINT64          FreeTxBuffer[DEFAULT_TX_DESCRIPTORS];
+  UINT64          *FreeTxBuffer;
   UINT32          j;
   UINT32          i;
 
-  Status  = EFI_SUCCESS;
+  //
+  // The ring depth is a build option, keep its completion array off the stack.
+  //
+  Status = gBS->AllocatePool (
+                  EfiBootServicesData,
+                  DEFAULT_TX_DESCRIPTORS * sizeof (UINT64),
+                  (VOID **) &FreeTxBuffer
+                  );
+  if (EFI_ERROR (Status)) {
+    DEBUGPRINT (CRITICAL, ("AllocatePool error Status %X\n", Status));
+    return Status;
+  }
+
   j       = 0;
 
   while (j < PHY_LOOPBACK_ITERATIONS) {
@@ -1272,6 +1284,7 @@ Returns:
     gBS->FreePool ((VOID *) ((UINTN) CpbReceive.BufferAddr));
   }
 
+  gBS->FreePool (FreeTxBuffer);
   return Status;
 }
 
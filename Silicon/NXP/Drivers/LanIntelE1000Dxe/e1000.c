@@ -470,7 +470,9 @@ e1000_Transmit (
 
 Routine Description:
   Takes a command block pointer (cpb) and sends the frame.  Takes either one fragment or many
-  and places them onto the wire.  Cleanup of the send happens in the function UNDI_Status in DECODE.C
+  and places them onto the wire.  The frame is only queued: we return as soon as the tail
+  pointer has been advanced, and the hardware completion is reaped later by e1000_FreeTxBuffers
+  from the function UNDI_Status in DECODE.C
 
 Arguments:
   GigAdapter  - Pointer to the instance data
@@ -479,9 +481,9 @@ Arguments:
   opflags         - The operation flags, tells if there is any special sauce on this transmit
 
 Returns:
-  PXE_STATCODE_SUCCESS if the frame goes out,
-  PXE_STATCODE_DEVICE_FAILURE if it didn't
-  PXE_STATCODE_BUSY if they need to call again later.
+  PXE_STATCODE_SUCCESS if the frame has been queued to the hardware,
+  PXE_STATCODE_QUEUE_FULL if there are not enough free descriptors; completed buffers must
+  be reclaimed through GetStatus before calling again.
 
 --*/
 {
@@ -489,7 +491,9 @@ Returns:
   PXE_CPB_TRANSMIT            *TxBuffer;
   E1000_TRANSMIT_DESCRIPTOR   *TransmitDescriptor;
   UINT32                      i;
-  INT16                       WaitMsec;
+  UINT16                      FirstIndex;
+  UINT16                      DescriptorsNeeded;
+  UINT16                      DescriptorsUsed;
 
 /*  DEBUGPRINT(E1000, ("e1000_Transmit\n"));
   DEBUGPRINT(E1000, ("TCTL=%X\r\n", E1000_READ_REG(&GigAdapter->hw, E1000_TCTL)));
@@ -502,10 +506,30 @@ Returns:
   }
 */
 
+  //
+  // Make some short cut pointers so we don't have to worry about typecasting later.
+  // If the TX has fragments we will use the
+  // tx_tpr_f pointer, otherwise the tx_ptr_l (l is for linear)
+  //
+  TxBuffer  = (PXE_CPB_TRANSMIT *) (UINTN) cpb;
+  TxFrags   = (PXE_CPB_TRANSMIT_FRAGMENTS *) (UINTN) cpb;
+
+  DescriptorsNeeded = 1;
+  if (opflags & PXE_OPFLAGS_TRANSMIT_FRAGMENTED) {
+    DescriptorsNeeded = TxFrags->FragCnt;
+  }
+
+  //
+  // Descriptors in use always form the contiguous range [xmit_done_head, cur_tx_ind).
+  // One descriptor is always left unused: a completely full ring would move TDT onto
+  // a TDH the hardware has not advanced yet, and TDT == TDH reads as an empty ring.
+  //
+  DescriptorsUsed = (UINT16) ((GigAdapter->cur_tx_ind + DEFAULT_TX_DESCRIPTORS - GigAdapter->xmit_done_head) % DEFAULT_TX_DESCRIPTORS);
+
   //
   // Transmit buffers must be freed by the upper layer before we can transmit any more.
   //
-  if (GigAdapter->TxBufferUnmappedAddr[GigAdapter->cur_tx_ind] != 0) {
+  if (DescriptorsNeeded >= DEFAULT_TX_DESCRIPTORS - DescriptorsUsed) {
     DEBUGPRINT(CRITICAL, ("TX buffers have all been used! cur_tx=%d\n", GigAdapter->cur_tx_ind));
     for (i = 0; i < DEFAULT_TX_DESCRIPTORS; i++) {
       DEBUGPRINT(CRITICAL, ("%x ", GigAdapter->TxBufferUnmappedAddr[i]));
@@ -519,17 +543,10 @@ Returns:
     return PXE_STATCODE_QUEUE_FULL;
   }
 
-  //
-  // Make some short cut pointers so we don't have to worry about typecasting later.
-  // If the TX has fragments we will use the
-  // tx_tpr_f pointer, otherwise the tx_ptr_l (l is for linear)
-  //
-  TxBuffer  = (PXE_CPB_TRANSMIT *) (UINTN) cpb;
-  TxFrags   = (PXE_CPB_TRANSMIT_FRAGMENTS *) (UINTN) cpb;
-
   //
   // quicker pointer to the next available Tx descriptor to use.
   //
+  FirstIndex = GigAdapter->cur_tx_ind;
   TransmitDescriptor = &GigAdapter->tx_ring[GigAdapter->cur_tx_ind];
 
   //
@@ -557,9 +574,11 @@ Returns:
         TxFrags->FragDesc[i].FragLen,
         (UINTN*) &TransmitDescriptor->buffer_addr
         );
+      WriteBackInvalidateDataCacheRange ((VOID *)(UINTN)TransmitDescriptor->buffer_addr, (UINTN)TxFrags->FragDesc[i].FragLen);
 
-      TransmitDescriptor->lower.flags.length  = (UINT16) TxFrags->FragDesc[i].FragLen;
       TransmitDescriptor->lower.data = (E1000_TXD_CMD_IFCS | E1000_TXD_CMD_RS);
+      TransmitDescriptor->lower.flags.length  = (UINT16) TxFrags->FragDesc[i].FragLen;
+      TransmitDescriptor->upper.fields.status = 0;
 
       if (GigAdapter->VlanEnable) {
         DEBUGPRINT (VLAN, ("1: Setting VLAN tag = %d\n", GigAdapter->VlanTag));
@@ -595,6 +614,7 @@ Returns:
       );
 
     DEBUGPRINT(E1000, ("Packet buffer at %x\n", TransmitDescriptor->buffer_addr));
+    WriteBackInvalidateDataCacheRange ((VOID *)(UINTN)TransmitDescriptor->buffer_addr, (UINTN)(TxBuffer->DataLen + TxBuffer->MediaheaderLen));
 
     //
     // Set the proper bits to tell the chip that this is the last descriptor in the send,
@@ -641,44 +661,39 @@ Returns:
   }
 #endif
 
+  //
+  // Dump the descriptors we just filled into RAM so that E1000 picks up the clean copy.
+  // The packet buffers were already cleaned when they were mapped.
+  //
+  if (GigAdapter->cur_tx_ind > FirstIndex) {
+    WriteBackInvalidateDataCacheRange (
+      (VOID *)&GigAdapter->tx_ring[FirstIndex],
+      (UINTN)(sizeof (E1000_TRANSMIT_DESCRIPTOR) * (GigAdapter->cur_tx_ind - FirstIndex))
+      );
+  } else {
+    WriteBackInvalidateDataCacheRange (
+      (VOID *)&GigAdapter->tx_ring[FirstIndex],
+      (UINTN)(sizeof (E1000_TRANSMIT_DESCRIPTOR) * (DEFAULT_TX_DESCRIPTORS - FirstIndex))
+      );
+    if (GigAdapter->cur_tx_ind != 0) {
+      WriteBackInvalidateDataCacheRange (
+        (VOID *)GigAdapter->tx_ring,
+        (UINTN)(sizeof (E1000_TRANSMIT_DESCRIPTOR) * GigAdapter->cur_tx_ind)
+        );
+    }
+  }
+
   //
   // Turn on the blocking function so we don't get swapped out
   // Then move the Tail pointer so the HW knows to start processing the TX we just setup.
+  // We do not wait for the descriptor to complete; the buffer is handed back to the
+  // caller once the hardware sets DD and GetStatus reaps it.
   //
-  // Dump the packet as well as descriptor into RAM so that E1000 can pick the clean copy
-  // for this clean and invalidate cache, so that all the contents are actually written into RAM
-  WriteBackInvalidateDataCacheRange((VOID *)(UINTN)TransmitDescriptor->buffer_addr, (UINTN)(TxBuffer->DataLen + TxBuffer->MediaheaderLen));
-  WriteBackInvalidateDataCacheRange((VOID *)(UINTN)TransmitDescriptor, (UINTN)(sizeof(*TransmitDescriptor)));
   DEBUGWAIT(E1000);
   e1000_BlockIt (GigAdapter, TRUE);
   E1000_WRITE_REG (&GigAdapter->hw, E1000_TDT(0), GigAdapter->cur_tx_ind);
   e1000_BlockIt (GigAdapter, FALSE);
 
-  //
-  // If the opflags tells us to wait for the packet to hit the wire, we will wait.
-  //
-    WaitMsec = 1000;
-
-    while ((TransmitDescriptor->upper.fields.status & E1000_TXD_STAT_DD) == 0) {
-      // Invalidate cache always to ensure that descriptor is picked from RAM only by E1000
-      InvalidateDataCacheRange((VOID *)(UINTN)TransmitDescriptor, (UINTN)(sizeof(*TransmitDescriptor)));
-      DelayInMilliseconds (10);
-      WaitMsec -= 10;
-      if (WaitMsec <= 0) {
-        break;
-      }
-    }
-
-    //
-    // If we waited for a while, and it didn't finish then the HW must be bad.
-    //
-    if ((TransmitDescriptor->upper.fields.status & E1000_TXD_STAT_DD) == 0) {
-      DEBUGPRINT(CRITICAL, ("ERROR: Network device transmit failure\n"));
-      return PXE_STATCODE_DEVICE_FAILURE;
-    } else {
-      DEBUGPRINT(E1000, ("Transmit success\n"));
-    }
-
   return PXE_STATCODE_SUCCESS;
 };
 
@@ -1650,7 +1665,7 @@ Returns:
     //
     // Set the software tail pointer just behind head to give hardware the entire ring
     //
-    WriteBackInvalidateDataCacheRange((VOID *)(UINTN)&GigAdapter->rx_ring, (UINTN)(sizeof(E1000_RECEIVE_DESCRIPTOR) * DEFAULT_RX_DESCRIPTORS));
+    WriteBackInvalidateDataCacheRange((VOID *)(UINTN)GigAdapter->rx_ring, (UINTN)(sizeof(E1000_RECEIVE_DESCRIPTOR) * DEFAULT_RX_DESCRIPTORS));
     if (GigAdapter->cur_rx_ind == 0) {
       E1000_WRITE_REG (&GigAdapter->hw, E1000_RDT(0), DEFAULT_RX_DESCRIPTORS - 1);
     } else {
@@ -2142,7 +2157,16 @@ Returns:
     }
 
     TransmitDescriptor = &GigAdapter->tx_ring[GigAdapter->xmit_done_head];
-    if ((TransmitDescriptor->upper.fields.status & E1000_TXD_STAT_DD) != 0) {
+
+    //
+    // The hardware writes DD back to RAM behind the cache, so drop any stale line
+    // before looking at the status. With several descriptors per cache line a
+    // later write back from the transmit path may still clobber a DD the hardware
+    // already wrote, so a descriptor the head pointer has moved past is done too.
+    //
+    InvalidateDataCacheRange ((VOID *)TransmitDescriptor, sizeof (*TransmitDescriptor));
+    if ((TransmitDescriptor->upper.fields.status & E1000_TXD_STAT_DD) != 0 ||
+        (Tdh != GigAdapter->xmit_done_head && GigAdapter->TxBufferUnmappedAddr[GigAdapter->xmit_done_head] != 0)) {
 
       if (GigAdapter->TxBufferUnmappedAddr[GigAdapter->xmit_done_head] == 0) {
         DEBUGPRINT(CRITICAL, ("ERROR: TX buffer complete without being marked used!\n"));
@@ -367,8 +367,36 @@ typedef struct e1000_rx_desc E1000_RECEIVE_DESCRIPTOR;
 //
 #define RX_BUFFER_SIZE 2048
 
-#define DEFAULT_RX_DESCRIPTORS 8
-#define DEFAULT_TX_DESCRIPTORS 8
+//
+// Descriptor ring depth. A deep TX ring lets the transmit path return as soon
+// as the tail doorbell is rung; completions are reaped from UNDI GetStatus.
+// Both may be overridden through the C compiler flags of this module in the
+// platform DSC (build -D only defines DSC macros, not C ones), e.g.:
+//
+//   Silicon/NXP/Drivers/LanIntelE1000Dxe/LanIntelE1000Dxe.inf {
+//     <BuildOptions>
+//       *_*_*_CC_FLAGS = -DDEFAULT_TX_DESCRIPTORS=512
+//   }
+//
+// Each must be a non-zero multiple of 8, so the ring length stays 128 byte
+// aligned, and at most 32768, so the UINT16 ring index arithmetic of
+// e1000_Transmit does not overflow.
+//
+#ifndef DEFAULT_RX_DESCRIPTORS
+#define DEFAULT_RX_DESCRIPTORS 256
+#endif
+#ifndef DEFAULT_TX_DESCRIPTORS
+#define DEFAULT_TX_DESCRIPTORS 256
+#endif
+
+#if (DEFAULT_RX_DESCRIPTORS == 0) || ((DEFAULT_RX_DESCRIPTORS % 8) != 0) || \
+    (DEFAULT_RX_DESCRIPTORS > 32768)
+#error "DEFAULT_RX_DESCRIPTORS must be a non-zero multiple of 8, at most 32768"
+#endif
+#if (DEFAULT_TX_DESCRIPTORS == 0) || ((DEFAULT_TX_DESCRIPTORS % 8) != 0) || \
+    (DEFAULT_TX_DESCRIPTORS > 32768)
+#error "DEFAULT_TX_DESCRIPTORS must be a non-zero multiple of 8, at most 32768"
+#endif
 
 //
 // Macro to conver byte memory requirement into pages
@@ -16,6 +16,8 @@
 
 **/
 
+#include <Bitops.h>
+#include <Library/BaseMemoryLib.h>
 #include <Library/DebugLib.h>
 #include <Library/NorFlashLib.h>
 
@@ -59,10 +61,6 @@ NorFlashBlockIoReadBlocks (
   EFI_STATUS                  Status;
   EFI_BLOCK_IO_MEDIA          *Media;
   UINTN                       NumBlocks;
-  UINT8                       *ReadBuffer;
-  UINTN                       BlockCount;
-  UINTN                       BlockSizeInBytes;
-  EFI_LBA                     CurrentBlock;
 
   Status = EFI_SUCCESS;
 
@@ -114,26 +112,10 @@ NorFlashBlockIoReadBlocks (
                 __FUNCTION__, Lba, NumBlocks, Media->LastBlock));
     Status = EFI_INVALID_PARAMETER;
   } else {
-    BlockSizeInBytes = Instance->Media.BlockSize;
-
-    /* Because the target *Buffer is a pointer to VOID,
-     * we must put all the data into a pointer
-     * to a proper data type, so use *ReadBuffer */
-    ReadBuffer = (UINT8 *)Buffer;
-
-    CurrentBlock = Lba;
-    // Read data block by Block
-    for (BlockCount = 0; BlockCount < NumBlocks; BlockCount++, CurrentBlock++,
-            ReadBuffer = ReadBuffer + BlockSizeInBytes) {
-      DEBUG ((DEBUG_BLKIO, "%a: Reading block #%d\n",
-                  __FUNCTION__,(UINTN)CurrentBlock));
-
-      Status = NorFlashPlatformRead (Instance, CurrentBlock, (UINTN)0 ,
-                                   BlockSizeInBytes,ReadBuffer);
-      if (EFI_ERROR (Status)) {
-        break;
-      }
-    }
+    // Blocks are contiguous in the memory map, so read the whole range
+    // in one pass instead of resetting the device once per block
+    Status = NorFlashPlatformRead (Instance, Lba, (UINTN)0,
+                                   BufferSizeInBytes, (UINT8 *)Buffer);
   }
   DEBUG ((DEBUG_BLKIO,"%a: Exit Status = \"%r\".\n",__FUNCTION__,Status));
 
@@ -162,6 +144,11 @@ NorFlashBlockIoWriteBlocks (
   UINT32                       BlockCount;
   UINTN                        SectorAddress;
   UINT8                        *WriteBuffer;
+  UINT8                        *RunBuffer;
+  EFI_LBA                      RunLba;
+  UINTN                        RunBlocks;
+  UINTN                        Skipped;
+  UINTN                        Erased;
 
   Status = EFI_SUCCESS;
 
@@ -209,33 +196,79 @@ NorFlashBlockIoWriteBlocks (
     BlockSizeInBytes = Instance->Media.BlockSize;
 
     WriteBuffer = (UINT8 *)Buffer;
-
+    RunBuffer = WriteBuffer;
+    RunLba = Lba;
+    RunBlocks = 0;
+    Skipped = 0;
+    Erased = 0;
+
+    //
+    // Each block is compared with the flash before it is touched. Blocks
+    // that already hold the data are skipped, blocks that only need bits
+    // cleared are programmed without an erase, and the rest are erased.
+    // Consecutive blocks that need programming are collected into a run
+    // which is programmed as one stream of write buffer pages.
+    //
     CurrentBlock = Lba;
-    // Program data block by Block
-    for (BlockCount = 0; BlockCount < NumBlocks;
+    for (BlockCount = 0; BlockCount <= NumBlocks;
             BlockCount++, CurrentBlock++,
             WriteBuffer = (WriteBuffer + BlockSizeInBytes)) {
-      DEBUG ((DEBUG_BLKIO, "%a: Writing block #%d\n",
-                  __FUNCTION__,(UINTN)CurrentBlock));
-      // Erase the Block(Sector) to be written to
-      SectorAddress = GET_NOR_BLOCK_ADDRESS (
-                           Instance->RegionBaseAddress,
-                           CurrentBlock,
-                           Instance->Media.BlockSize
-                           );
-      Status = NorFlashPlatformEraseSector (Instance, (UINTN)SectorAddress);
-      if (EFI_ERROR (Status)) {
-        DEBUG ((DEBUG_ERROR, "%a: Failed to erase Target 0x%x (0x%x) \n",
-                   __FUNCTION__,SectorAddress, Status));
-        break;
+      if (BlockCount < NumBlocks) {
+        DEBUG ((DEBUG_BLKIO, "%a: Writing block #%d\n",
+                    __FUNCTION__,(UINTN)CurrentBlock));
+
+        Status = NorFlashPlatformRead (Instance, CurrentBlock, (UINTN)0,
+                                       BlockSizeInBytes, Instance->ShadowBuffer);
+        if (EFI_ERROR (Status)) {
+          break;
+        }
+
+        if (CompareMem (Instance->ShadowBuffer, WriteBuffer,
+                        BlockSizeInBytes) != 0) {
+          // Cached contents of the block are stale from now on
+          NorFlashReadCacheInvalidate (Instance, CurrentBlock);
+
+          if (TestBitSetClear (Instance->ShadowBuffer, WriteBuffer,
+                               BlockSizeInBytes, TRUE)) {
+            // Erase the Block(Sector) to be written to
+            SectorAddress = GET_NOR_BLOCK_ADDRESS (
+                                 Instance->RegionBaseAddress,
+                                 CurrentBlock,
+                                 Instance->Media.BlockSize
+                                 );
+            Status = NorFlashPlatformEraseSector (Instance, (UINTN)SectorAddress);
+            if (EFI_ERROR (Status)) {
+              DEBUG ((DEBUG_ERROR, "%a: Failed to erase Target 0x%x (0x%x) \n",
+                         __FUNCTION__,SectorAddress, Status));
+              break;
+            }
+            Erased++;
+          }
+
+          if (RunBlocks == 0) {
+            RunLba = CurrentBlock;
+            RunBuffer = WriteBuffer;
+          }
+          RunBlocks++;
+          continue;
+        }
+
+        Skipped++;
       }
-      // Program Block(Sector) to be written to
-      Status = NorFlashWrite (Instance, CurrentBlock, (UINTN)0,
-                     &BlockSizeInBytes, WriteBuffer);
-      if (EFI_ERROR (Status)) {
-        break;
+
+      // Program the pending run of Blocks(Sectors)
+      if (RunBlocks != 0) {
+        Status = NorFlashPlatformWriteBlocks (Instance, RunLba,
+                       RunBlocks * BlockSizeInBytes, RunBuffer);
+        if (EFI_ERROR (Status)) {
+          break;
+        }
+        RunBlocks = 0;
       }
     }
+
+    DEBUG ((DEBUG_BLKIO, "%a: %d blocks, %d unchanged, %d erased\n",
+                __FUNCTION__, NumBlocks, Skipped, Erased));
   }
   DEBUG ((DEBUG_BLKIO, "%a: Exit Status = \"%r\".\n",__FUNCTION__,Status));
   return Status;
@@ -0,0 +1,269 @@
+/** @NorFlashCache.c
+
+  Read cache for the NOR flash FVB.
+
+  Keeps recently read flash blocks in runtime memory so that the small,
+  scattered reads done by the variable services do not go to the IFC bus
+  each time. On a miss, the following blocks are read ahead.
+
+  Copyright 2020 NXP
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Library/NorFlashLib.h>
+#include <Library/UefiRuntimeLib.h>
+
+#include <NorFlash.h>
+#include "NorFlashDxe.h"
+
+/**
+  Allocate the read cache of a NOR flash instance.
+
+  The cache only covers blocks from Instance->StartLba to LastLba. Failing
+  to allocate it is not fatal, reads then go to the flash directly.
+
+  @param[in]  Instance    NOR flash instance
+  @param[in]  LastLba     Last block the cache may hold
+
+**/
+VOID
+NorFlashReadCacheInitialize (
+  IN NOR_FLASH_INSTANCE     *Instance,
+  IN EFI_LBA                LastLba
+  )
+{
+  NOR_FLASH_READ_CACHE      *Cache;
+  UINT32                    NumEntries;
+  UINT32                    ReadAhead;
+
+  NumEntries = FixedPcdGet32 (PcdNorFlashReadCacheBlocks);
+  if (NumEntries == 0 || Instance->ReadCache != NULL) {
+    return;
+  }
+
+  // Read-ahead must not evict the block which caused the miss
+  ReadAhead = MIN (FixedPcdGet32 (PcdNorFlashReadAheadBlocks), NumEntries - 1);
+
+  Cache = AllocateRuntimeZeroPool (sizeof (NOR_FLASH_READ_CACHE) +
+                                   NumEntries * sizeof (NOR_FLASH_CACHE_ENTRY));
+  if (Cache == NULL) {
+    return;
+  }
+
+  Cache->Data = AllocateRuntimePool (NumEntries * Instance->Media.BlockSize);
+  if (Cache->Data == NULL) {
+    DEBUG ((DEBUG_WARN, "%a: no memory for %d cached blocks\n",
+                        __FUNCTION__, NumEntries));
+    FreePool (Cache);
+    return;
+  }
+
+  Cache->Entries = (NOR_FLASH_CACHE_ENTRY *)(Cache + 1);
+  Cache->NumEntries = NumEntries;
+  Cache->ReadAhead = ReadAhead;
+  Cache->LastLba = LastLba;
+
+  Instance->ReadCache = Cache;
+}
+
+/**
+  Look up a block in the read cache.
+
+  @param[in]  Cache       Read cache
+  @param[in]  Lba         Block to look for
+
+  @retval     Cache entry holding the block, NULL if not cached
+
+**/
+STATIC
+NOR_FLASH_CACHE_ENTRY *
+NorFlashReadCacheLookup (
+  IN NOR_FLASH_READ_CACHE   *Cache,
+  IN EFI_LBA                Lba
+  )
+{
+  UINT32                    Index;
+
+  for (Index = 0; Index < Cache->NumEntries; Index++) {
+    if (Cache->Entries[Index].Valid && Cache->Entries[Index].Lba == Lba) {
+      return &Cache->Entries[Index];
+    }
+  }
+
+  return NULL;
+}
+
+/**
+  Read a block from flash into the least recently used cache entry.
+
+  @param[in]  Instance    NOR flash instance
+  @param[in]  Lba         Block to read
+
+  @retval     Cache entry now holding the block, NULL on read error
+
+**/
+STATIC
+NOR_FLASH_CACHE_ENTRY *
+NorFlashReadCacheFill (
+  IN NOR_FLASH_INSTANCE     *Instance,
+  IN EFI_LBA                Lba
+  )
+{
+  NOR_FLASH_READ_CACHE      *Cache;
+  NOR_FLASH_CACHE_ENTRY     *Entry;
+  UINT32                    Index;
+  EFI_STATUS                Status;
+
+  Cache = Instance->ReadCache;
+
+  // Pick a free entry, or else the least recently used one
+  Entry = &Cache->Entries[0];
+  for (Index = 0; Index < Cache->NumEntries; Index++) {
+    if (!Cache->Entries[Index].Valid) {
+      Entry = &Cache->Entries[Index];
+      break;
+    }
+    if (Cache->Entries[Index].LastUse < Entry->LastUse) {
+      Entry = &Cache->Entries[Index];
+    }
+  }
+
+  Entry->Valid = FALSE;
+  Status = NorFlashPlatformRead (Instance, Lba, 0, Instance->Media.BlockSize,
+             Cache->Data + (Entry - Cache->Entries) * Instance->Media.BlockSize);
+  if (EFI_ERROR (Status)) {
+    return NULL;
+  }
+
+  Entry->Lba = Lba;
+  Entry->LastUse = ++Cache->UseCount;
+  Entry->Valid = TRUE;
+
+  return Entry;
+}
+
+/**
+  Read from a block through the read cache.
+
+  The read must not span block boundaries.
+
+  @param[in]  Instance    NOR flash instance
+  @param[in]  Lba         Block to read from
+  @param[in]  Offset      Offset in the block
+  @param[in]  NumBytes    Number of bytes to read
+  @param[out] Buffer      Buffer receiving the data
+
+  @retval     EFI_SUCCESS on success, error from the flash read otherwise
+
+**/
+EFI_STATUS
+NorFlashReadCacheRead (
+  IN  NOR_FLASH_INSTANCE    *Instance,
+  IN  EFI_LBA               Lba,
+  IN  UINTN                 Offset,
+  IN  UINTN                 NumBytes,
+  OUT UINT8                 *Buffer
+  )
+{
+  NOR_FLASH_READ_CACHE      *Cache;
+  NOR_FLASH_CACHE_ENTRY     *Entry;
+  EFI_LBA                   Next;
+
+  Cache = Instance->ReadCache;
+  if (Cache == NULL || Lba < Instance->StartLba || Lba > Cache->LastLba) {
+    return NorFlashPlatformRead (Instance, Lba, Offset, NumBytes, Buffer);
+  }
+
+  Entry = NorFlashReadCacheLookup (Cache, Lba);
+  if (Entry != NULL) {
+    Cache->Hits++;
+    Entry->LastUse = ++Cache->UseCount;
+    CopyMem (Buffer, Cache->Data + (Entry - Cache->Entries) *
+             Instance->Media.BlockSize + Offset, NumBytes);
+    return EFI_SUCCESS;
+  }
+
+  Cache->Misses++;
+  Entry = NorFlashReadCacheFill (Instance, Lba);
+  if (Entry == NULL) {
+    return NorFlashPlatformRead (Instance, Lba, Offset, NumBytes, Buffer);
+  }
+
+  CopyMem (Buffer, Cache->Data + (Entry - Cache->Entries) *
+           Instance->Media.BlockSize + Offset, NumBytes);
+
+  // Scans walk the store forward, so fetch the next blocks as well
+  for (Next = Lba + 1; Next <= MIN (Lba + Cache->ReadAhead, Cache->LastLba); Next++) {
+    if (NorFlashReadCacheLookup (Cache, Next) == NULL) {
+      NorFlashReadCacheFill (Instance, Next);
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Drop a block from the read cache. Must be called before the block is
+  written or erased.
+
+  @param[in]  Instance    NOR flash instance
+  @param[in]  Lba         Block being modified
+
+**/
+VOID
+NorFlashReadCacheInvalidate (
+  IN NOR_FLASH_INSTANCE     *Instance,
+  IN EFI_LBA                Lba
+  )
+{
+  NOR_FLASH_READ_CACHE      *Cache;
+  NOR_FLASH_CACHE_ENTRY     *Entry;
+
+  Cache = Instance->ReadCache;
+  if (Cache == NULL) {
+    return;
+  }
+
+  Entry = NorFlashReadCacheLookup (Cache, Lba);
+  if (Entry != NULL) {
+    Entry->Valid = FALSE;
+  }
+}
+
+/**
+  Convert the read cache pointers for runtime use, and report the cache
+  statistics gathered during boot.
+
+  @param[in]  Instance    NOR flash instance
+
+**/
+VOID
+NorFlashReadCacheConvertPointers (
+  IN NOR_FLASH_INSTANCE     *Instance
+  )
+{
+  NOR_FLASH_READ_CACHE      *Cache;
+
+  Cache = Instance->ReadCache;
+  if (Cache == NULL) {
+    return;
+  }
+
+  DEBUG ((DEBUG_INFO, "NorFlash: read cache hits %ld, misses %ld\n",
+                      Cache->Hits, Cache->Misses));
+
+  EfiConvertPointer (0x0, (VOID **)&Cache->Entries);
+  EfiConvertPointer (0x0, (VOID **)&Cache->Data);
+  EfiConvertPointer (0x0, (VOID **)&Instance->ReadCache);
+}
@@ -68,6 +68,7 @@ NOR_FLASH_INSTANCE  mNorFlashInstanceTemplate = {
     .ParentHandle = NULL,
   },
   .ShadowBuffer = NULL,
+  .ReadCache = NULL,
   .DevicePath = {
     .Vendor = {
       .Header = {
@@ -223,6 +224,9 @@ NorFlashWrite (
     return EFI_DEVICE_ERROR;
   }
 
+  // Cached contents of the block are stale from now on
+  NorFlashReadCacheInvalidate (Instance, Lba);
+
   SectorAddress = GET_NOR_BLOCK_ADDRESS (
                          Instance->RegionBaseAddress,
                          Lba,
@@ -295,19 +299,17 @@ NorFlashWrite (
   }
   if (*NumBytes != BlockSize) {
     // Write the modified shadow buffer back to the NorFlash
-    Status = NorFlashPlatformWriteBuffer (
+    Status = NorFlashPlatformWriteBlocks (
                         Instance,
                         Lba,
-                        0,
-                        &BlockSize,
+                        BlockSize,
                         Instance->ShadowBuffer);
   } else {
     // Write the Buffer to an entire block in NorFlash
-    Status = NorFlashPlatformWriteBuffer (
+    Status = NorFlashPlatformWriteBlocks (
                         Instance,
                         Lba,
-                        0,
-                        &BlockSize,
+                        BlockSize,
                         Buffer);
   }
   if (EFI_ERROR (Status)) {
@@ -356,6 +358,7 @@ NorFlashVirtualNotifyEvent (
     if (mNorFlashInstances[Index]->ShadowBuffer != NULL) {
       EfiConvertPointer (0x0, (VOID **)&mNorFlashInstances[Index]->ShadowBuffer);
     }
+    NorFlashReadCacheConvertPointers (mNorFlashInstances[Index]);
   }
 
   return;
@@ -26,6 +26,26 @@
 
 #define INSTANCE_FROM_BLKIO_THIS(a)               CR(a, NOR_FLASH_INSTANCE, BlockIoProtocol, NOR_FLASH_SIGNATURE)
 
+typedef struct {
+  EFI_LBA                 Lba;
+  UINT64                  LastUse;
+  BOOLEAN                 Valid;
+} NOR_FLASH_CACHE_ENTRY;
+
+//
+// FVB read cache, one block of Data per entry
+//
+typedef struct {
+  UINT32                  NumEntries;
+  UINT32                  ReadAhead;
+  EFI_LBA                 LastLba;
+  UINT64                  UseCount;
+  UINT64                  Hits;
+  UINT64                  Misses;
+  NOR_FLASH_CACHE_ENTRY   *Entries;
+  UINT8                   *Data;
+} NOR_FLASH_READ_CACHE;
+
 EFI_STATUS
 EFIAPI
 NorFlashFvbInitialize (
@@ -143,4 +163,30 @@ NorFlashWrite (
   IN        UINT8                 *Buffer
 );
 
+VOID
+NorFlashReadCacheInitialize (
+  IN NOR_FLASH_INSTANCE     *Instance,
+  IN EFI_LBA                LastLba
+  );
+
+EFI_STATUS
+NorFlashReadCacheRead (
+  IN  NOR_FLASH_INSTANCE    *Instance,
+  IN  EFI_LBA               Lba,
+  IN  UINTN                 Offset,
+  IN  UINTN                 NumBytes,
+  OUT UINT8                 *Buffer
+  );
+
+VOID
+NorFlashReadCacheInvalidate (
+  IN NOR_FLASH_INSTANCE     *Instance,
+  IN EFI_LBA                Lba
+  );
+
+VOID
+NorFlashReadCacheConvertPointers (
+  IN NOR_FLASH_INSTANCE     *Instance
+  );
+
 #endif /* __NOR_FLASH_DXE_H__ */
@@ -449,7 +449,7 @@ FvbRead (
     *NumBytes = BlockSize-Offset;
   }
 
-  return NorFlashPlatformRead (Instance, Instance->StartLba + Lba,
+  return NorFlashReadCacheRead (Instance, Instance->StartLba + Lba,
           Offset, *NumBytes, Buffer);
 }
 
@@ -679,6 +679,7 @@ FvbEraseBlocks (
       // Erase it
       DEBUG ((DEBUG_BLKIO, "FvbEraseBlocks: Erasing Lba=%ld @ 0x%08x.\n",
                             Instance->StartLba + StartingLba, BlockAddress));
+      NorFlashReadCacheInvalidate (Instance, Instance->StartLba + StartingLba);
       Status = NorFlashPlatformEraseSector(Instance, BlockAddress);
       if (EFI_ERROR (Status)) {
         VA_END (Args);
@@ -735,6 +736,13 @@ NorFlashFvbInitialize (
   // Set the index of the first LBA for the FVB
   Instance->StartLba = (PcdGet64 (PcdFlashNvStorageVariableBase64) - Instance->RegionBaseAddress) / Instance->Media.BlockSize;
 
+  FvbNumLba = (PcdGet32 (PcdFlashNvStorageVariableSize) +
+               PcdGet32 (PcdFlashNvStorageFtwWorkingSize) +
+               PcdGet32 (PcdFlashNvStorageFtwSpareSize)) / Instance->Media.BlockSize;
+
+  // Only the variable store and FTW areas go through the read cache
+  NorFlashReadCacheInitialize (Instance, Instance->StartLba + FvbNumLba - 1);
+
   BootMode = GetBootModeHob ();
   if (BootMode == BOOT_WITH_DEFAULT_SETTINGS) {
     Status = EFI_INVALID_PARAMETER;
@@ -751,10 +759,6 @@ NorFlashFvbInitialize (
       __FUNCTION__));
 
     // Erase all the NorFlash that is reserved for variable storage
-    FvbNumLba = (PcdGet32 (PcdFlashNvStorageVariableSize) +
-                 PcdGet32 (PcdFlashNvStorageFtwWorkingSize) +
-                 PcdGet32 (PcdFlashNvStorageFtwSpareSize)) / Instance->Media.BlockSize;
-
     Status = FvbEraseBlocks (&Instance->FvbProtocol, (EFI_LBA)0, FvbNumLba, EFI_LBA_LIST_TERMINATOR);
     if (EFI_ERROR (Status)) {
       return Status;
@@ -16,23 +16,103 @@
 #include <Library/BaseMemoryLib.h>
 #include <Library/BaseMemoryLib/MemLibInternals.h>
 #include <Library/DebugLib.h>
+#include <Library/DrbgLib.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/SecureMonRngLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 
 #include <Protocol/Rng.h>
 
-#define MAX_RNG_BYTES           8   // max number of bytes in a returned rng
-#define NUMBER_SUPPORTED_ALGO   1   // max number of rng algorithms supported by driver
+#define MAX_RNG_BYTES           8   // max number of bytes returned by one secure call
+#define NUMBER_SUPPORTED_ALGO   4   // max number of rng algorithms supported by driver
 
-// Array of supported rng algorithms
+// Array of supported rng algorithms, the first one is the default
 EFI_RNG_ALGORITHM gSuppAlgoList[NUMBER_SUPPORTED_ALGO];
 
+// DRBG instances seeded from the hardware RNG, instantiated on first use
+STATIC DRBG_STATE mCtrDrbg;
+STATIC DRBG_STATE mHmacDrbg;
+STATIC DRBG_STATE mHashDrbg;
+
+/**
+ * Fills a buffer with raw random bytes from the hardware RNG, one secure
+ * call per MAX_RNG_BYTES. This is also the entropy source of the DRBGs.
+ *
+ * @param[in]   Context           Unused.
+ * @param[in]   Length            Number of bytes to return.
+ * @param[out]  Buffer            Buffer to fill.
+ *
+ * @retval EFI_SUCCESS            Buffer was filled.
+ * @retval Others                 The secure call failed.
+**/
+STATIC
+EFI_STATUS
+EFIAPI
+RngGetRawBytes (
+  IN  VOID   *Context,
+  IN  UINTN  Length,
+  OUT UINT8  *Buffer
+  )
+{
+  EFI_STATUS   Status;
+  UINT8        Value[MAX_RNG_BYTES];
+  UINTN        Copy;
+
+  Status = EFI_SUCCESS;
+
+  while (Length > 0) {
+    Status = getRawRng (MAX_RNG_BYTES, Value);
+    if (EFI_ERROR (Status)) {
+      break;
+    }
+    Copy = MIN (Length, MAX_RNG_BYTES);
+    CopyMem (Buffer, Value, Copy);
+    Buffer += Copy;
+    Length -= Copy;
+  }
+
+  ZeroMem (Value, sizeof (Value));
+  return Status;
+}
+
+/**
+ * Generates random bytes with a DRBG, instantiating it from the hardware
+ * RNG on first use.
+ *
+ * @param[in]   Drbg              The DRBG instance.
+ * @param[in]   Mechanism         The DRBG mechanism of the instance.
+ * @param[in]   Length            Number of bytes to return.
+ * @param[out]  Buffer            Buffer to fill.
+ *
+ * @retval EFI_SUCCESS            Buffer was filled.
+ * @retval Others                 The DRBG could not be seeded.
+**/
+STATIC
+EFI_STATUS
+RngGetDrbgBytes (
+  IN  DRBG_STATE       *Drbg,
+  IN  DRBG_MECHANISM   Mechanism,
+  IN  UINTN            Length,
+  OUT UINT8            *Buffer
+  )
+{
+  EFI_STATUS   Status;
+
+  if (!Drbg->Instantiated) {
+    Status = DrbgInstantiate (Drbg, Mechanism, RngGetRawBytes, NULL, NULL, 0);
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return DrbgGenerate (Drbg, NULL, 0, Length, Buffer);
+}
+
 /**
  * Retrieves a list of the supported RNG algorithms.
  *
- * Note: We only return the type EFI_RNG_ALGORITHM_RAW
- * and a size of EFI_GUID.
+ * Note: The SP800-90A CTR_DRBG (AES-256) is the default algorithm, followed
+ * by the HMAC and Hash DRBGs and EFI_RNG_ALGORITHM_RAW.
  *
  * @param[in]      This                  The instance of the EFI_RNG_PROTOCOL.
  * @param[in,out]  RNGAlgorithmListSize  The size of the RNG algorithm list.
@@ -76,8 +156,8 @@ GetInfo (
 }
 
 /**
- * Retrieves a random number of a given size using a Secure call to access
- * the hardware RNG.
+ * Retrieves a random number of a given size, either straight from the
+ * hardware RNG through Secure calls or from one of the DRBGs seeded by it.
  *
  * @param[in]   This              The instance of the RNG protocol.
  * @param[in]   RNGAlgorithm      The RNG algorthm to use to generate random
@@ -104,11 +184,16 @@ GetRNG (
 
   DEBUG ((DEBUG_INFO, "RNGValueLength (in bytes) %d\n", RNGValueLength));
 
-  if ((NULL != RNGValue) && (0 < RNGValueLength) &&
-      (MAX_RNG_BYTES >= RNGValueLength)) {
+  if ((NULL != RNGValue) && (0 < RNGValueLength)) {
     if ((NULL == RNGAlgorithm) ||
-        (CompareGuid (RNGAlgorithm, &gEfiRngAlgorithmRaw))) {
-      Status = getRawRng (RNGValueLength, RNGValue);
+        (CompareGuid (RNGAlgorithm, &gEfiRngAlgorithmSp80090Ctr256Guid))) {
+      Status = RngGetDrbgBytes (&mCtrDrbg, DrbgCtrAes256, RNGValueLength, RNGValue);
+    } else if (CompareGuid (RNGAlgorithm, &gEfiRngAlgorithmSp80090Hmac256Guid)) {
+      Status = RngGetDrbgBytes (&mHmacDrbg, DrbgHmacSha256, RNGValueLength, RNGValue);
+    } else if (CompareGuid (RNGAlgorithm, &gEfiRngAlgorithmSp80090Hash256Guid)) {
+      Status = RngGetDrbgBytes (&mHashDrbg, DrbgHashSha256, RNGValueLength, RNGValue);
+    } else if (CompareGuid (RNGAlgorithm, &gEfiRngAlgorithmRaw)) {
+      Status = RngGetRawBytes (NULL, RNGValueLength, RNGValue);
     } else {
       DEBUG ((DEBUG_ERROR, "Requested RNG algorithm is not supported\n"));
       Status = EFI_UNSUPPORTED;
@@ -151,7 +236,10 @@ RngDriverEntryPoint (
   // initialize the array of supported rng algorithms
   // Note: if you are going to add anything to this array, you
   //       must first increase its size
-  CopyGuid (gSuppAlgoList, &gEfiRngAlgorithmRaw);
+  CopyGuid (&gSuppAlgoList[0], &gEfiRngAlgorithmSp80090Ctr256Guid);
+  CopyGuid (&gSuppAlgoList[1], &gEfiRngAlgorithmSp80090Hmac256Guid);
+  CopyGuid (&gSuppAlgoList[2], &gEfiRngAlgorithmSp80090Hash256Guid);
+  CopyGuid (&gSuppAlgoList[3], &gEfiRngAlgorithmRaw);
 
   // install the Random Number Generator Architectural Protocol
   Status = gBS->InstallMultipleProtocolInterfaces (&ImageHandle,
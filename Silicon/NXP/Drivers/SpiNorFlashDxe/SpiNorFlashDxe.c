@@ -121,6 +121,95 @@ SpiNorFlashSupported (
   }
 }
 
+/**
+  Check whether a buffer only holds erased (0xFF) bytes.
+**/
+STATIC
+BOOLEAN
+IsBufferErased (
+  IN  UINT8   *Buffer,
+  IN  UINTN   NumBytes
+  )
+{
+  while (NumBytes--) {
+    if (*Buffer++ != 0xFF) {
+      return FALSE;
+    }
+  }
+
+  return TRUE;
+}
+
+/**
+  Program the pages of [Start, End) inside the erase block at BlockOffset.
+
+  ShadowBuffer holds the current contents of the range, Buffer the data
+  written at Offset. Without a preceding erase only the pages in which
+  Buffer differs from the flash are programmed. After an erase every page
+  that does not stay fully erased is programmed.
+**/
+STATIC
+EFI_STATUS
+SpiNorFlashWritePages (
+  IN  SPI_NOR_FLASH_CONTEXT   *Context,
+  IN  UINTN                   BlockOffset,
+  IN  UINTN                   Start,
+  IN  UINTN                   End,
+  IN  UINTN                   Alignment,
+  IN  UINTN                   Offset,
+  IN  UINTN                   NumBytes,
+  IN  UINT8                   *Buffer,
+  IN  BOOLEAN                 Erased
+  )
+{
+  EFI_STATUS                  Status;
+  UINT8                       *Source;
+  UINTN                       Page;
+  UINTN                       First;
+  UINTN                       Last;
+
+  for (Page = Start; Page < End; Page += Alignment) {
+    Source = (UINT8 *)Context->ShadowBuffer + Page;
+    // Part of the page covered by the data being written
+    First = MAX (Page, Offset);
+    Last = MIN (Page + Alignment, Offset + NumBytes);
+
+    if (Erased) {
+      if (First < Last) {
+        CopyMem ((UINT8 *)Context->ShadowBuffer + First, Buffer + (First - Offset), Last - First);
+      }
+      if (IsBufferErased (Source, Alignment)) {
+        continue;
+      }
+    } else {
+      if ((First >= Last) ||
+          (CompareMem ((UINT8 *)Context->ShadowBuffer + First, Buffer + (First - Offset), Last - First) == 0)) {
+        continue;
+      }
+      CopyMem ((UINT8 *)Context->ShadowBuffer + First, Buffer + (First - Offset), Last - First);
+    }
+
+    Status = WriteFlashData (
+               Context->SpiIo,
+               Context->SpiNorParams,
+               BlockOffset + Page,
+               Alignment,
+               Source
+               );
+    if (EFI_ERROR (Status)) {
+      DEBUG ((
+        DEBUG_ERROR, "%a: ERROR - Failed to Write @ Offset 0x%x Status %r\n",
+        __FUNCTION__,
+        BlockOffset + Page,
+        Status
+        ));
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
 /*
    Write a full or portion of a block.
    It must not span block boundaries; that is,
@@ -137,15 +226,19 @@ SpiNorFlashWrite (
 {
   EFI_STATUS                          Status;
   UINTN                               BlockSize;
-  BOOLEAN                             DoErase;
-  UINT8*                              Source;
+  UINTN                               BlockOffset;
   UINTN                               Alignment;
-  UINTN                               IntBytes; // Intermediate Bytes needed to copy for alignment
+  UINTN                               Start;
+  UINTN                               End;
+  UINTN                               EraseSize;
+  UINTN                               Sector;
+  UINTN                               First;
+  UINTN                               Last;
+  UINT8                               EraseIndex;
   SPI_NOR_PARAMS                      *SpiNorParams;
   SFDP_FLASH_PARAM                    *ParamTable;
   CONST SPI_FLASH_CONFIGURATION_DATA  *ConfigData;
   EFI_SPI_IO_PROTOCOL                 *SpiIo;
-  UINT32                              Index;
 
   SpiIo = Context->SpiIo;
   SpiNorParams = Context->SpiNorParams;
@@ -163,6 +256,7 @@ SpiNorFlashWrite (
 
   // Cache the block size to avoid de-referencing pointers all the time
   BlockSize = SFDP_PARAM_ERASE_SIZE (ParamTable);
+  BlockOffset = GET_BLOCK_OFFSET(Lba);
 
   // For the very best performance, programming should be done in full pages
   // of page size aligned on page size boundaries with each Page being programmed only once.
@@ -174,148 +268,86 @@ SpiNorFlashWrite (
     Alignment -= sizeof (UINT8);
   }
   Alignment = MIN (ConfigData->PageSize, Alignment);
-  DoErase = TRUE;
-
-  // Pick 128bytes as a good start for word operations as opposed to erasing the
-  // block and writing the data regardless if an erase is really needed.
-  // It looks like most individual NV variable writes are smaller than 128bytes.
-  if (NumBytes <= 128) {
-    Source = (UINT8 *)Context->ShadowBuffer;
-    IntBytes = (Offset % Alignment); // Bytes to read before the offset
-    IntBytes += (Alignment - ( (Offset + NumBytes) % Alignment)) % Alignment; // Bytes to read after the numbytes
-
-    //First Read the data into shadow buffer from location where data is to be written
-    Status = ReadFlashData (
-               SpiIo,
-               SpiNorParams,
-               GET_BLOCK_OFFSET(Lba) + (Offset - (Offset % Alignment)),
-               NumBytes + IntBytes,
-               Source
-               );
-    if (EFI_ERROR (Status)) {
-      DEBUG ((
-        DEBUG_ERROR,
-        "%a: ERROR - Failed to Read @ Offset 0x%x Status=%d\n",
-        __FUNCTION__,
-        Offset + GET_BLOCK_OFFSET(Lba),
-        Status
-        ));
-      return Status;
-    }
 
-    // Check to see if we need to erase before programming the data into QSPI.
-    // If the destination bits are only changing from 1s to 0s we can
-    // just write. After a block is erased all bits in the block is set to 1.
-    // If any byte requires us to erase we just give up and rewrite all of it.
-    Source += (Offset % Alignment);
-    DoErase = TestBitSetClear (Source, Buffer, NumBytes, TRUE);
-
-    // if we got here then write all the data. Otherwise do the
-    // Erase-Write cycle.
-    if (!DoErase) {
-      // Put the data at the appropriate location inside the buffer area
-      CopyMem (Source, Buffer, NumBytes);
-
-      for (Index = 0, Source = Context->ShadowBuffer;
-           Index < (NumBytes + IntBytes);
-           Index += Alignment, Source += Alignment) {
-        Status = WriteFlashData (
-                    SpiIo,
-                    SpiNorParams,
-                    GET_BLOCK_OFFSET(Lba) + (Offset - (Offset % Alignment)) + Index,
-                    Alignment,
-                    Source
-                    );
-        if (EFI_ERROR (Status)) {
-          DEBUG ((
-            DEBUG_ERROR, "%a: ERROR - Failed to Write @ Offset 0x%x Status %r\n",
-            __FUNCTION__,
-            GET_BLOCK_OFFSET(Lba) + (Offset - (Offset % Alignment)) + Index,
-            Status
-            ));
-          return Status;
-        }
-      }
-      return EFI_SUCCESS;
-    }
+  // Read the pages touched by the write into the shadow buffer, at their
+  // offset in the block
+  Start = Offset - (Offset % Alignment);
+  End = ALIGN_VALUE (Offset + NumBytes, Alignment);
+  Status = ReadFlashData (
+             SpiIo,
+             SpiNorParams,
+             BlockOffset + Start,
+             End - Start,
+             (UINT8 *)Context->ShadowBuffer + Start
+             );
+  if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR, "%a: ERROR - Failed to Read @ Offset 0x%x Status %r\n",
+      __FUNCTION__,
+      BlockOffset + Start,
+      Status
+      ));
+    return EFI_DEVICE_ERROR;
   }
 
-  // If we are going to write full block, no need to read block and then update bytes in it
-  if (NumBytes != BlockSize) {
-    // Read QSPI Flash data into shadow buffer
-    Status = ReadFlashData (
-               SpiIo,
-               SpiNorParams,
-               GET_BLOCK_OFFSET(Lba),
-               BlockSize,
-               Context->ShadowBuffer
-               );
-    if (EFI_ERROR (Status)) {
-        DEBUG ((
-          DEBUG_ERROR, "%a: ERROR - Failed to Read @ Offset 0x%x Status %r\n",
-          __FUNCTION__,
-          GET_BLOCK_OFFSET(Lba),
-          Status
-          ));
-      // Return one of the pre-approved error statuses
-      return EFI_DEVICE_ERROR;
-    }
-    // Put the data at the appropriate location inside the buffer area
-    CopyMem ((VOID*)((UINTN)Context->ShadowBuffer + Offset), Buffer, NumBytes);
+  // Check to see if we need to erase before programming the data into QSPI.
+  // If the destination bits are only changing from 1s to 0s we can
+  // just write the pages that changed. After a block is erased all bits in
+  // the block is set to 1.
+  if (!TestBitSetClear ((UINT8 *)Context->ShadowBuffer + Offset, Buffer, NumBytes, TRUE)) {
+    return SpiNorFlashWritePages (Context, BlockOffset, Start, End, Alignment,
+             Offset, NumBytes, Buffer, FALSE);
   }
 
-  //Erase Block
-  Status = EraseFlashBlock (Context->SpiIo, SpiNorParams, GET_BLOCK_OFFSET(Lba));
+  // Erase with the smallest erase type usable in this block, and only the
+  // sectors that need it. The rest of each erased sector is read back first
+  // so that it can be programmed again.
+  EraseIndex = GetSubBlockEraseIndex (SpiNorParams, BlockOffset);
+  EraseSize = (1 << ParamTable->Erase_Size_Command[EraseIndex].Size);
+  Start = Offset - (Offset % EraseSize);
+  End = ALIGN_VALUE (Offset + NumBytes, EraseSize);
+
+  Status = ReadFlashData (
+             SpiIo,
+             SpiNorParams,
+             BlockOffset + Start,
+             End - Start,
+             (UINT8 *)Context->ShadowBuffer + Start
+             );
   if (EFI_ERROR (Status)) {
+    DEBUG ((
+      DEBUG_ERROR, "%a: ERROR - Failed to Read @ Offset 0x%x Status %r\n",
+      __FUNCTION__,
+      BlockOffset + Start,
+      Status
+      ));
     // Return one of the pre-approved error statuses
     return EFI_DEVICE_ERROR;
   }
 
-  if (NumBytes != BlockSize) {
-    // Write the modified shadow buffer back to the SpiNorFlash
-    for (Index = 0, Source = Context->ShadowBuffer;
-         Index < BlockSize;
-         Index += Alignment, Source += Alignment) {
-      Status = WriteFlashData (
-                 SpiIo,
-                 SpiNorParams,
-                 GET_BLOCK_OFFSET(Lba) + Index,
-                 Alignment,
-                 Source
-                 );
+  for (Sector = Start; Sector < End; Sector += EraseSize) {
+    First = MAX (Sector, Offset);
+    Last = MIN (Sector + EraseSize, Offset + NumBytes);
+
+    if (!TestBitSetClear ((UINT8 *)Context->ShadowBuffer + First, Buffer + (First - Offset),
+           Last - First, TRUE)) {
+      // This sector can be updated in place
+      Status = SpiNorFlashWritePages (Context, BlockOffset, Sector, Sector + EraseSize,
+                 Alignment, Offset, NumBytes, Buffer, FALSE);
+    } else {
+      //Erase Sector
+      Status = EraseFlashSector (SpiIo, SpiNorParams, BlockOffset + Sector, EraseIndex);
       if (EFI_ERROR (Status)) {
-        DEBUG ((
-          DEBUG_ERROR, "%a: ERROR - Failed to Write @ Offset 0x%x Status %r\n",
-          __FUNCTION__,
-          GET_BLOCK_OFFSET(Lba) + Index,
-          Status
-          ));
         // Return one of the pre-approved error statuses
         return EFI_DEVICE_ERROR;
       }
+
+      Status = SpiNorFlashWritePages (Context, BlockOffset, Sector, Sector + EraseSize,
+                 Alignment, Offset, NumBytes, Buffer, TRUE);
     }
-  } else {
-    // Write the Buffer to an entire block in SpiNorFlash
-    for (Index = 0, Source = Buffer;
-         Index < BlockSize;
-         Index += Alignment, Source += Alignment) {
-      Status = WriteFlashData (
-                 SpiIo,
-                 SpiNorParams,
-                 GET_BLOCK_OFFSET(Lba) + Index,
-                 Alignment,
-                 Source
-                 );
-      if (EFI_ERROR (Status)) {
-        DEBUG ((
-          DEBUG_ERROR, "%a: ERROR - Failed to Write @ Offset 0x%x Status %r\n",
-          __FUNCTION__,
-          GET_BLOCK_OFFSET(Lba) + Index,
-          Status
-          ));
-        // Return one of the pre-approved error statuses
-        return EFI_DEVICE_ERROR;
-      }
+    if (EFI_ERROR (Status)) {
+      // Return one of the pre-approved error statuses
+      return EFI_DEVICE_ERROR;
     }
   }
 
@@ -408,6 +408,8 @@ GetEraseCommandIndex (
 {
   SFDP_SECTOR_MAP               *Table;
   SFDP_SECTOR_MAP               *TableBackup;
+  SFDP_SECTOR_MAP               *Region;
+  UINTN                         RegionCount;
   SFDP_TABLE_HEADER             *TableHeader;
   EFI_SPI_REQUEST_PACKET        *RequestPacket;
   UINTN                         Index;
@@ -542,15 +544,23 @@ GetEraseCommandIndex (
   }
 
   // Look for supported Erase sizes in regions in sector map
-  RegionEraseSupport = Table->Map.Erase_Support;
-  if (Table->Map.RegionCount) {
-    // There are multiple regions in sector map
-    // look for an erase size that is supported by all the regions
-    for (Index = 1; Index < Table->Map.RegionCount; Index++) {
-      // Move Table Pointer by one Dword
-      Table = (SFDP_SECTOR_MAP *)((UINT32 *)Table + 1);
-      RegionEraseSupport &= Table->Map.Erase_Support;
+  // look for an erase size that is supported by all the regions and keep
+  // the per region erase types for sub-block updates.
+  // Region count in the map header is the number of regions minus one.
+  RegionCount = Table->Map.RegionCount + 1;
+  RegionEraseSupport = 0xF;
+  SpiNorParams->RegionCount = 0;
+  for (Index = 0, Region = Table; Index < RegionCount; Index++) {
+    RegionEraseSupport &= Region->Map.Erase_Support;
+    if (RegionCount <= SPI_NOR_MAX_ERASE_REGIONS) {
+      SpiNorParams->Regions[Index].Size = (Region->Map.RegionSize + 1) * 256;
+      SpiNorParams->Regions[Index].EraseSupport = Region->Map.Erase_Support;
     }
+    // Move Region Pointer by one Dword
+    Region = (SFDP_SECTOR_MAP *)((UINT32 *)Region + 1);
+  }
+  if (RegionCount <= SPI_NOR_MAX_ERASE_REGIONS) {
+    SpiNorParams->RegionCount = RegionCount;
   }
 
   if (!RegionEraseSupport) {
@@ -1046,9 +1056,87 @@ EraseFlashBlock (
   IN  SPI_NOR_PARAMS                *SpiNorParams,
   IN  UINTN                         Offset
   )
+{
+  return EraseFlashSector (SpiIo, SpiNorParams, Offset, SpiNorParams->EraseIndex);
+}
+
+/**
+  Find the smallest erase type that can be used everywhere inside the
+  erase block at Offset, so that a partial block update erases less.
+
+  @param[in]  SpiNorParams  Pointer to SPI_NOR_PARAMS
+  @param[in]  Offset        Flash offset of the erase block
+
+  @return     Index of the erase type in the SFDP parameter table.
+              SpiNorParams->EraseIndex if no smaller erase type can be used.
+**/
+UINT8
+GetSubBlockEraseIndex (
+  IN  SPI_NOR_PARAMS                *SpiNorParams,
+  IN  UINTN                         Offset
+  )
+{
+  SFDP_FLASH_PARAM      *ParamTable;
+  UINTN                 RegionStart;
+  UINTN                 RegionEnd;
+  UINT8                 EraseSupport;
+  UINT8                 EraseIndex;
+  UINT8                 Index;
+
+  ParamTable = SpiNorParams->ParamTable;
+  EraseIndex = SpiNorParams->EraseIndex;
+  EraseSupport = 0;
+
+  // Without a sector map only the block erase type is known to be usable
+  for (Index = 0, RegionStart = 0; Index < SpiNorParams->RegionCount; Index++) {
+    RegionEnd = RegionStart + SpiNorParams->Regions[Index].Size;
+    if (Offset < RegionEnd) {
+      if ((Offset + SFDP_PARAM_ERASE_SIZE (ParamTable)) <= RegionEnd) {
+        EraseSupport = SpiNorParams->Regions[Index].EraseSupport;
+      }
+      break;
+    }
+    RegionStart = RegionEnd;
+  }
+
+  for (Index = 0; Index < ARRAY_SIZE (ParamTable->Erase_Size_Command); Index++) {
+    if ((EraseSupport & (1 << Index)) &&
+        (ParamTable->Erase_Size_Command[Index].Size != 0) &&
+        (ParamTable->Erase_Size_Command[Index].Size <
+           ParamTable->Erase_Size_Command[EraseIndex].Size)) {
+      EraseIndex = Index;
+    }
+  }
+
+  return EraseIndex;
+}
+
+/**
+  Erase one sector using the given SFDP erase type.
+
+  @param[in]  SpiIo         Pointer to SPI IO protocol
+  @param[in]  SpiNorParams  Pointer to SPI_NOR_PARAMS
+  @param[in]  Offset        Flash offset of the sector, aligned to the erase size
+  @param[in]  EraseIndex    Index of the erase type in the SFDP parameter table
+**/
+EFI_STATUS
+EraseFlashSector (
+  IN  EFI_SPI_IO_PROTOCOL           *SpiIo,
+  IN  SPI_NOR_PARAMS                *SpiNorParams,
+  IN  UINTN                         Offset,
+  IN  UINT8                         EraseIndex
+  )
 {
   EFI_SPI_REQUEST_PACKET        *RequestPacket;
   EFI_STATUS                    Status;
+  UINT8                         BlockEraseIndex;
+
+  // The erase request packet and the erase timeout follow the erase type
+  // in SpiNorParams, so switch to the requested type for this erase only
+  BlockEraseIndex = SpiNorParams->EraseIndex;
+  SpiNorParams->EraseIndex = EraseIndex;
+  SpiNorParams->Commands[SPI_NOR_REQUEST_TYPE_ERASE] =
+    SpiNorParams->ParamTable->Erase_Size_Command[EraseIndex].Command;
 
   RequestPacket = SpiNorGetRequestPacket (SpiNorParams, SPI_NOR_REQUEST_TYPE_WRITE_ENABLE);
   FillRequestPacketData (
@@ -1098,5 +1186,8 @@ EraseFlashBlock (
   }
 
 ErrorExit:
+  SpiNorParams->EraseIndex = BlockEraseIndex;
+  SpiNorParams->Commands[SPI_NOR_REQUEST_TYPE_ERASE] =
+    SpiNorParams->ParamTable->Erase_Size_Command[BlockEraseIndex].Command;
   return Status;
 }
@@ -26,6 +26,7 @@
 #define GET_BLOCK_OFFSET(Lba)               (Lba * SFDP_PARAM_ERASE_SIZE(ParamTable))
 #define PARAMETER_REV(Major, Minor)         ((Major << 8) | Minor)
 #define PARAMETER_ID(Msb, Lsb)              ((Msb << 8) | Lsb)
+#define SPI_NOR_MAX_ERASE_REGIONS           8
 
 #pragma pack (1)
 typedef struct _SFDP_HEADER {
@@ -157,6 +158,14 @@ typedef enum {
   SPI_NOR_REQUEST_TYPE_MAX
 } SPI_NOR_REQUEST_TYPE;
 
+//
+// Erase types usable in one region of the sector map in use
+//
+typedef struct _SPI_NOR_ERASE_REGION {
+  UINT32                    Size;
+  UINT8                     EraseSupport;
+} SPI_NOR_ERASE_REGION;
+
 typedef struct _SPI_NOR_PARAMS {
   EFI_SPI_REQUEST_PACKET    *RequestPackets;
   UINT8                     Commands[SPI_NOR_REQUEST_TYPE_MAX];
@@ -165,6 +174,8 @@ typedef struct _SPI_NOR_PARAMS {
   UINT8                     EraseIndex;
   SFDP_FLASH_PARAM          *ParamTable;
   SFDP_TABLE_HEADER         *ParamHeader;
+  UINT8                     RegionCount;
+  SPI_NOR_ERASE_REGION      Regions[SPI_NOR_MAX_ERASE_REGIONS];
 } SPI_NOR_PARAMS;
 
 /**
@@ -216,6 +227,20 @@ EraseFlashBlock (
   IN  UINTN                         Offset
   );
 
+EFI_STATUS
+EraseFlashSector (
+  IN  EFI_SPI_IO_PROTOCOL           *SpiIo,
+  IN  SPI_NOR_PARAMS                *SpiNorParams,
+  IN  UINTN                         Offset,
+  IN  UINT8                         EraseIndex
+  );
+
+UINT8
+GetSubBlockEraseIndex (
+  IN  SPI_NOR_PARAMS                *SpiNorParams,
+  IN  UINTN                         Offset
+  );
+
 UINT64
 GetMaxTimeout (
   IN  SPI_NOR_PARAMS          *SpiNorParams,
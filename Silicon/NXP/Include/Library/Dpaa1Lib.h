@@ -118,6 +118,20 @@ TransmitFrame (
   IN UINTN BuffSize
   );
 
+/**
+ Function to transmit a batch of ethernet frames on DPAA1 network interface
+ Enqueue up to *NumFrames buffers to TxBD circular queue, with one TxQD
+ update for the whole batch. On return *NumFrames holds the number of
+ frames enqueued
+*/
+EFI_STATUS
+TransmitFrames (
+  IN     ETH_DEVICE *FmanEthDevice,
+  IN     VOID       **Data,
+  IN     UINTN      *BuffSize,
+  IN OUT UINTN      *NumFrames
+  );
+
 EFI_STATUS
 GetTransmitStatus (
   IN  ETH_DEVICE *FmanEthDevice,
@@ -134,6 +148,20 @@ ReceiveFrame(
   VOID *Data
   );
 
+/**
+ Function to receive a batch of ethernet frames from DPAA1 network interface
+ Copy up to *NumFrames frames to the given buffers, with one RxQD update
+ for the whole batch. On return *NumFrames holds the number of frames
+ received and BuffSize[] their sizes
+*/
+EFI_STATUS
+ReceiveFrames (
+  IN     ETH_DEVICE *FmanEthDevice,
+  IN     VOID       **Data,
+  IN OUT UINTN      *BuffSize,
+  IN OUT UINTN      *NumFrames
+  );
+
 /**
  Function to set MAC address for ethernet device
 */
@@ -19,6 +19,7 @@
 #include <Library/Dpaa2McIo.h>
 #include <Library/Dpaa2McInterfaceLib/fsl_dprc.h>
 #include <Library/Dpaa2EthernetMacLib.h>
+#include <Protocol/Dpaa2PacketTrace.h>
 #include <Uefi.h>
 
 /**
@@ -28,6 +29,35 @@
 #define DPAA2_ETHERNET_HEADER_SIZE          36
 #define MC_VERSION(Major, Minor)            (Major*10 + Minor)
 
+/**
+ * Maximum number of frames that can be passed to
+ * Dpaa2McNetworkInterfaceTransmitBatch () in one call
+ */
+#define DPAA2_ETH_MAX_TX_BATCH_SIZE         8
+
+/**
+ * Number of Tx buffers that can be held in the Tx buffer stash
+ * of a network interface (one QBman acquire command)
+ */
+#define DPAA2_ETH_TX_BUFFER_STASH_SIZE      7
+
+/**
+ * Number of Rx frames pulled from QBman in one burst and cached
+ * in a network interface (at most the QBman DQRR size)
+ */
+#define DPAA2_ETH_RX_FRAME_CACHE_SIZE       8
+
+/**
+ * Maximum number of Rx buffers that can be on loan to a consumer of
+ * Dpaa2McNetworkInterfaceReceiveLoan () at the same time
+ */
+#define DPAA2_ETH_MAX_RX_LOANS              16
+
+/**
+ * Number of records in the packet trace ring (must be a power of 2)
+ */
+#define DPAA2_PACKET_TRACE_RING_SIZE        512
+
 /**
  * DPAA2 QBman software portal
  */
@@ -222,8 +252,67 @@ typedef struct _DPAA2_NETWORK_INTERFACE {
    */
   struct dprc_endpoint DpniEndpoint;
 
+  /**
+   * QBman buffers acquired from the DPBP ahead of time for Tx frames,
+   * so that buffers are acquired several at a time
+   */
+  UINT64 TxBufferStash[DPAA2_ETH_TX_BUFFER_STASH_SIZE];
+
+  /**
+   * Number of valid entries in TxBufferStash
+   */
+  UINT32 TxBufferStashCount;
+
+  /**
+   * Frame descriptors (8 words each) of Rx frames dequeued in the last
+   * burst that have not been handed to the caller yet
+   */
+  UINT32 RxFrameCache[DPAA2_ETH_RX_FRAME_CACHE_SIZE][8];
+
+  /**
+   * Index of the next entry to hand out from RxFrameCache
+   */
+  UINT32 RxFrameCacheNext;
+
+  /**
+   * Number of entries of RxFrameCache not handed out yet
+   */
+  UINT32 RxFrameCacheCount;
+
+  /**
+   * QBman buffers of Rx frames currently on loan to a consumer
+   */
+  UINT64 RxLoanedBuffers[DPAA2_ETH_MAX_RX_LOANS];
+
+  /**
+   * Number of valid entries in RxLoanedBuffers
+   */
+  UINT32 RxLoanCount;
+
 } DPAA2_NETWORK_INTERFACE;
 
+/**
+ * Tx frame passed to Dpaa2McNetworkInterfaceTransmitBatch ()
+ */
+typedef struct _DPAA2_TX_FRAME {
+  UINTN           HdrSize;
+  UINTN           BuffSize;
+  VOID            *Data;
+  EFI_MAC_ADDRESS *SrcAddr;
+  EFI_MAC_ADDRESS *DstAddr;
+  UINT16          *Protocol;
+
+  /**
+   * Opaque value to be returned with the Tx completion of the frame
+   */
+  UINT32          TxFrameCookie;
+
+  /**
+   * Address of the QBman buffer used for the frame (output)
+   */
+  UINT64          QBmanTxBufferAddr;
+} DPAA2_TX_FRAME;
+
 
 EFI_STATUS
 Dpaa2McInit (
@@ -283,13 +372,24 @@ Dpaa2McNetworkInterfaceTransmit (
   EFI_MAC_ADDRESS         *SrcAddr,
   EFI_MAC_ADDRESS         *DstAddr,
   UINT16                  *Protocol,
+  UINT32                  TxFrameCookie,
   UINT64                  *QBmanTxBufferAddrOut
   );
 
+EFI_STATUS
+Dpaa2McNetworkInterfaceTransmitBatch (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
+  WRIOP_DPMAC             *WriopDpmac,
+  DPAA2_TX_FRAME          *TxFrames,
+  UINT32                  NumFrames,
+  UINT32                  *NumFramesSent
+  );
+
 EFI_STATUS
 Dpaa2McNetworkInterfaceCheckTxCompletion (
   DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
-  UINT64                  *QBmanTxBufferAddrOut
+  UINT64                  *QBmanTxBufferAddrOut,
+  UINT32                  *TxFrameCookieOut
   );
 
 EFI_STATUS
@@ -303,6 +403,20 @@ Dpaa2McNetworkInterfaceReceive (
   UINT16                  *Protocol
   );
 
+EFI_STATUS
+Dpaa2McNetworkInterfaceReceiveLoan (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
+  VOID                    **FrameData,
+  UINTN                   *FrameSize,
+  UINT64                  *LoanId
+  );
+
+EFI_STATUS
+Dpaa2McNetworkInterfaceReturnLoan (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
+  UINT64                  LoanId
+  );
+
 EFI_STATUS
 Dpaa2McAddMulticastMacAddress (
   DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
@@ -315,4 +429,10 @@ Dpaa2McRemoveMulticastMacAddress (
   EFI_MAC_ADDRESS         *MulticastMacAddr
   );
 
+VOID
+Dpaa2McPacketTraceGetRecords (
+  DPAA2_PACKET_TRACE_RECORD *Records,
+  UINT32                    *NumRecords
+  );
+
 #endif /* __DPAA2_MANAGEMENT_COMPLEX_LIB_H__ */
@@ -48,8 +48,13 @@
 
 #define FMAN_MIIM_TIMEOUT           	0xFFFF
 
-#define RX_RING_SIZE            	8
-#define TX_RING_SIZE            	8
+#define RX_RING_SIZE            	FixedPcdGet32 (PcdDpaa1RxRingSize)
+#define TX_RING_SIZE            	FixedPcdGet32 (PcdDpaa1TxRingSize)
+
+//
+// BdRingSize in the queue descriptor is a 16-bit byte count
+//
+#define MAX_RING_SIZE              	(MAX_UINT16 / sizeof (BD))
 #define MAX_RXBUF_LOG2             	11
 #define MAX_RXBUF_LEN              	BIT(MAX_RXBUF_LOG2)
 
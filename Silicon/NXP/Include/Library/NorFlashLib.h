@@ -54,6 +54,14 @@ NorFlashPlatformWriteBuffer (
   IN        UINT8           *Buffer
   );
 
+EFI_STATUS
+NorFlashPlatformWriteBlocks (
+  IN NOR_FLASH_INSTANCE     *Instance,
+  IN EFI_LBA                Lba,
+  IN UINTN                  NumBytes,
+  IN UINT8                  *Buffer
+  );
+
 EFI_STATUS
 NorFlashPlatformEraseSector (
   IN NOR_FLASH_INSTANCE     *Instance,
@@ -41,6 +41,7 @@ struct _NOR_FLASH_INSTANCE {
   BOOLEAN                             SupportFvb;
   EFI_FIRMWARE_VOLUME_BLOCK2_PROTOCOL FvbProtocol;
   VOID*                               ShadowBuffer;
+  VOID*                               ReadCache;
   NOR_FLASH_DEVICE_PATH               DevicePath;
 };
 
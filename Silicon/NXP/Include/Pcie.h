@@ -103,6 +103,8 @@
 #define PCI_LUT_DBG               FixedPcdGet32 (PcdPcieLutDbg)
 #define PCI_LUT_BASE              FixedPcdGet32 (PcdPcieLutBase)
 #define LTSSM_PCIE_L0             0x11
+#define LTSSM_PCIE_DETECT_ACTIVE  0x01
+#define PCIE_LINK_POLL_INTERVAL   10      // us
 #define PCI_LINK_CAP              0x7c
 #define PCI_LINK_SPEED_MASK       0xf
 
@@ -0,0 +1,136 @@
+/** @file
+  DPAA2 packet trace protocol
+
+  Gives access to the in-memory ring where the DPAA2 Ethernet driver records
+  the frames it sends and receives when DPAA_DEBUG_TRACE_NET_PACKETS is set
+  in PcdDpaaDebugFlags. Recording only stores a fixed-size binary record per
+  frame, so it does not slow the data path down the way printing each frame
+  to the console does. The records are decoded when they are dumped.
+
+  Copyright 2017 NXP
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __DPAA2_PACKET_TRACE_PROTOCOL_H__
+#define __DPAA2_PACKET_TRACE_PROTOCOL_H__
+
+#define DPAA2_PACKET_TRACE_PROTOCOL_GUID \
+  { 0x5c0d6a8e, 0x2f41, 0x4b7a, { 0x9d, 0x3c, 0x61, 0xe8, 0x0b, 0x47, 0xa5, 0x92 } }
+
+#define DPAA2_PACKET_TRACE_PROTOCOL_REVISION  0x00010000
+
+/**
+ * Direction of a traced frame
+ */
+#define DPAA2_PACKET_TRACE_RX           0x1   /* Frame received */
+#define DPAA2_PACKET_TRACE_TX           0x2   /* Frame enqueued for transmission */
+#define DPAA2_PACKET_TRACE_TX_CONFIRM   0x3   /* Tx confirmation dequeued */
+
+/**
+ * Number of leading bytes of a frame kept in its trace record
+ */
+#define DPAA2_PACKET_TRACE_DATA_SIZE    40
+
+/**
+ * Trace record of one frame (64 bytes)
+ */
+typedef struct _DPAA2_PACKET_TRACE_RECORD {
+  /**
+   * Position of the record in the trace, starting at 1. Records are
+   * returned oldest first.
+   */
+  UINT32  Sequence;
+
+  /**
+   * One of DPAA2_PACKET_TRACE_RX, DPAA2_PACKET_TRACE_TX or
+   * DPAA2_PACKET_TRACE_TX_CONFIRM
+   */
+  UINT8   Direction;
+  UINT8   Reserved;
+
+  /**
+   * Length of the frame in bytes
+   */
+  UINT16  Length;
+
+  /**
+   * Performance counter value when the record was written
+   */
+  UINT64  Timestamp;
+
+  /**
+   * Address of the QBman buffer in the frame descriptor
+   */
+  UINT64  FrameBufferAddr;
+
+  /**
+   * First bytes of the frame, starting with its Ethernet header. Only
+   * MIN (Length, DPAA2_PACKET_TRACE_DATA_SIZE) bytes are valid, and none
+   * for a Tx confirmation.
+   */
+  UINT8   Data[DPAA2_PACKET_TRACE_DATA_SIZE];
+} DPAA2_PACKET_TRACE_RECORD;
+
+typedef struct _DPAA2_PACKET_TRACE_PROTOCOL DPAA2_PACKET_TRACE_PROTOCOL;
+
+/**
+  Copy the most recent trace records.
+
+  @param This         Pointer to the protocol instance
+  @param Records      Array where the records are to be copied, oldest first
+  @param NumRecords   On input, number of entries in Records. On output,
+                      number of records copied.
+
+  @retval EFI_SUCCESS           The records have been copied
+  @retval EFI_INVALID_PARAMETER An argument is NULL
+ **/
+typedef
+EFI_STATUS
+(EFIAPI *DPAA2_PACKET_TRACE_GET_RECORDS) (
+  IN     DPAA2_PACKET_TRACE_PROTOCOL  *This,
+  OUT    DPAA2_PACKET_TRACE_RECORD    *Records,
+  IN OUT UINT32                       *NumRecords
+  );
+
+/**
+  Decode the trace records to the console, oldest first.
+
+  @param This         Pointer to the protocol instance
+
+  @retval EFI_SUCCESS           The records have been dumped
+  @retval EFI_OUT_OF_RESOURCES  No memory to take a copy of the records
+ **/
+typedef
+EFI_STATUS
+(EFIAPI *DPAA2_PACKET_TRACE_DUMP) (
+  IN DPAA2_PACKET_TRACE_PROTOCOL      *This
+  );
+
+struct _DPAA2_PACKET_TRACE_PROTOCOL {
+  UINT64                          Revision;
+
+  /**
+   * Number of records the ring holds. Older records are overwritten.
+   */
+  UINT32                          MaxRecords;
+
+  /**
+   * Frequency of the performance counter used for the timestamps, in Hz
+   */
+  UINT64                          TimestampFrequency;
+
+  DPAA2_PACKET_TRACE_GET_RECORDS  GetRecords;
+  DPAA2_PACKET_TRACE_DUMP         Dump;
+};
+
+extern EFI_GUID gDpaa2PacketTraceProtocolGuid;
+
+#endif /* __DPAA2_PACKET_TRACE_PROTOCOL_H__ */
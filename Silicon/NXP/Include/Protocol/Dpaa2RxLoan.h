@@ -0,0 +1,91 @@
+/** @file
+  DPAA2 Rx buffer loan protocol
+
+  Lets a consumer receive Ethernet frames in place, in the QBman buffer the
+  hardware received them into, instead of having them copied out by the SNP
+  Receive () function. The buffer has to be returned with Release () once
+  the consumer is done with the frame.
+
+  Copyright 2017 NXP
+
+  This program and the accompanying materials
+  are licensed and made available under the terms and conditions of the BSD License
+  which accompanies this distribution.  The full text of the license may be found at
+  http://opensource.org/licenses/bsd-license.php
+
+  THE PROGRAM IS DISTRIBUTED UNDER THE BSD LICENSE ON AN "AS IS" BASIS,
+  WITHOUT WARRANTIES OR REPRESENTATIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED.
+
+**/
+
+#ifndef __DPAA2_RX_LOAN_PROTOCOL_H__
+#define __DPAA2_RX_LOAN_PROTOCOL_H__
+
+#define DPAA2_RX_LOAN_PROTOCOL_GUID \
+  { 0x92b38af3, 0xf7fb, 0x4aa0, { 0x84, 0x1f, 0x22, 0xfa, 0x7a, 0x1c, 0x23, 0xdb } }
+
+#define DPAA2_RX_LOAN_PROTOCOL_REVISION  0x00010000
+
+typedef struct _DPAA2_RX_LOAN_PROTOCOL DPAA2_RX_LOAN_PROTOCOL;
+
+/**
+  Receive the next Ethernet frame without copying it.
+
+  The frame is received from the same queue as the SNP Receive () function
+  of the device this protocol is installed on, which must be initialized.
+
+  @param This       Pointer to the protocol instance
+  @param Frame      On success, pointer to the frame, starting with its
+                    Ethernet header
+  @param FrameSize  On success, length of the frame in bytes
+  @param LoanId     On success, value to pass to Release () for this frame
+
+  @retval EFI_SUCCESS           A frame has been received
+  @retval EFI_NOT_READY         No frame has been received
+  @retval EFI_OUT_OF_RESOURCES  MaxLoans frames are already on loan
+  @retval EFI_NOT_STARTED       The network interface is not initialized
+  @retval EFI_INVALID_PARAMETER An argument is NULL
+ **/
+typedef
+EFI_STATUS
+(EFIAPI *DPAA2_RX_LOAN_RECEIVE) (
+  IN  DPAA2_RX_LOAN_PROTOCOL  *This,
+  OUT VOID                    **Frame,
+  OUT UINTN                   *FrameSize,
+  OUT UINT64                  *LoanId
+  );
+
+/**
+  Give back the buffer of a frame obtained with Receive () to the hardware.
+
+  The frame must not be accessed anymore after this call.
+
+  @param This       Pointer to the protocol instance
+  @param LoanId     Value returned by Receive () for the frame
+
+  @retval EFI_SUCCESS           The buffer has been returned
+  @retval EFI_INVALID_PARAMETER LoanId does not refer to a frame on loan
+ **/
+typedef
+EFI_STATUS
+(EFIAPI *DPAA2_RX_LOAN_RELEASE) (
+  IN DPAA2_RX_LOAN_PROTOCOL   *This,
+  IN UINT64                   LoanId
+  );
+
+struct _DPAA2_RX_LOAN_PROTOCOL {
+  UINT64                  Revision;
+
+  /**
+   * Maximum number of frames that can be on loan at the same time. Frames
+   * on loan are not available to the hardware for reception.
+   */
+  UINT32                  MaxLoans;
+
+  DPAA2_RX_LOAN_RECEIVE   Receive;
+  DPAA2_RX_LOAN_RELEASE   Release;
+};
+
+extern EFI_GUID gDpaa2RxLoanProtocolGuid;
+
+#endif /* __DPAA2_RX_LOAN_PROTOCOL_H__ */
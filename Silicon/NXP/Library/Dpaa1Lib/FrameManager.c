@@ -562,6 +562,11 @@ EFI_STATUS FmRxPortParamInit (
   UINT32 BufLo, BufHi;
   INT32 I;
 
+  if (RX_RING_SIZE == 0 || RX_RING_SIZE > MAX_RING_SIZE) {
+    DPAA1_ERROR_MSG("Invalid Rx ring size %d\n", RX_RING_SIZE);
+    return EFI_INVALID_PARAMETER;
+  }
+
   /* alloc global parameter from MURAM */
   Pram = (FMAN_GLOBAL_PARAM *)FmanMemAlloc(
                 0, FMAN_PRAM_SIZE, FMAN_PRAM_ALIGN);
@@ -651,6 +656,11 @@ EFI_STATUS FmTxPortParamInit (
   BMI_TX_PORT *BmiTxPort = FmanEthDevice->TxPort;
   INT32 I;
 
+  if (TX_RING_SIZE == 0 || TX_RING_SIZE > MAX_RING_SIZE) {
+    DPAA1_ERROR_MSG("Invalid Tx ring size %d\n", TX_RING_SIZE);
+    return EFI_INVALID_PARAMETER;
+  }
+
   /* alloc global parameter ram from MURAM */
   Pram = (FMAN_GLOBAL_PARAM *)FmanMemAlloc(
                 0, FMAN_PRAM_SIZE, FMAN_PRAM_ALIGN);
@@ -1147,132 +1157,184 @@ FmanInitBmanInterface(
   return EFI_SUCCESS;
 }
 
+/*
+* ReceiveFrames : Copy up to *NumFrames received frames out of the RxBD
+* circular queue, then hand all consumed RxBDs back to the FMan with a
+* single RxQD update
+*/
 EFI_STATUS
-ReceiveFrame(
-  ETH_DEVICE *FmanEthDevice,
-  UINTN *BuffSize,
-  VOID *Data
+ReceiveFrames (
+  IN     ETH_DEVICE *FmanEthDevice,
+  IN     VOID       **Data,
+  IN OUT UINTN      *BuffSize,
+  IN OUT UINTN      *NumFrames
   )
 {
   FMAN_GLOBAL_PARAM *Pram;
   BD *Rxbd, *RxbdBase;
+  EFI_STATUS Result;
   UINT16 Status;
   UINT32 Len;
-  UINT16 OffsetOut;
   UINT8 *Buffer;
   UINT32 BufLo, BufHi;
+  UINTN Count;
+  UINTN Consumed;
 
   Pram = FmanEthDevice->RxPram;
-  Rxbd = FmanEthDevice->CurRxbd;
+  RxbdBase = (BD *)FmanEthDevice->RxBdRing;
+  Result = EFI_NOT_READY;
+  Count = 0;
+  Consumed = 0;
 
   EfiAcquireLock(&FmanEthDevice->RxSyncLock);
-  Status = MemReadMasked(&Rxbd->Status);
+  Rxbd = FmanEthDevice->CurRxbd;
+
+  while (Count < *NumFrames) {
+    Status = MemReadMasked(&Rxbd->Status);
+    if (Status & Rx_EMPTY)
+      break;
+
+    if (Status & Rx_ERROR) {
+      /* drop the frame, but give its RxBD back */
+      DPAA1_ERROR_MSG("Rx error\n");
+      Result = EFI_DEVICE_ERROR;
+    } else {
+      Len = MemReadMasked(&Rxbd->Len);
+
+      /* Update Buffersize to actual value */
+      if (BuffSize[Count] < Len) {
+        DPAA1_ERROR_MSG("RX Buffersize is too small %d,required to be %d\n",
+                         BuffSize[Count], Len);
+        BuffSize[Count] = Len;
+        if (Count == 0)
+          Result = EFI_BUFFER_TOO_SMALL;
+        break;
+      }
 
-  if (!(Status & Rx_EMPTY)) {
-    if (!(Status & Rx_ERROR)) {
       BufHi = MemReadMasked(&Rxbd->BufPtrHi);
       BufLo = SwapMmioRead32((UINTN)&Rxbd->BufPtrLo);
       Buffer = (UINT8 *)((UINTN)(BufHi << 16) << 16 | BufLo);
-      Len = MemReadMasked(&Rxbd->Len);
-    } else {
-      DPAA1_ERROR_MSG("Rx error\n");
-      EfiReleaseLock(&FmanEthDevice->RxSyncLock);
-      return EFI_DEVICE_ERROR;
+
+      InternalMemCopyMem(Data[Count], (VOID *)Buffer, Len);
+      BuffSize[Count] = Len;
+      Count++;
     }
-    /* Update Buffersize to actual value */
-    if ( *BuffSize < Len ) {
-      DPAA1_ERROR_MSG("RX Buffersize is too small %d,required to be %d\n",
-                       *BuffSize, Len);
-      *BuffSize = Len;
-      return EFI_BUFFER_TOO_SMALL;
-    } else
-      *BuffSize = Len;
-
-    InternalMemCopyMem(Data, (VOID *)Buffer, Len);
-
-    /* clear the RxBDs */
-    MemWriteMasked(&Rxbd->Status, Rx_EMPTY);
+
+    /* clear the RxBD */
     MemWriteMasked(&Rxbd->Len, 0);
-    MemoryFence();
+    MemWriteMasked(&Rxbd->Status, Rx_EMPTY);
 
     /* advance RxBD */
     Rxbd++;
-    RxbdBase = (BD *)FmanEthDevice->RxBdRing;
     if (Rxbd >= (RxbdBase + RX_RING_SIZE))
       Rxbd = RxbdBase;
 
-    /* update RxQD */
-    OffsetOut = MemReadMasked(&Pram->Rxqd.OffsetOut);
-    OffsetOut += sizeof(BD);
-    if (OffsetOut >= MemReadMasked(&Pram->Rxqd.BdRingSize))
-      OffsetOut = 0;
+    Consumed++;
+  }
+
+  if (Consumed != 0) {
+    MemoryFence();
 
-    MemWriteMasked(&Pram->Rxqd.OffsetOut, OffsetOut);
+    /* update RxQD once for the whole batch */
+    MemWriteMasked(&Pram->Rxqd.OffsetOut, (Rxbd - RxbdBase) * sizeof(BD));
     MemoryFence();
+
+    FmanEthDevice->CurRxbd = (VOID *)Rxbd;
   }
 
-  FmanEthDevice->CurRxbd = (VOID *)Rxbd;
   EfiReleaseLock(&FmanEthDevice->RxSyncLock);
 
-  return EFI_SUCCESS;
+  *NumFrames = Count;
+
+  return (Count != 0) ? EFI_SUCCESS : Result;
+}
+
+EFI_STATUS
+ReceiveFrame(
+  ETH_DEVICE *FmanEthDevice,
+  UINTN *BuffSize,
+  VOID *Data
+  )
+{
+  UINTN NumFrames = 1;
+
+  return ReceiveFrames(FmanEthDevice, &Data, BuffSize, &NumFrames);
 }
 
 /*
-* Transmit Frame : Enqueue a buffer to TxBD circular queue
-* for transmitting
+* TransmitFrames : Enqueue up to *NumFrames buffers to TxBD circular queue
+* for transmitting, and let the FMan know about all of them with a single
+* TxQD update
 */
 EFI_STATUS
-TransmitFrame (
-  IN  ETH_DEVICE *FmanEthDevice,
-  IN VOID * Data, 
-  IN UINTN BuffSize
+TransmitFrames (
+  IN     ETH_DEVICE *FmanEthDevice,
+  IN     VOID       **Data,
+  IN     UINTN      *BuffSize,
+  IN OUT UINTN      *NumFrames
   )
 {
   FMAN_GLOBAL_PARAM *Pram;
-  UINT8 TxbdId;
+  UINT32 TxbdId;
   BD *Txbd;
-  UINT16 Offset;
+  UINTN Count;
 
   Pram = FmanEthDevice->TxPram;
 
-  if (FmanEthDevice->TotalPendingTxbd == TX_RING_SIZE)
-    return EFI_NOT_READY;
+  EfiAcquireLock(&FmanEthDevice->TxSyncLock);
 
-  TxbdId = (FmanEthDevice->CurPendingTxbdId+1) % TX_RING_SIZE;
+  for (Count = 0; Count < *NumFrames; Count++) {
+    if (FmanEthDevice->TotalPendingTxbd == TX_RING_SIZE)
+      break;
 
-  Txbd = &(((BD *)FmanEthDevice->TxBdRing)[TxbdId]);
+    TxbdId = (FmanEthDevice->CurPendingTxbdId + 1) % TX_RING_SIZE;
+    Txbd = &(((BD *)FmanEthDevice->TxBdRing)[TxbdId]);
 
-  EfiAcquireLock(&FmanEthDevice->TxSyncLock);
+    if (MemReadMasked(&Txbd->Status) & Tx_READY)
+      break;
 
-  if (MemReadMasked(&Txbd->Status) & Tx_READY) {
-    EfiReleaseLock(&FmanEthDevice->TxSyncLock);
-    return EFI_NOT_READY;
+    /* setup TxBD */
+    MemWriteMasked(&Txbd->BufPtrHi, (UINT16)Upper32Bits((UINTN)Data[Count]));
+    SwapMmioWrite32((UINTN)&Txbd->BufPtrLo, Lower32Bits((UINTN)Data[Count]));
+    MemWriteMasked(&Txbd->Len, BuffSize[Count]);
+    MemWriteMasked(&Txbd->Status, Tx_READY | Tx_LAST);
+
+    /* update current txbd and peding TxBd count */
+    FmanEthDevice->CurPendingTxbdId = TxbdId;
+    FmanEthDevice->TotalPendingTxbd++;
   }
 
-  /* setup TxBD */
-  MemWriteMasked(&Txbd->BufPtrHi, (UINT16)Upper32Bits((UINTN)Data));
-  SwapMmioWrite32((UINTN)&Txbd->BufPtrLo, Lower32Bits((UINTN)Data));
-  MemWriteMasked(&Txbd->Len, BuffSize);
+  if (Count != 0) {
+    /* TxBDs must be visible before the RISC looks at them */
+    MemoryFence();
 
-  MemoryFence();
-  MemWriteMasked(&Txbd->Status, Tx_READY | Tx_LAST);
-  MemoryFence();
+    /* update TxQD, let RISC to send the whole batch */
+    TxbdId = (FmanEthDevice->CurPendingTxbdId + 1) % TX_RING_SIZE;
+    MemWriteMasked(&Pram->Txqd.OffsetIn, TxbdId * sizeof(BD));
+    MemoryFence();
+  }
 
-  /* update TxQD, let RISC to send the packet */
-  Offset = MemReadMasked(&Pram->Txqd.OffsetIn);
-  Offset += sizeof(BD);
-  if (Offset >= MemReadMasked(&Pram->Txqd.BdRingSize))
-    Offset = 0;
+  EfiReleaseLock(&FmanEthDevice->TxSyncLock);
 
-  MemWriteMasked(&Pram->Txqd.OffsetIn, Offset);
-  MemoryFence();
+  *NumFrames = Count;
 
-  /* update current txbd and peding TxBd count */
-  FmanEthDevice->CurPendingTxbdId = TxbdId;
-  FmanEthDevice->TotalPendingTxbd++;
-  EfiReleaseLock(&FmanEthDevice->TxSyncLock);
+  return (Count != 0) ? EFI_SUCCESS : EFI_NOT_READY;
+}
 
-  return EFI_SUCCESS;
+/*
+* Transmit Frame : Enqueue a buffer to TxBD circular queue
+* for transmitting
+*/
+EFI_STATUS
+TransmitFrame (
+  IN  ETH_DEVICE *FmanEthDevice,
+  IN VOID * Data, 
+  IN UINTN BuffSize
+  )
+{
+  UINTN NumFrames = 1;
+
+  return TransmitFrames(FmanEthDevice, &Data, &BuffSize, &NumFrames);
 }
 
 /*
@@ -29,6 +29,7 @@
 #include <Library/Dpaa2McInterfaceLib/fsl_dpmac_cmd.h>
 #include <Library/MemoryAllocationLib.h>
 #include <Library/NetLib.h>
+#include <Library/SynchronizationLib.h>
 #include <Library/TimerLib.h>
 #include <Library/UefiLib.h>
 
@@ -37,6 +38,106 @@
 
 STATIC const EFI_LOCK gEfiLockInitializer = EFI_INITIALIZE_LOCK_VARIABLE(TPL_HIGH_LEVEL);
 
+/**
+ * Packet trace ring, shared by all network interfaces, and number of
+ * records ever written to it
+ */
+STATIC DPAA2_PACKET_TRACE_RECORD gDpaa2PacketTraceRing[DPAA2_PACKET_TRACE_RING_SIZE];
+STATIC volatile UINT32 gDpaa2PacketTraceCount = 0;
+
+/**
+   Records a frame in the packet trace ring, overwriting the oldest record.
+
+   A slot is claimed with an atomic increment, so no lock is taken. The
+   sequence number is written last, so that a reader can tell a record that
+   is being overwritten from a complete one.
+
+   @param Direction        DPAA2_PACKET_TRACE_RX, _TX or _TX_CONFIRM
+   @param FrameBufferAddr  Address of the QBman buffer of the frame
+   @param Data             Pointer to the frame, or NULL
+   @param Length           Frame size in bytes
+
+ **/
+STATIC
+VOID
+Dpaa2PacketTraceRecord (
+  UINT8 Direction,
+  UINT64 FrameBufferAddr,
+  CONST VOID *Data,
+  UINTN Length
+  )
+{
+  DPAA2_PACKET_TRACE_RECORD *Record;
+  UINT32 Sequence;
+
+  Sequence = InterlockedIncrement (&gDpaa2PacketTraceCount);
+  Record = &gDpaa2PacketTraceRing[(Sequence - 1) & (DPAA2_PACKET_TRACE_RING_SIZE - 1)];
+
+  Record->Sequence = 0;
+  MemoryFence ();
+  Record->Timestamp = GetPerformanceCounter ();
+  Record->Direction = Direction;
+  Record->Length = (UINT16)Length;
+  Record->FrameBufferAddr = FrameBufferAddr;
+  if (Data != NULL) {
+    CopyMem (Record->Data, Data, MIN (Length, DPAA2_PACKET_TRACE_DATA_SIZE));
+  }
+
+  MemoryFence ();
+  Record->Sequence = Sequence;
+}
+
+/**
+   Copies the most recent records of the packet trace ring, oldest first.
+
+   Records being overwritten while they are copied are left out: the
+   sequence number of the ring slot is read before and after the copy, and
+   the copy is kept only if both reads return the expected sequence number.
+
+   @param Records     Array where the records are to be copied
+   @param NumRecords  On input, number of entries in Records. On output,
+                      number of records copied.
+
+ **/
+VOID
+Dpaa2McPacketTraceGetRecords (
+  DPAA2_PACKET_TRACE_RECORD *Records,
+  UINT32 *NumRecords
+  )
+{
+  DPAA2_PACKET_TRACE_RECORD *Slot;
+  UINT32 Count;
+  UINT32 Available;
+  UINT32 Sequence;
+  UINT32 SequenceBefore;
+  UINT32 SequenceAfter;
+  UINT32 I;
+  UINT32 Copied;
+
+  Count = gDpaa2PacketTraceCount;
+  Available = MIN (Count, DPAA2_PACKET_TRACE_RING_SIZE);
+  Available = MIN (Available, *NumRecords);
+
+  Copied = 0;
+  for (I = 0; I < Available; I++) {
+    Sequence = Count - Available + I + 1;
+    Slot = &gDpaa2PacketTraceRing[(Sequence - 1) & (DPAA2_PACKET_TRACE_RING_SIZE - 1)];
+
+    SequenceBefore = *(volatile UINT32 *)&Slot->Sequence;
+    MemoryFence ();
+    CopyMem (&Records[Copied], Slot, sizeof (DPAA2_PACKET_TRACE_RECORD));
+    MemoryFence ();
+    SequenceAfter = *(volatile UINT32 *)&Slot->Sequence;
+
+    if (SequenceBefore == Sequence && SequenceAfter == Sequence) {
+      Records[Copied].Sequence = Sequence;
+      Copied++;
+    }
+  }
+
+  *NumRecords = Copied;
+}
+
 STATIC
 EFI_STATUS
 Dpaa2McCreateDprc (
@@ -752,6 +853,161 @@ Dpaa2McSetDpniRxTxBufferLayouts (
 }
 
 
+/**
+ * Release buffers into a QBman buffer pool, retrying while the portal is busy
+ */
+STATIC
+VOID
+Dpaa2QbmanReleaseBuffers (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
+  CONST UINT64 *Buffers,
+  UINT32 NumBuffers
+  )
+{
+  QBMAN_RELEASE_DESC QbmanReleaseDesc;
+  UINT32 TimeoutCount;
+
+  QbmanReleaseDescClear (&QbmanReleaseDesc);
+  QbmanReleaseDescSetBpid (&QbmanReleaseDesc, Dpaa2NetInterface->DpbpHwBufferPoolId);
+  TimeoutCount = QBMAN_BUFFER_RELEASE_TIMEOUT_US;
+  for ( ; ; ) {
+    BOOLEAN ReleaseOk =  QbmanSwPortalReleaseBuffers (&Dpaa2NetInterface->DpioQbmanPortal,
+                                                    &QbmanReleaseDesc,
+                                                    Buffers,
+                                                    NumBuffers);
+    if (ReleaseOk) {
+      break;
+    }
+
+    if (TimeoutCount == 0) {
+      DPAA_ERROR_MSG ("Timeout releasing buffers to QBman for interface 0x%p\n",
+                      Dpaa2NetInterface);
+      break;
+    }
+
+    MicroSecondDelay (100);
+    TimeoutCount -= 100;
+  }
+}
+
+
+/**
+ * Get a Tx buffer from the Tx buffer stash of a network interface,
+ * refilling the stash with a single QBman acquire command if it is empty
+ */
+STATIC
+BOOLEAN
+Dpaa2TxBufferStashGet (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
+  UINT64 *FrameBufferAddr
+  )
+{
+  if (Dpaa2NetInterface->TxBufferStashCount == 0) {
+    Dpaa2NetInterface->TxBufferStashCount =
+      QbmanSwPortalAcquireBuffers (&Dpaa2NetInterface->DpioQbmanPortal,
+                                  Dpaa2NetInterface->DpbpHwBufferPoolId,
+                                  Dpaa2NetInterface->TxBufferStash,
+                                  DPAA2_ETH_TX_BUFFER_STASH_SIZE);
+    if (Dpaa2NetInterface->TxBufferStashCount == 0) {
+      return FALSE;
+    }
+  }
+
+  *FrameBufferAddr =
+    Dpaa2NetInterface->TxBufferStash[--Dpaa2NetInterface->TxBufferStashCount];
+  return TRUE;
+}
+
+
+/**
+ * Return a Tx buffer to the Tx buffer stash of a network interface or,
+ * if the stash is full, to the QBman buffer pool
+ */
+STATIC
+VOID
+Dpaa2TxBufferStashPut (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
+  UINT64 FrameBufferAddr
+  )
+{
+  if (Dpaa2NetInterface->TxBufferStashCount < DPAA2_ETH_TX_BUFFER_STASH_SIZE) {
+    Dpaa2NetInterface->TxBufferStash[Dpaa2NetInterface->TxBufferStashCount++] =
+      FrameBufferAddr;
+  } else {
+    Dpaa2QbmanReleaseBuffers (Dpaa2NetInterface, &FrameBufferAddr, 1);
+  }
+}
+
+
+/**
+ * Return all buffers held in the Tx buffer stash of a network interface
+ * to the QBman buffer pool
+ */
+STATIC
+VOID
+Dpaa2TxBufferStashFlush (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface
+  )
+{
+  if (Dpaa2NetInterface->TxBufferStashCount != 0) {
+    Dpaa2QbmanReleaseBuffers (Dpaa2NetInterface,
+                             Dpaa2NetInterface->TxBufferStash,
+                             Dpaa2NetInterface->TxBufferStashCount);
+    Dpaa2NetInterface->TxBufferStashCount = 0;
+  }
+}
+
+
+/**
+ * Release the buffers of all Rx frames held in the Rx frame cache of a
+ * network interface back to the QBman buffer pool
+ */
+STATIC
+VOID
+Dpaa2NetworkInterfaceFlushRxFrameCache (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface
+  )
+{
+  CONST QBMAN_FRAME_DESC *FrameDesc;
+  UINT64 FrameBufferAddr;
+
+  while (Dpaa2NetInterface->RxFrameCacheCount != 0) {
+    FrameDesc = (CONST QBMAN_FRAME_DESC *)
+      Dpaa2NetInterface->RxFrameCache[Dpaa2NetInterface->RxFrameCacheNext++];
+    Dpaa2NetInterface->RxFrameCacheCount--;
+    FrameBufferAddr = ((UINT64)FrameDesc->Simple.AddressHighWord << 32) +
+                      FrameDesc->Simple.AddressLowWord;
+    Dpaa2QbmanReleaseBuffers (Dpaa2NetInterface, &FrameBufferAddr, 1);
+  }
+
+  Dpaa2NetInterface->RxFrameCacheNext = 0;
+}
+
+
+/**
+ * Release the buffers of all Rx frames still on loan to a consumer back to
+ * the QBman buffer pool. Loan IDs handed out before become invalid.
+ */
+STATIC
+VOID
+Dpaa2NetworkInterfaceFlushRxLoans (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface
+  )
+{
+  if (Dpaa2NetInterface->RxLoanCount != 0) {
+    DPAA_WARN_MSG ("%u Rx buffers still on loan for interface 0x%p\n",
+                   Dpaa2NetInterface->RxLoanCount, Dpaa2NetInterface);
+  }
+
+  while (Dpaa2NetInterface->RxLoanCount != 0) {
+    Dpaa2NetInterface->RxLoanCount--;
+    Dpaa2QbmanReleaseBuffers (Dpaa2NetInterface,
+                              &Dpaa2NetInterface->RxLoanedBuffers[Dpaa2NetInterface->RxLoanCount],
+                              1);
+  }
+}
+
+
 STATIC
 UINT8
 Dpaa2QbmanBufferPoolAdd7 (
@@ -863,6 +1119,11 @@ Dpaa2McInitializeDpbp (
     goto ErrorExitDisableDpbp;
   }
 
+  Dpaa2NetInterface->TxBufferStashCount = 0;
+  Dpaa2NetInterface->RxFrameCacheNext = 0;
+  Dpaa2NetInterface->RxFrameCacheCount = 0;
+  Dpaa2NetInterface->RxLoanCount = 0;
+
   return EFI_SUCCESS;
 
 ErrorExitDisableDpbp:
@@ -1583,6 +1844,14 @@ Dpaa2McShutdownNetworkInterface (
    */
   Dpaa2McShutdownDpni (&Dpaa2NetInterface->DprcMcIo, Dpaa2NetInterface);
 
+  /*
+   * Return stashed Tx buffers and cached Rx frames, so that the buffer pool
+   * can be drained:
+   */
+  Dpaa2TxBufferStashFlush (Dpaa2NetInterface);
+  Dpaa2NetworkInterfaceFlushRxFrameCache (Dpaa2NetInterface);
+  Dpaa2NetworkInterfaceFlushRxLoans (Dpaa2NetInterface);
+
   Dpaa2McShutdownDpbp (&Dpaa2NetInterface->DprcMcIo, Dpaa2NetInterface);
 
   Dpaa2McDestroyDpmac (&Dpaa2NetInterface->DprcMcIo, Dpaa2NetInterface);
@@ -1612,31 +1881,30 @@ Dpaa2McResetNetworkInterface (
 
 
 /**
-   Transmits an Ethernet frame on a DPAA2 network interface
+   Transmits a batch of Ethernet frames on a DPAA2 network interface.
 
-   @param Dpaa2NetInterface    Pointer to DPAA2 network interface control block
-   @param HdrSize              Header size
-   @param BuffSize             Total frame size
-   @param Data                 Pointer to frame buffer
-   @param SrcAddr              Pointer to source MAC address
-   @param DstAddr              Pointer to destination MAC address
-   @param Protocol             Pointer to carried protocol
-   @param QBmanTxBufferAddrOut Pointer to area where QBman buffer address is to be returned
+   QBman Tx buffers are acquired several at a time, only the part of each
+   buffer actually written is cleaned from the data cache, and all the frame
+   descriptors are enqueued with a single multi-enqueue sequence.
 
-   @retval EFI_SUCCESS, on success
+   @param Dpaa2NetInterface    Pointer to DPAA2 network interface control block
+   @param WriopDpmac           Pointer to WRIOP DPMAC object
+   @param TxFrames             Array of frames to transmit
+   @param NumFrames            Number of entries in TxFrames
+   @param NumFramesSent        Pointer to area where the number of frames
+                               enqueued is to be returned. Only the first
+                               *NumFramesSent entries of TxFrames were sent.
+
+   @retval EFI_SUCCESS, if at least one frame was sent
    @retval error code, on failure
  **/
 EFI_STATUS
-Dpaa2McNetworkInterfaceTransmit (
+Dpaa2McNetworkInterfaceTransmitBatch (
   DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
   WRIOP_DPMAC *WriopDpmac,
-  UINTN HdrSize,
-  UINTN BuffSize,
-  VOID *Data,
-  EFI_MAC_ADDRESS *SrcAddr,
-  EFI_MAC_ADDRESS *DstAddr,
-  UINT16 *Protocol,
-  UINT64 *QBmanTxBufferAddrOut
+  DPAA2_TX_FRAME *TxFrames,
+  UINT32 NumFrames,
+  UINT32 *NumFramesSent
   )
 {
   /**
@@ -1644,13 +1912,14 @@ Dpaa2McNetworkInterfaceTransmit (
    */
 # define QBMAN_TX_BUFFER_ENQUEUE_TIMEOUT_US 2000
 
-  EFI_STATUS Status;
   QBMAN_ENQUEUE_DESC QbmanEnqueueDesc;
-  QBMAN_RELEASE_DESC QbmanReleaseDesc;
-  QBMAN_FRAME_DESC QbmanFrameDesc;
+  QBMAN_FRAME_DESC QbmanFrameDescs[DPAA2_ETH_MAX_TX_BATCH_SIZE];
+  DPAA2_TX_FRAME *TxFrame;
   UINT64 FrameBufferAddr;
   UINT32 TimeoutCount;
-  UINT32 NumAcquiredBuffers;
+  UINT32 NumPreparedFrames;
+  UINT32 NumEnqueuedFrames;
+  UINT32 I;
   UINT16 DataOffset;
   DPAA2_QBMAN_PORTAL *DpioQbmanPortal;
   UINT16 HwBufferPoolId;
@@ -1664,124 +1933,233 @@ Dpaa2McNetworkInterfaceTransmit (
   ASSERT (Dpaa2NetInterface->DpniHandle != 0);
   ASSERT (Dpaa2NetInterface->DpbpHandle != 0);
   ASSERT (Dpaa2NetInterface->DprcHandle != 0);
-  ASSERT (Data != NULL);
-  ASSERT (BuffSize >= sizeof (ETHER_HEAD) && BuffSize <= DPAA2_ETH_RX_FRAME_BUFFER_SIZE);
-  ASSERT (HdrSize <= BuffSize);
-  if (HdrSize != 0) {
+  ASSERT (NumFrames != 0 && NumFrames <= DPAA2_ETH_MAX_TX_BATCH_SIZE);
+
+  *NumFramesSent = 0;
+  for (NumPreparedFrames = 0; NumPreparedFrames < NumFrames; NumPreparedFrames++) {
+    TxFrame = &TxFrames[NumPreparedFrames];
+    ASSERT (TxFrame->Data != NULL);
+    ASSERT (TxFrame->BuffSize >= sizeof (ETHER_HEAD) &&
+            TxFrame->BuffSize <= DPAA2_ETH_RX_FRAME_BUFFER_SIZE);
+    ASSERT (TxFrame->HdrSize <= TxFrame->BuffSize);
+
+    if (!Dpaa2TxBufferStashGet (Dpaa2NetInterface, &FrameBufferAddr)) {
+      break;
+    }
+
+    if (TxFrame->HdrSize != 0) {
+      /*
+       * Populate Ethernet header:
+       */
+      ETHER_HEAD *EthernetHeader = (ETHER_HEAD *)TxFrame->Data;
+
+      ASSERT (TxFrame->HdrSize == sizeof (ETHER_HEAD));
+      ASSERT (TxFrame->SrcAddr != NULL);
+      ASSERT (TxFrame->DstAddr != NULL);
+      ASSERT (TxFrame->Protocol != NULL);
+
+      CopyMem (EthernetHeader->DstMac, TxFrame->DstAddr, NET_ETHER_ADDR_LEN);
+      CopyMem (EthernetHeader->SrcMac, TxFrame->SrcAddr, NET_ETHER_ADDR_LEN);
+      EthernetHeader->EtherType = HTONS (*TxFrame->Protocol);
+    }
+
+    /*
+     * Copy UEFI data buffer to QBman buffer:
+     */
+    CopyMem ((VOID *)(FrameBufferAddr + DataOffset), TxFrame->Data, TxFrame->BuffSize);
+
     /*
-     * Populate Ethernet header:
+     * Stash the caller's cookie in the software annotation, so that the
+     * Tx confirmation can be matched without searching:
      */
-    ETHER_HEAD *EthernetHeader = (ETHER_HEAD *)Data;
+    ((DPAA2_ETH_TX_SW_ANNOTATION *)FrameBufferAddr)->TxFrameCookie =
+      TxFrame->TxFrameCookie;
 
-    ASSERT (HdrSize == sizeof (ETHER_HEAD));
-    ASSERT (SrcAddr != NULL);
-    ASSERT (DstAddr != NULL);
-    ASSERT (Protocol != NULL);
+    /*
+     * Only the annotation and the frame data were written:
+     */
+    CleanDcacheRange (FrameBufferAddr,
+                     FrameBufferAddr + DataOffset + TxFrame->BuffSize);
 
-    CopyMem (EthernetHeader->DstMac, DstAddr, NET_ETHER_ADDR_LEN);
-    CopyMem (EthernetHeader->SrcMac, SrcAddr, NET_ETHER_ADDR_LEN);
-    EthernetHeader->EtherType = HTONS (*Protocol);
+    TxFrame->QBmanTxBufferAddr = FrameBufferAddr;
+
+    ZeroMem (&QbmanFrameDescs[NumPreparedFrames], sizeof (QBMAN_FRAME_DESC));
+    QbmanFrameDescs[NumPreparedFrames].Simple.AddressHighWord = FrameBufferAddr >> 32;
+    QbmanFrameDescs[NumPreparedFrames].Simple.AddressLowWord = (UINT32)FrameBufferAddr;
+    QbmanFrameDescs[NumPreparedFrames].Simple.BpidOffset =
+      ((UINT32)(DataOffset & 0x0FFF) << 16) | (UINT32)HwBufferPoolId;
+    QbmanFrameDescs[NumPreparedFrames].Simple.Length = (UINT32)TxFrame->BuffSize;
+    QbmanFrameDescs[NumPreparedFrames].Simple.Control = QBMAN_FD_CTRL_ASAL |
+                                                        QBMAN_FD_CTRL_PTA |
+                                                        QBMAN_FD_CTRL_PTV1;
   }
 
-  NumAcquiredBuffers = QbmanSwPortalAcquireBuffers (DpioQbmanPortal,
-                                                   HwBufferPoolId,
-                                                   &FrameBufferAddr,
-                                                   1);
-  if (NumAcquiredBuffers == 0) {
+  if (NumPreparedFrames == 0) {
     return EFI_NOT_READY;
   }
 
-  /*
-   * Copy UEFI data buffer to QBman buffer:
-   */
-  CopyMem ((VOID *)(FrameBufferAddr + DataOffset), Data, BuffSize);
-
-  CleanDcacheRange ((UINT64)FrameBufferAddr,
-                   (UINT64)FrameBufferAddr + DPAA2_ETH_RX_FRAME_BUFFER_SIZE);
-
-  ZeroMem (&QbmanFrameDesc, sizeof (QbmanFrameDesc));
-  QbmanFrameDesc.Simple.AddressHighWord = FrameBufferAddr >> 32;
-  QbmanFrameDesc.Simple.AddressLowWord = (UINT32)FrameBufferAddr;
-  QbmanFrameDesc.Simple.BpidOffset &= 0xF000FFFF;
-  QbmanFrameDesc.Simple.BpidOffset |= (UINT32)DataOffset << 16;
-  QbmanFrameDesc.Simple.BpidOffset &= 0xFFFF0000;
-  QbmanFrameDesc.Simple.BpidOffset |= (UINT32)HwBufferPoolId;
-  QbmanFrameDesc.Simple.Length = (UINT32)BuffSize;
-  QbmanFrameDesc.Simple.Control = QBMAN_FD_CTRL_ASAL |
-                                  QBMAN_FD_CTRL_PTA |
-          QBMAN_FD_CTRL_PTV1;
-
   QbmanEnqueueDescClear (&QbmanEnqueueDesc);
   QbmanEnqueueDescSetNoOrp (&QbmanEnqueueDesc, FALSE);
   QbmanEnqueueDescSetQueueDest (&QbmanEnqueueDesc,
-                         Dpaa2NetInterface->TxQueueDestinationId,
-                         Dpaa2NetInterface->TxFlowId,
+                               Dpaa2NetInterface->TxQueueDestinationId,
+                               Dpaa2NetInterface->TxFlowId,
                                0);
 
+  NumEnqueuedFrames = 0;
   TimeoutCount = QBMAN_TX_BUFFER_ENQUEUE_TIMEOUT_US;
   for ( ; ; ) {
-    BOOLEAN EnqueueOk = QbmanSwPortalEnqueue (DpioQbmanPortal,
-                                             &QbmanEnqueueDesc,
-                                             &QbmanFrameDesc);
-
-    if (EnqueueOk) {
+    NumEnqueuedFrames += QbmanSwPortalEnqueueMultiple (DpioQbmanPortal,
+                                                      &QbmanEnqueueDesc,
+                                                      &QbmanFrameDescs[NumEnqueuedFrames],
+                                                      NumPreparedFrames - NumEnqueuedFrames);
+    if (NumEnqueuedFrames == NumPreparedFrames) {
       break;
     }
 
     if (TimeoutCount == 0) {
       DPAA_ERROR_MSG ("Timeout enqueueing Tx buffer to QBman for interface 0x%p\n",
                       Dpaa2NetInterface);
-      Status = EFI_NOT_READY;
-      goto ErrorExit;
+      break;
     }
 
     MicroSecondDelay (100);
     TimeoutCount -= 100;
   }
 
+  /*
+   * Give back the buffers of the frames that could not be enqueued:
+   */
+  for (I = NumEnqueuedFrames; I < NumPreparedFrames; I++) {
+    Dpaa2TxBufferStashPut (Dpaa2NetInterface, TxFrames[I].QBmanTxBufferAddr);
+    TxFrames[I].QBmanTxBufferAddr = 0;
+  }
+
   if (gDpaaDebugFlags & DPAA_DEBUG_TRACE_NET_PACKETS) {
-    DPAA_DEBUG_MSG ("Tx: %x:%x:%x:%x:%x:%x|%x:%x:%x:%x:%x:%x|%x|%x|%x%x%x%x\n",
-      SrcAddr->Addr[0], SrcAddr->Addr[1], SrcAddr->Addr[2],
-      SrcAddr->Addr[3], SrcAddr->Addr[4], SrcAddr->Addr[5],
-      DstAddr->Addr[0], DstAddr->Addr[1], DstAddr->Addr[2],
-      DstAddr->Addr[3], DstAddr->Addr[4], DstAddr->Addr[5],
-      *Protocol, BuffSize,
-      ((UINT8 *)Data)[0],
-      ((UINT8 *)Data)[1],
-      ((UINT8 *)Data)[2],
-      ((UINT8 *)Data)[3]);
+    for (I = 0; I < NumEnqueuedFrames; I++) {
+      TxFrame = &TxFrames[I];
+      Dpaa2PacketTraceRecord (DPAA2_PACKET_TRACE_TX,
+                              TxFrame->QBmanTxBufferAddr,
+                              TxFrame->Data,
+                              TxFrame->BuffSize);
+    }
   }
 
-  *QBmanTxBufferAddrOut = FrameBufferAddr;
+  *NumFramesSent = NumEnqueuedFrames;
+  return (NumEnqueuedFrames == 0) ? EFI_NOT_READY : EFI_SUCCESS;
+}
+
+
+/**
+   Transmits an Ethernet frame on a DPAA2 network interface
+
+   @param Dpaa2NetInterface    Pointer to DPAA2 network interface control block
+   @param HdrSize              Header size
+   @param BuffSize             Total frame size
+   @param Data                 Pointer to frame buffer
+   @param SrcAddr              Pointer to source MAC address
+   @param DstAddr              Pointer to destination MAC address
+   @param Protocol             Pointer to carried protocol
+   @param TxFrameCookie        Opaque value to be returned with the Tx completion
+   @param QBmanTxBufferAddrOut Pointer to area where QBman buffer address is to be returned
+
+   @retval EFI_SUCCESS, on success
+   @retval error code, on failure
+ **/
+EFI_STATUS
+Dpaa2McNetworkInterfaceTransmit (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
+  WRIOP_DPMAC *WriopDpmac,
+  UINTN HdrSize,
+  UINTN BuffSize,
+  VOID *Data,
+  EFI_MAC_ADDRESS *SrcAddr,
+  EFI_MAC_ADDRESS *DstAddr,
+  UINT16 *Protocol,
+  UINT32 TxFrameCookie,
+  UINT64 *QBmanTxBufferAddrOut
+  )
+{
+  EFI_STATUS Status;
+  DPAA2_TX_FRAME TxFrame;
+  UINT32 NumFramesSent;
+
+  TxFrame.HdrSize = HdrSize;
+  TxFrame.BuffSize = BuffSize;
+  TxFrame.Data = Data;
+  TxFrame.SrcAddr = SrcAddr;
+  TxFrame.DstAddr = DstAddr;
+  TxFrame.Protocol = Protocol;
+  TxFrame.TxFrameCookie = TxFrameCookie;
+  TxFrame.QBmanTxBufferAddr = 0;
+
+  Status = Dpaa2McNetworkInterfaceTransmitBatch (Dpaa2NetInterface,
+                                                WriopDpmac,
+                                                &TxFrame,
+                                                1,
+                                                &NumFramesSent);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  ASSERT (NumFramesSent == 1);
+  *QBmanTxBufferAddrOut = TxFrame.QBmanTxBufferAddr;
   return EFI_SUCCESS;
+}
 
-ErrorExit:
-  /*
-   * Release Tx buffer into the QBMAN:
-   */
-  QbmanReleaseDescClear (&QbmanReleaseDesc);
-  QbmanReleaseDescSetBpid (&QbmanReleaseDesc, HwBufferPoolId);
-  TimeoutCount = QBMAN_BUFFER_RELEASE_TIMEOUT_US;
-  for ( ; ; ) {
-    BOOLEAN ReleaseOk =  QbmanSwPortalReleaseBuffers (DpioQbmanPortal,
-                                                    &QbmanReleaseDesc,
-                                                    &FrameBufferAddr,
-                                                    1);
-    if (ReleaseOk) {
-      break;
-    }
 
-    if (TimeoutCount == 0) {
-      DPAA_ERROR_MSG ("Timeout releasing Tx buffer to QBman for interface 0x%p\n",
-                      Dpaa2NetInterface);
-      break;
+/**
+ * Check the frame annotation status of a received frame, if present
+ *
+ * @retval TRUE, if the frame was received without errors
+ */
+STATIC
+BOOLEAN
+Dpaa2NetworkInterfaceCheckRxFrame (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
+  const QBMAN_FRAME_DESC *FrameDesc,
+  UINT64 FrameBufferAddr
+  )
+{
+  UINT32 FrameStatus;
+  QBMAN_FRAME_ANNOTATION_STATUS *FrameAnnotationStatus;
+
+  if (FrameDesc->Simple.FrameContext & QBMAN_FD_FRC_FASV) {
+    /*
+     * Check frame annotation status:
+     */
+    FrameAnnotationStatus = (QBMAN_FRAME_ANNOTATION_STATUS *)
+      (FrameBufferAddr + Dpaa2NetInterface->FramePrivateDataSize);
+
+    FrameStatus = FrameAnnotationStatus->Status;
+    if (FrameStatus & QBMAN_ETH_RX_ERROR_MASK) {
+      DPAA_ERROR_MSG ("Frame received with errors: 0x%08x\n",
+          FrameStatus & QBMAN_ETH_RX_ERROR_MASK);
+      return FALSE;
     }
 
-    MicroSecondDelay (100);
-    TimeoutCount -= 100;
+    if (FrameStatus & QBMAN_ETH_RX_UNSUPPORTED_MASK) {
+      DPAA_ERROR_MSG ("Frame received with unsupported features: 0x%08x\n",
+          FrameStatus & QBMAN_ETH_RX_UNSUPPORTED_MASK);
+      return FALSE;
+    }
   }
 
-  return Status;
+  return TRUE;
+}
+
+
+/**
+ * Release the buffer of a received frame into the QBman
+ */
+STATIC
+VOID
+Dpaa2NetworkInterfaceReleaseRxBuffer (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
+  UINT64 FrameBufferAddr
+  )
+{
+  CleanDcacheRange (FrameBufferAddr, FrameBufferAddr + DPAA2_ETH_RX_FRAME_BUFFER_SIZE);
+  Dpaa2QbmanReleaseBuffers (Dpaa2NetInterface, &FrameBufferAddr, 1);
 }
 
 
@@ -1797,44 +2175,21 @@ Dppa2NetworkInterfaceReceiveFrame (
   UINT16 *Protocol
   )
 {
-  UINT32 TimeoutCount;
   UINT64 FrameBufferAddr;
   UINT16 FrameDataOffset;
   UINT32 FrameDataLength;
-  UINT32 FrameStatus;
-  QBMAN_FRAME_ANNOTATION_STATUS *FrameAnnotationStatus;
-  QBMAN_RELEASE_DESC QbmanReleaseDesc;
   ETHER_HEAD *EthernetHeader;
-  DPAA2_QBMAN_PORTAL *DpioQbmanPortal;
   UINT32 DataSize;
 
   DataSize = 0;
-  DpioQbmanPortal = &Dpaa2NetInterface->DpioQbmanPortal;
   FrameBufferAddr = ((UINT64)FrameDesc->Simple.AddressHighWord << 32) +
                     FrameDesc->Simple.AddressLowWord;
 
   FrameDataOffset = (FrameDesc->Simple.BpidOffset >> 16) & 0x0FFF;
   FrameDataLength = FrameDesc->Simple.Length;
 
-  if (FrameDesc->Simple.FrameContext & QBMAN_FD_FRC_FASV) {
-    /*
-     * Check frame annotation status:
-     */
-    FrameAnnotationStatus = (QBMAN_FRAME_ANNOTATION_STATUS *)
-      (FrameBufferAddr + Dpaa2NetInterface->FramePrivateDataSize);
-
-    FrameStatus = FrameAnnotationStatus->Status;
-    if (FrameStatus & QBMAN_ETH_RX_ERROR_MASK) {
-      DPAA_ERROR_MSG ("Frame received with errors: 0x%08x\n",
-          FrameStatus & QBMAN_ETH_RX_ERROR_MASK);
-      goto CommonExit;
-    }
-
-    if (FrameStatus & QBMAN_ETH_RX_UNSUPPORTED_MASK) {
-      DPAA_ERROR_MSG ("Frame received with unsupported features: 0x%08x\n",
-          FrameStatus & QBMAN_ETH_RX_UNSUPPORTED_MASK);
-      goto CommonExit;
-    }
+  if (!Dpaa2NetworkInterfaceCheckRxFrame (Dpaa2NetInterface, FrameDesc, FrameBufferAddr)) {
+    goto CommonExit;
   }
 
   if (*BuffSize < FrameDataLength) {
@@ -1868,37 +2223,99 @@ Dppa2NetworkInterfaceReceiveFrame (
 
 CommonExit:
   *BuffSize = DataSize;
-  CleanDcacheRange (FrameBufferAddr, FrameBufferAddr + DPAA2_ETH_RX_FRAME_BUFFER_SIZE);
 
   /*
    * Release Rx buffer into the QBMAN:
    */
-  QbmanReleaseDescClear (&QbmanReleaseDesc);
-  QbmanReleaseDescSetBpid (&QbmanReleaseDesc, Dpaa2NetInterface->DpbpHwBufferPoolId);
-  TimeoutCount = QBMAN_BUFFER_RELEASE_TIMEOUT_US;
-  for ( ; ; ) {
-    BOOLEAN ReleaseOk =  QbmanSwPortalReleaseBuffers (DpioQbmanPortal,
-                                                    &QbmanReleaseDesc,
-                                                    &FrameBufferAddr,
-                                                    1);
-    if (ReleaseOk) {
-      break;
+  Dpaa2NetworkInterfaceReleaseRxBuffer (Dpaa2NetInterface, FrameBufferAddr);
+}
+
+
+/**
+ * Pull a burst of Rx frames from QBman into the Rx frame cache of a network
+ * interface. All DQRR entries produced by the volatile dequeue are drained
+ * and consumed in bulk, so the portal is free for the next pull command.
+ */
+STATIC
+EFI_STATUS
+Dpaa2NetworkInterfaceFillRxFrameCache (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface
+  )
+{
+  UINT32 TimeoutCount;
+  CONST QBMAN_DEQUEUE_ENTRY *DequeueEntries[QBMAN_DQRR_SIZE];
+  UINT32 NumDequeueEntries;
+  UINT32 DequeueEntryFlags;
+  UINT32 I;
+  BOOLEAN PullOk;
+  BOOLEAN PullDone;
+  QBMAN_PULL_DESC PullDesc;
+  DPAA2_QBMAN_PORTAL *DpioQbmanPortal;
+
+  ASSERT (sizeof (Dpaa2NetInterface->RxFrameCache[0]) == sizeof (QBMAN_FRAME_DESC));
+  ASSERT (DPAA2_ETH_RX_FRAME_CACHE_SIZE <= QBMAN_DQRR_SIZE);
+  ASSERT (Dpaa2NetInterface->RxFrameCacheCount == 0);
+
+  Dpaa2NetInterface->RxFrameCacheNext = 0;
+  DpioQbmanPortal = &Dpaa2NetInterface->DpioQbmanPortal;
+  QbmanPullDescClear (&PullDesc);
+  QbmanPullDescSetNumframes (&PullDesc, DPAA2_ETH_RX_FRAME_CACHE_SIZE);
+  QbmanPullDescSetFrameDesc (&PullDesc,
+                            Dpaa2NetInterface->RxDefaultFrameQueueId);
+  PullOk = QbmanSwPortalPull (DpioQbmanPortal, &PullDesc);
+  if (!PullOk) {
+    return EFI_NOT_READY;
+  }
+
+  PullDone = FALSE;
+  TimeoutCount = QBMAN_DEQUEUE_TIMEOUT_US;
+  while (!PullDone) {
+    NumDequeueEntries = QbmanSwPortalGetNextDqrrEntries (DpioQbmanPortal,
+                                                        DequeueEntries,
+                                                        QBMAN_DQRR_SIZE);
+    if (NumDequeueEntries == 0) {
+      if (TimeoutCount == 0) {
+        DPAA_ERROR_MSG ("Timeout dequeueing Rx frame from QBman for interface 0x%p\n",
+                        Dpaa2NetInterface);
+        break;
+      }
+
+      MicroSecondDelay (100);
+      TimeoutCount -= 100;
+      continue;
     }
 
-    if (TimeoutCount == 0) {
-      DPAA_ERROR_MSG ("Timeout releasing Rx buffer to QBman for interface 0x%p\n",
-                      Dpaa2NetInterface);
-      break;
+    for (I = 0; I < NumDequeueEntries; I++) {
+      DequeueEntryFlags = QbmanGetFlagsFromDequeueEntry (DequeueEntries[I]);
+      if ((DequeueEntryFlags & QBMAN_DEQUEUE_STAT_VALIDFRAME) != 0 &&
+          Dpaa2NetInterface->RxFrameCacheCount < DPAA2_ETH_RX_FRAME_CACHE_SIZE) {
+        CopyMem (Dpaa2NetInterface->RxFrameCache[Dpaa2NetInterface->RxFrameCacheCount++],
+                 QbmanGetFrameDescFromDequeueEntry (DequeueEntries[I]),
+                 sizeof (QBMAN_FRAME_DESC));
+      }
+
+      /*
+       * The last response to a volatile dequeue has the expired flag set:
+       */
+      if ((DequeueEntryFlags & QBMAN_DEQUEUE_STAT_EXPIRED) != 0) {
+        PullDone = TRUE;
+      }
     }
 
-    MicroSecondDelay (100);
-    TimeoutCount -= 100;
+    QbmanSwPortalConsumeDqrrEntries (DpioQbmanPortal,
+                                    DequeueEntries,
+                                    NumDequeueEntries);
   }
+
+  return (Dpaa2NetInterface->RxFrameCacheCount == 0) ? EFI_NOT_READY : EFI_SUCCESS;
 }
 
 
 /**
-   Receives an Ethernet frame on a DPAA2 network interface
+   Receives an Ethernet frame on a DPAA2 network interface.
+
+   Frames are pulled from QBman in bursts of up to DPAA2_ETH_RX_FRAME_CACHE_SIZE
+   and later calls are served from the Rx frame cache of the interface.
 
    @param Dpaa2NetInterface Pointer to DPAA2 network interface control block
    @param BuffSize          Pointer to frame size
@@ -1908,6 +2325,7 @@ CommonExit:
    @param Protocol          Pointer to carried protocol
 
    @retval EFI_SUCCESS, on success
+   @retval EFI_NOT_READY, if no frame has been received
    @retval error code, on failure
  **/
 EFI_STATUS
@@ -1921,51 +2339,22 @@ Dpaa2McNetworkInterfaceReceive (
   UINT16 *Protocol
   )
 {
-  UINT32 TimeoutCount;
-  const QBMAN_DEQUEUE_ENTRY *DequeueEntry;
-  const QBMAN_FRAME_DESC *FrameDesc;
-  UINT32 DequeueEntryFlags;
-  BOOLEAN PullOk;
-  QBMAN_PULL_DESC PullDesc;
-  DPAA2_QBMAN_PORTAL *DpioQbmanPortal;
-
-  DpioQbmanPortal = &Dpaa2NetInterface->DpioQbmanPortal;
-  QbmanPullDescClear (&PullDesc);
-  QbmanPullDescSetNumframes (&PullDesc, 1);
-  QbmanPullDescSetFrameDesc (&PullDesc,
-                            Dpaa2NetInterface->RxDefaultFrameQueueId);
-  PullOk = QbmanSwPortalPull (DpioQbmanPortal, &PullDesc);
-  if (!PullOk) {
-    return EFI_NOT_READY;
-  }
-
-  TimeoutCount = QBMAN_DEQUEUE_TIMEOUT_US;
-  for ( ; ; ) {
-    DequeueEntry = QbmanSwPortalGetNextDqrrEntry (DpioQbmanPortal);
-    if (DequeueEntry != NULL) {
-      break;
-    }
+  EFI_STATUS Status;
+  CONST QBMAN_FRAME_DESC *FrameDesc;
 
-    if (TimeoutCount == 0) {
-      DPAA_ERROR_MSG ("Timeout dequeueing Rx frame from QBman for interface 0x%p\n",
-                      Dpaa2NetInterface);
-      return EFI_NOT_READY;
+  if (Dpaa2NetInterface->RxFrameCacheCount == 0) {
+    Status = Dpaa2NetworkInterfaceFillRxFrameCache (Dpaa2NetInterface);
+    if (EFI_ERROR (Status)) {
+      return Status;
     }
-
-    MicroSecondDelay (100);
-    TimeoutCount -= 100;
-  }
-
-  DequeueEntryFlags = QbmanGetFlagsFromDequeueEntry (DequeueEntry);
-  if ((DequeueEntryFlags & QBMAN_DEQUEUE_STAT_VALIDFRAME) == 0) {
-    QbmanSwPortalConsumeDqrrEntry (DpioQbmanPortal, DequeueEntry);
-    return EFI_DEVICE_ERROR;
   }
 
   /*
    * Receive frame:
    */
-  FrameDesc = QbmanGetFrameDescFromDequeueEntry (DequeueEntry);
+  FrameDesc = (CONST QBMAN_FRAME_DESC *)
+    Dpaa2NetInterface->RxFrameCache[Dpaa2NetInterface->RxFrameCacheNext++];
+  Dpaa2NetInterface->RxFrameCacheCount--;
   Dppa2NetworkInterfaceReceiveFrame (Dpaa2NetInterface,
                                     FrameDesc,
                                     BuffSize,
@@ -1973,21 +2362,126 @@ Dpaa2McNetworkInterfaceReceive (
                                     SrcAddr,
                                     DstAddr,
                                     Protocol);
-  QbmanSwPortalConsumeDqrrEntry (DpioQbmanPortal, DequeueEntry);
 
   if (gDpaaDebugFlags & DPAA_DEBUG_TRACE_NET_PACKETS) {
-    DPAA_DEBUG_MSG ("Rx: %x:%x:%x:%x:%x:%x|%x:%x:%x:%x:%x:%x|%x|%x|%x%x%x%x\n",
-      SrcAddr->Addr[0], SrcAddr->Addr[1], SrcAddr->Addr[2],
-      SrcAddr->Addr[3], SrcAddr->Addr[4], SrcAddr->Addr[5],
-      DstAddr->Addr[0], DstAddr->Addr[1], DstAddr->Addr[2],
-      DstAddr->Addr[3], DstAddr->Addr[4], DstAddr->Addr[5],
-      *Protocol, *BuffSize,
-      ((UINT8 *)Data)[0],
-      ((UINT8 *)Data)[1],
-      ((UINT8 *)Data)[2],
-      ((UINT8 *)Data)[3]);
+    Dpaa2PacketTraceRecord (DPAA2_PACKET_TRACE_RX,
+                            ((UINT64)FrameDesc->Simple.AddressHighWord << 32) +
+                            FrameDesc->Simple.AddressLowWord,
+                            Data,
+                            *BuffSize);
+  }
+
+  return EFI_SUCCESS;
+}
+
+
+/**
+   Receives an Ethernet frame on a DPAA2 network interface, without copying
+   it out of its QBman buffer.
+
+   The buffer is kept out of the buffer pool until it is given back with
+   Dpaa2McNetworkInterfaceReturnLoan (). Frames received with errors are
+   dropped.
+
+   @param Dpaa2NetInterface Pointer to DPAA2 network interface control block
+   @param FrameData         Pointer to frame data, starting with the Ethernet header
+   @param FrameSize         Pointer to frame size
+   @param LoanId            Pointer to value identifying the loaned buffer
+
+   @retval EFI_SUCCESS, on success
+   @retval EFI_NOT_READY, if no frame has been received
+   @retval EFI_OUT_OF_RESOURCES, if DPAA2_ETH_MAX_RX_LOANS buffers are on loan
+   @retval error code, on failure
+ **/
+EFI_STATUS
+Dpaa2McNetworkInterfaceReceiveLoan (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
+  VOID                    **FrameData,
+  UINTN                   *FrameSize,
+  UINT64                  *LoanId
+  )
+{
+  EFI_STATUS Status;
+  CONST QBMAN_FRAME_DESC *FrameDesc;
+  UINT64 FrameBufferAddr;
+  UINT16 FrameDataOffset;
+
+  if (Dpaa2NetInterface->RxLoanCount == DPAA2_ETH_MAX_RX_LOANS) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  for ( ; ; ) {
+    if (Dpaa2NetInterface->RxFrameCacheCount == 0) {
+      Status = Dpaa2NetworkInterfaceFillRxFrameCache (Dpaa2NetInterface);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+    }
+
+    FrameDesc = (CONST QBMAN_FRAME_DESC *)
+      Dpaa2NetInterface->RxFrameCache[Dpaa2NetInterface->RxFrameCacheNext++];
+    Dpaa2NetInterface->RxFrameCacheCount--;
+
+    FrameBufferAddr = ((UINT64)FrameDesc->Simple.AddressHighWord << 32) +
+                      FrameDesc->Simple.AddressLowWord;
+    if (Dpaa2NetworkInterfaceCheckRxFrame (Dpaa2NetInterface, FrameDesc, FrameBufferAddr)) {
+      break;
+    }
+
+    Dpaa2NetworkInterfaceReleaseRxBuffer (Dpaa2NetInterface, FrameBufferAddr);
+  }
+
+  FrameDataOffset = (FrameDesc->Simple.BpidOffset >> 16) & 0x0FFF;
+  *FrameData = (VOID *)(FrameBufferAddr + FrameDataOffset);
+  *FrameSize = FrameDesc->Simple.Length;
+  *LoanId = FrameBufferAddr;
+
+  if (gDpaaDebugFlags & DPAA_DEBUG_TRACE_NET_PACKETS) {
+    Dpaa2PacketTraceRecord (DPAA2_PACKET_TRACE_RX,
+                            FrameBufferAddr,
+                            *FrameData,
+                            *FrameSize);
   }
 
+  Dpaa2NetInterface->RxLoanedBuffers[Dpaa2NetInterface->RxLoanCount++] = FrameBufferAddr;
+  return EFI_SUCCESS;
+}
+
+
+/**
+   Gives back the buffer of a frame received with
+   Dpaa2McNetworkInterfaceReceiveLoan () to the QBman buffer pool
+
+   @param Dpaa2NetInterface Pointer to DPAA2 network interface control block
+   @param LoanId            Value returned for the frame by
+                            Dpaa2McNetworkInterfaceReceiveLoan ()
+
+   @retval EFI_SUCCESS, on success
+   @retval EFI_INVALID_PARAMETER, if LoanId does not refer to a loaned buffer
+ **/
+EFI_STATUS
+Dpaa2McNetworkInterfaceReturnLoan (
+  DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
+  UINT64                  LoanId
+  )
+{
+  UINT32 I;
+
+  for (I = 0; I < Dpaa2NetInterface->RxLoanCount; I++) {
+    if (Dpaa2NetInterface->RxLoanedBuffers[I] == LoanId) {
+      break;
+    }
+  }
+
+  if (I == Dpaa2NetInterface->RxLoanCount) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Dpaa2NetInterface->RxLoanCount--;
+  Dpaa2NetInterface->RxLoanedBuffers[I] =
+    Dpaa2NetInterface->RxLoanedBuffers[Dpaa2NetInterface->RxLoanCount];
+
+  Dpaa2NetworkInterfaceReleaseRxBuffer (Dpaa2NetInterface, LoanId);
   return EFI_SUCCESS;
 }
 
@@ -2078,10 +2572,12 @@ Dpaa2McRemoveMulticastMacAddress (
 
 /**
    Check if a Tx completion (confirmation) has been received. If so, it returns
-   the address of the corresponding QBman Tx buffer.
+   the address of the corresponding QBman Tx buffer and the cookie that was
+   passed to Dpaa2McNetworkInterfaceTransmit () for it.
 
    @param Dpaa2NetInterface    Pointer to DPAA2 network interface control block
    @param QBmanTxBufferAddrOut Pointer to area where QBman buffer address is to be returned
+   @param TxFrameCookieOut     Pointer to area where the Tx frame cookie is to be returned
 
    @retval EFI_SUCCESS, on success
    @retval error code, on failure
@@ -2090,11 +2586,11 @@ Dpaa2McRemoveMulticastMacAddress (
 EFI_STATUS
 Dpaa2McNetworkInterfaceCheckTxCompletion (
   DPAA2_NETWORK_INTERFACE *Dpaa2NetInterface,
-  UINT64 *QBmanTxBufferAddrOut
+  UINT64 *QBmanTxBufferAddrOut,
+  UINT32 *TxFrameCookieOut
   )
 {
   QBMAN_PULL_DESC PullDesc;
-  QBMAN_RELEASE_DESC QbmanReleaseDesc;
   UINT64 FrameBufferAddr;
   UINT32 TimeoutCount;
   BOOLEAN PullOk;
@@ -2141,31 +2637,22 @@ Dpaa2McNetworkInterfaceCheckTxCompletion (
       ((UINT64)FrameDesc->Simple.AddressHighWord << 32) +
       FrameDesc->Simple.AddressLowWord;
 
-  /*
-   * Release Tx buffer into the QBMAN:
-   */
-  QbmanReleaseDescClear (&QbmanReleaseDesc);
-  QbmanReleaseDescSetBpid (&QbmanReleaseDesc, Dpaa2NetInterface->DpbpHwBufferPoolId);
-  TimeoutCount = QBMAN_BUFFER_RELEASE_TIMEOUT_US;
-  for ( ; ; ) {
-    BOOLEAN ReleaseOk =  QbmanSwPortalReleaseBuffers (DpioQbmanPortal,
-                                                    &QbmanReleaseDesc,
-                                                    &FrameBufferAddr,
-                                                    1);
-    if (ReleaseOk) {
-      break;
-    }
-
-    if (TimeoutCount == 0) {
-      DPAA_ERROR_MSG ("Timeout releasing Rx buffer to QBman for interface 0x%p\n",
-                      Dpaa2NetInterface);
-      break;
-    }
+  *TxFrameCookieOut =
+      ((DPAA2_ETH_TX_SW_ANNOTATION *)FrameBufferAddr)->TxFrameCookie;
 
-    MicroSecondDelay (100);
-    TimeoutCount -= 100;
+  if (gDpaaDebugFlags & DPAA_DEBUG_TRACE_NET_PACKETS) {
+    Dpaa2PacketTraceRecord (DPAA2_PACKET_TRACE_TX_CONFIRM,
+                            FrameBufferAddr,
+                            NULL,
+                            FrameDesc->Simple.Length);
   }
 
+  /*
+   * Recycle Tx buffer for a later Tx frame, saving both the release and
+   * the acquire commands:
+   */
+  Dpaa2TxBufferStashPut (Dpaa2NetInterface, FrameBufferAddr);
+
   QbmanSwPortalConsumeDqrrEntry (DpioQbmanPortal, DequeueEntry);
   *QBmanTxBufferAddrOut = FrameBufferAddr;
   return EFI_SUCCESS;
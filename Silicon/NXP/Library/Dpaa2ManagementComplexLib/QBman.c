@@ -769,6 +769,62 @@ QbmanSwPortalEnqueue (
 }
 
 
+/**
+  Enqueue several frame descriptors to the same destination in QBman,
+  taking the portal lock only once
+
+   @param QbmanPortal Pointer to DPIO QBman portal
+   @param QbmanEnqueueDesc Pointer to QBman enqueue descriptor
+   @param QbmanFrameDescs Array of QBman frame descriptors
+   @param NumFrames Number of entries in QbmanFrameDescs
+
+   @retval Number of frame descriptors enqueued (0 if QBman portal is busy)
+**/
+UINT32
+QbmanSwPortalEnqueueMultiple (
+  DPAA2_QBMAN_PORTAL *QbmanPortal,
+  CONST QBMAN_ENQUEUE_DESC *QbmanEnqueueDesc,
+  CONST QBMAN_FRAME_DESC *QbmanFrameDescs,
+  UINT32 NumFrames
+  )
+{
+  UINT32 *CmdBuf;
+  UINT32 *CacheLine;
+  UINT32 Eqar;
+  UINT32 I;
+
+  CacheLine = (UINT32 *)QbmanEnqueueDesc;
+  EfiAcquireLock (&QbmanPortal->QbmanPortalLock);
+
+  for (I = 0; I < NumFrames; I++) {
+    /*
+     * Each successful read of EQAR allocates one EQCR entry. Stop as soon
+     * as the EQCR is full:
+     */
+    Eqar = QbmanCacheInhibitedRead (QbmanPortal, QBMAN_PORTAL_CACHE_INHIBITED_EQAR);
+    if (!EQAR_SUCCESS (Eqar)) {
+      break;
+    }
+
+    CmdBuf = QbmanCacheEnabledWriteStart (
+         QbmanPortal,
+         QBMAN_PORTAL_CACHE_ENABLED_EQCR (EQAR_IDX (Eqar)));
+
+    CopyMem (&CmdBuf[1], &CacheLine[1], 7*sizeof (UINT32));
+    CopyMem (&CmdBuf[8], &QbmanFrameDescs[I], sizeof (QbmanFrameDescs[I]));
+    ArmDataMemoryBarrier ();
+
+    CmdBuf[0] = CacheLine[0] | EQAR_VB (Eqar);
+    QbmanCacheEnabledWriteComplete (QbmanPortal,
+                              QBMAN_PORTAL_CACHE_ENABLED_EQCR (EQAR_IDX (Eqar)),
+                              CmdBuf);
+  }
+
+  EfiReleaseLock (&QbmanPortal->QbmanPortalLock);
+  return I;
+}
+
+
 STATIC
 VOID
 AtomicInt32Increment (
@@ -816,14 +872,13 @@ STATIC CONST QBMAN_ATTR_LOCATION gDequeueResponseRingRespLocation = QBMAN_ATTR_L
 STATIC CONST QBMAN_ATTR_LOCATION gDequeueResponseRingStatLocation = QBMAN_ATTR_LOCATION_INIT (0, 8, 8);
 
 /**
- * Returns a DQRR (Dequeue Response Ring) entry only once, so repeated calls can
- * return a sequence of DQRR entries, without requiring they be consumed
- * immediately or in any particular order. Returns NULL if there are no
- * unconsumed DQRR entries.
+ * Returns the next DQRR (Dequeue Response Ring) entry, or NULL if there are
+ * no unconsumed DQRR entries. Caller must hold the QBman portal lock.
  */
+STATIC
 CONST
 QBMAN_DEQUEUE_ENTRY *
-QbmanSwPortalGetNextDqrrEntry (
+QbmanSwPortalPollDqrr (
   DPAA2_QBMAN_PORTAL *QbmanPortal
   )
 {
@@ -844,7 +899,6 @@ QbmanSwPortalGetNextDqrrEntry (
   CONST QBMAN_DEQUEUE_ENTRY *DequeueEntry;
   CONST UINT32 *ResultBuf;
 
-  EfiAcquireLock (&QbmanPortal->QbmanPortalLock);
   DequeueEntry = QbmanCacheEnabledRead (
                   QbmanPortal,
                   QBMAN_PORTAL_CACHE_ENABLED_DQRR (QbmanPortal->Dqrr.NextIdx));
@@ -865,7 +919,6 @@ QbmanSwPortalGetNextDqrrEntry (
       QbmanPortal,
       QBMAN_PORTAL_CACHE_ENABLED_DQRR (QbmanPortal->Dqrr.NextIdx));
 
-    EfiReleaseLock (&QbmanPortal->QbmanPortalLock);
     return NULL;
   }
 
@@ -895,11 +948,61 @@ QbmanSwPortalGetNextDqrrEntry (
     QbmanPortal,
     QBMAN_PORTAL_CACHE_ENABLED_DQRR (QbmanPortal->Dqrr.NextIdx));
 
+  return DequeueEntry;
+}
+
+
+/**
+ * Returns a DQRR (Dequeue Response Ring) entry only once, so repeated calls can
+ * return a sequence of DQRR entries, without requiring they be consumed
+ * immediately or in any particular order. Returns NULL if there are no
+ * unconsumed DQRR entries.
+ */
+CONST
+QBMAN_DEQUEUE_ENTRY *
+QbmanSwPortalGetNextDqrrEntry (
+  DPAA2_QBMAN_PORTAL *QbmanPortal
+  )
+{
+  CONST QBMAN_DEQUEUE_ENTRY *DequeueEntry;
+
+  EfiAcquireLock (&QbmanPortal->QbmanPortalLock);
+  DequeueEntry = QbmanSwPortalPollDqrr (QbmanPortal);
   EfiReleaseLock (&QbmanPortal->QbmanPortalLock);
   return DequeueEntry;
 }
 
 
+/**
+ * Returns up to MaxEntries DQRR (Dequeue Response Ring) entries in a burst,
+ * taking the QBman portal lock only once. Each DQRR entry has its own
+ * shadow cache line, so all returned entries remain valid until consumed.
+ *
+ * @retval Number of entries stored in DequeueEntries (0 if DQRR is empty)
+ */
+UINT32
+QbmanSwPortalGetNextDqrrEntries (
+  DPAA2_QBMAN_PORTAL *QbmanPortal,
+  CONST QBMAN_DEQUEUE_ENTRY **DequeueEntries,
+  UINT32 MaxEntries
+  )
+{
+  UINT32 NumEntries;
+
+  ASSERT (MaxEntries <= QBMAN_DQRR_SIZE);
+  EfiAcquireLock (&QbmanPortal->QbmanPortalLock);
+  for (NumEntries = 0; NumEntries < MaxEntries; NumEntries++) {
+    DequeueEntries[NumEntries] = QbmanSwPortalPollDqrr (QbmanPortal);
+    if (DequeueEntries[NumEntries] == NULL) {
+      break;
+    }
+  }
+
+  EfiReleaseLock (&QbmanPortal->QbmanPortalLock);
+  return NumEntries;
+}
+
+
 /**
  * Consume DQRR entries previously returned from QbmanSwPortalGetNextDqrrEntry ()
  */
@@ -915,6 +1018,27 @@ QbmanSwPortalConsumeDqrrEntry (
 }
 
 
+/**
+ * Consume a burst of DQRR entries previously returned from
+ * QbmanSwPortalGetNextDqrrEntries ()
+ */
+VOID
+QbmanSwPortalConsumeDqrrEntries (
+  DPAA2_QBMAN_PORTAL *QbmanPortal,
+  CONST QBMAN_DEQUEUE_ENTRY **DequeueEntries,
+  UINT32 NumEntries
+  )
+{
+  UINT32 I;
+
+  for (I = 0; I < NumEntries; I++) {
+    QbmanCacheInhibitedWrite (QbmanPortal,
+                             QBMAN_PORTAL_CACHE_INHIBITED_DCAP,
+                             QBMAN_DEQUEUE_IDX (DequeueEntries[I]));
+  }
+}
+
+
 UINT32
 QbmanGetFlagsFromDequeueEntry (
   CONST QBMAN_DEQUEUE_ENTRY *DequeueEntry
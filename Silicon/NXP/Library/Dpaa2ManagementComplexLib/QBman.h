@@ -31,6 +31,18 @@
  */
 #define DPAA2_ETH_FRAME_SW_ANNOTATION_SIZE  64
 
+/**
+ * Layout of the software annotation of a Tx frame buffer. It is passed
+ * through to the Tx confirmation untouched (QBMAN_FD_CTRL_PTA).
+ */
+typedef struct _DPAA2_ETH_TX_SW_ANNOTATION {
+  /**
+   * Opaque value supplied by the caller of Dpaa2McNetworkInterfaceTransmit ()
+   * and handed back by Dpaa2McNetworkInterfaceCheckTxCompletion ()
+   */
+  UINT32 TxFrameCookie;
+} DPAA2_ETH_TX_SW_ANNOTATION;
+
 #define DPAA2_ETH_NUM_FRAME_BUFFERS  (7 * 7)
 #define DPAA2_ETH_REFILL_THRESHOLD  (DPAA2_ETH_NUM_FRAME_BUFFERS / 2)
 
@@ -334,17 +346,39 @@ QbmanSwPortalEnqueue (
   const QBMAN_FRAME_DESC *QbmanFrameDesc
   );
 
+UINT32
+QbmanSwPortalEnqueueMultiple (
+  DPAA2_QBMAN_PORTAL *QbmanPortal,
+  const QBMAN_ENQUEUE_DESC *QbmanEnqueueDesc,
+  const QBMAN_FRAME_DESC *QbmanFrameDescs,
+  UINT32 NumFrames
+  );
+
 const QBMAN_DEQUEUE_ENTRY *
 QbmanSwPortalGetNextDqrrEntry (
   DPAA2_QBMAN_PORTAL *QbmanPortal
   );
 
+UINT32
+QbmanSwPortalGetNextDqrrEntries (
+  DPAA2_QBMAN_PORTAL *QbmanPortal,
+  const QBMAN_DEQUEUE_ENTRY **DequeueEntries,
+  UINT32 MaxEntries
+  );
+
 VOID
 QbmanSwPortalConsumeDqrrEntry (
   DPAA2_QBMAN_PORTAL *QbmanPortal,
   const QBMAN_DEQUEUE_ENTRY *DequeueEntry
   );
 
+VOID
+QbmanSwPortalConsumeDqrrEntries (
+  DPAA2_QBMAN_PORTAL *QbmanPortal,
+  const QBMAN_DEQUEUE_ENTRY **DequeueEntries,
+  UINT32 NumEntries
+  );
+
 UINT32
 QbmanGetFlagsFromDequeueEntry (
   const QBMAN_DEQUEUE_ENTRY *DequeueEntry
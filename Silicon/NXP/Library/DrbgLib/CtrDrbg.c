@@ -0,0 +1,303 @@
+/** CtrDrbg.c
+  CTR_DRBG mechanism of SP800-90A section 10.2, using AES-256 and the block
+  cipher derivation function.
+
+  Copyright 2020 NXP
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DrbgLibInternal.h"
+
+#define CTR_DRBG_SEED_BYTES   (DRBG_CTR_KEY_BYTES + DRBG_CTR_BLOCK_BYTES)
+
+//
+// CryptoContext holds two AES contexts: the first one is keyed with the DRBG
+// Key, the second one is used by the derivation function.
+//
+#define CTR_DRBG_AES(State)     ((State)->CryptoContext)
+#define CTR_DRBG_DF_AES(State)  ((UINT8 *)(State)->CryptoContext + AesGetContextSize ())
+
+STATIC CONST UINT8 mZeroBlock[DRBG_CTR_BLOCK_BYTES];
+
+//
+// Streaming BCC function of SP800-90A 10.3.3, which is a CBC-MAC with a zero IV
+//
+typedef struct {
+  VOID   *Aes;
+  UINT8  Chain[DRBG_CTR_BLOCK_BYTES];
+  UINT8  Block[DRBG_CTR_BLOCK_BYTES];
+  UINTN  Used;
+} CTR_DRBG_BCC;
+
+STATIC
+BOOLEAN
+CtrDrbgEncryptBlock (
+  IN  VOID         *Aes,
+  IN  CONST UINT8  *Input,
+  OUT UINT8        *Output
+  )
+{
+  return AesCbcEncrypt (Aes, Input, DRBG_CTR_BLOCK_BYTES, mZeroBlock, Output);
+}
+
+STATIC
+BOOLEAN
+CtrDrbgBccUpdate (
+  IN OUT CTR_DRBG_BCC  *Bcc,
+  IN     CONST UINT8   *Data,
+  IN     UINTN         Length
+  )
+{
+  UINTN  Copy;
+  UINTN  Index;
+
+  while (Length > 0) {
+    Copy = MIN (Length, DRBG_CTR_BLOCK_BYTES - Bcc->Used);
+    CopyMem (Bcc->Block + Bcc->Used, Data, Copy);
+    Bcc->Used += Copy;
+    Data      += Copy;
+    Length    -= Copy;
+
+    if (Bcc->Used == DRBG_CTR_BLOCK_BYTES) {
+      for (Index = 0; Index < DRBG_CTR_BLOCK_BYTES; Index++) {
+        Bcc->Chain[Index] ^= Bcc->Block[Index];
+      }
+      if (!CtrDrbgEncryptBlock (Bcc->Aes, Bcc->Chain, Bcc->Chain)) {
+        return FALSE;
+      }
+      Bcc->Used = 0;
+    }
+  }
+  return TRUE;
+}
+
+/**
+  Block_Cipher_df of SP800-90A 10.3.2, always returning seedlen bits.
+**/
+STATIC
+BOOLEAN
+CtrDrbgDerive (
+  IN OUT DRBG_STATE        *State,
+  IN     CONST DRBG_INPUT  *Inputs,
+  IN     UINTN             InputCount,
+  OUT    UINT8             *SeedMaterial
+  )
+{
+  CTR_DRBG_BCC  Bcc;
+  UINT8         Key[DRBG_CTR_KEY_BYTES];
+  UINT8         Temp[CTR_DRBG_SEED_BYTES];
+  UINT8         Header[DRBG_CTR_BLOCK_BYTES + 8];
+  UINT32        InputLength;
+  UINT32        Counter;
+  UINTN         Index;
+  UINTN         Offset;
+  BOOLEAN       Result;
+
+  InputLength = 0;
+  for (Index = 0; Index < InputCount; Index++) {
+    InputLength += (UINT32)Inputs[Index].Length;
+  }
+
+  for (Index = 0; Index < sizeof (Key); Index++) {
+    Key[Index] = (UINT8)Index;
+  }
+
+  Bcc.Aes = CTR_DRBG_DF_AES (State);
+  Result  = AesInit (Bcc.Aes, Key, DRBG_CTR_KEY_BYTES * 8);
+
+  //
+  // temp = BCC (K, IV || S) for IV = 0, 1, 2 and S = L || N || input || 0x80 || pad
+  //
+  ZeroMem (Header, sizeof (Header));
+  WriteUnaligned32 ((UINT32 *)(Header + DRBG_CTR_BLOCK_BYTES), SwapBytes32 (InputLength));
+  WriteUnaligned32 ((UINT32 *)(Header + DRBG_CTR_BLOCK_BYTES + 4), SwapBytes32 (CTR_DRBG_SEED_BYTES));
+
+  for (Counter = 0, Offset = 0; Result && (Offset < sizeof (Temp)); Counter++) {
+    WriteUnaligned32 ((UINT32 *)Header, SwapBytes32 (Counter));
+    ZeroMem (Bcc.Chain, sizeof (Bcc.Chain));
+    Bcc.Used = 0;
+
+    Result = CtrDrbgBccUpdate (&Bcc, Header, sizeof (Header));
+    for (Index = 0; Result && (Index < InputCount); Index++) {
+      Result = CtrDrbgBccUpdate (&Bcc, Inputs[Index].Data, Inputs[Index].Length);
+    }
+    if (Result) {
+      Result = CtrDrbgBccUpdate (&Bcc, (CONST UINT8 *)"\x80", 1);
+    }
+    while (Result && (Bcc.Used != 0)) {
+      Result = CtrDrbgBccUpdate (&Bcc, mZeroBlock, 1);
+    }
+
+    CopyMem (Temp + Offset, Bcc.Chain, DRBG_CTR_BLOCK_BYTES);
+    Offset += DRBG_CTR_BLOCK_BYTES;
+  }
+
+  //
+  // K = leftmost keylen bits of temp, X = next outlen bits, then encrypt X
+  // with K until seedlen bits are available.
+  //
+  if (Result) {
+    Result = AesInit (Bcc.Aes, Temp, DRBG_CTR_KEY_BYTES * 8);
+  }
+  for (Offset = 0; Result && (Offset < CTR_DRBG_SEED_BYTES); Offset += DRBG_CTR_BLOCK_BYTES) {
+    Result = CtrDrbgEncryptBlock (
+               Bcc.Aes,
+               (Offset == 0) ? Temp + DRBG_CTR_KEY_BYTES : SeedMaterial + Offset - DRBG_CTR_BLOCK_BYTES,
+               SeedMaterial + Offset
+               );
+  }
+
+  ZeroMem (&Bcc, sizeof (Bcc));
+  ZeroMem (Temp, sizeof (Temp));
+  ZeroMem (CTR_DRBG_DF_AES (State), AesGetContextSize ());
+  return Result;
+}
+
+/**
+  Increment V modulo 2^blocklen.
+**/
+STATIC
+VOID
+CtrDrbgIncrement (
+  IN OUT UINT8  *V
+  )
+{
+  UINTN  Index;
+
+  for (Index = DRBG_CTR_BLOCK_BYTES; Index > 0; Index--) {
+    if (++V[Index - 1] != 0) {
+      break;
+    }
+  }
+}
+
+/**
+  CTR_DRBG_Update of SP800-90A 10.2.1.2. ProvidedData may be NULL for an all
+  zero string.
+**/
+STATIC
+BOOLEAN
+CtrDrbgUpdate (
+  IN OUT DRBG_STATE   *State,
+  IN     CONST UINT8  *ProvidedData OPTIONAL
+  )
+{
+  UINT8    Temp[CTR_DRBG_SEED_BYTES];
+  UINTN    Offset;
+  BOOLEAN  Result;
+
+  Result = TRUE;
+  for (Offset = 0; Result && (Offset < sizeof (Temp)); Offset += DRBG_CTR_BLOCK_BYTES) {
+    CtrDrbgIncrement (State->u.Ctr.V);
+    Result = CtrDrbgEncryptBlock (CTR_DRBG_AES (State), State->u.Ctr.V, Temp + Offset);
+  }
+
+  if (Result) {
+    if (ProvidedData != NULL) {
+      for (Offset = 0; Offset < sizeof (Temp); Offset++) {
+        Temp[Offset] ^= ProvidedData[Offset];
+      }
+    }
+    CopyMem (State->u.Ctr.Key, Temp, DRBG_CTR_KEY_BYTES);
+    CopyMem (State->u.Ctr.V, Temp + DRBG_CTR_KEY_BYTES, DRBG_CTR_BLOCK_BYTES);
+    Result = AesInit (CTR_DRBG_AES (State), State->u.Ctr.Key, DRBG_CTR_KEY_BYTES * 8);
+  }
+
+  ZeroMem (Temp, sizeof (Temp));
+  return Result;
+}
+
+UINTN
+CtrDrbgContextSize (
+  VOID
+  )
+{
+  return 2 * AesGetContextSize ();
+}
+
+/**
+  CTR_DRBG_Instantiate_algorithm (10.2.1.3.2) when Reseed is FALSE and
+  CTR_DRBG_Reseed_algorithm (10.2.1.4.2) otherwise. Inputs is the
+  concatenation entropy_input || nonce || personalization_string, or
+  entropy_input || additional_input.
+**/
+EFI_STATUS
+CtrDrbgSeed (
+  IN OUT DRBG_STATE        *State,
+  IN     CONST DRBG_INPUT  *Inputs,
+  IN     UINTN             InputCount,
+  IN     BOOLEAN           Reseed
+  )
+{
+  UINT8    SeedMaterial[CTR_DRBG_SEED_BYTES];
+  BOOLEAN  Result;
+
+  if (!Reseed) {
+    ZeroMem (State->u.Ctr.Key, sizeof (State->u.Ctr.Key));
+    ZeroMem (State->u.Ctr.V, sizeof (State->u.Ctr.V));
+    if (!AesInit (CTR_DRBG_AES (State), State->u.Ctr.Key, DRBG_CTR_KEY_BYTES * 8)) {
+      return EFI_DEVICE_ERROR;
+    }
+  }
+
+  Result = CtrDrbgDerive (State, Inputs, InputCount, SeedMaterial);
+  if (Result) {
+    Result = CtrDrbgUpdate (State, SeedMaterial);
+  }
+
+  ZeroMem (SeedMaterial, sizeof (SeedMaterial));
+  return Result ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
+
+/**
+  CTR_DRBG_Generate_algorithm of SP800-90A 10.2.1.5.2.
+**/
+EFI_STATUS
+CtrDrbgGenerate (
+  IN OUT DRBG_STATE   *State,
+  IN     CONST UINT8  *AdditionalInput,
+  IN     UINTN        AdditionalInputLength,
+  IN     UINTN        Length,
+  OUT    UINT8        *Output
+  )
+{
+  UINT8       Additional[CTR_DRBG_SEED_BYTES];
+  UINT8       Block[DRBG_CTR_BLOCK_BYTES];
+  DRBG_INPUT  Input;
+  UINTN       Copy;
+  BOOLEAN     Result;
+
+  Result = TRUE;
+  if (AdditionalInputLength != 0) {
+    Input.Data   = AdditionalInput;
+    Input.Length = AdditionalInputLength;
+    Result = CtrDrbgDerive (State, &Input, 1, Additional);
+    if (Result) {
+      Result = CtrDrbgUpdate (State, Additional);
+    }
+  }
+
+  while (Result && (Length > 0)) {
+    CtrDrbgIncrement (State->u.Ctr.V);
+    if (Length >= DRBG_CTR_BLOCK_BYTES) {
+      Result = CtrDrbgEncryptBlock (CTR_DRBG_AES (State), State->u.Ctr.V, Output);
+      Copy = DRBG_CTR_BLOCK_BYTES;
+    } else {
+      Result = CtrDrbgEncryptBlock (CTR_DRBG_AES (State), State->u.Ctr.V, Block);
+      Copy = Length;
+      CopyMem (Output, Block, Copy);
+    }
+    Output += Copy;
+    Length -= Copy;
+  }
+
+  if (Result) {
+    Result = CtrDrbgUpdate (State, (AdditionalInputLength != 0) ? Additional : NULL);
+  }
+
+  ZeroMem (Additional, sizeof (Additional));
+  ZeroMem (Block, sizeof (Block));
+  return Result ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
@@ -0,0 +1,258 @@
+/** DrbgLib.c
+  SP800-90A DRBG instantiate, reseed and generate functions common to all
+  mechanisms.
+
+  Copyright 2020 NXP
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Library/MemoryAllocationLib.h>
+#include <Library/PcdLib.h>
+
+#include "DrbgLibInternal.h"
+
+VOID
+DrbgAddBigEndian (
+  IN OUT UINT8        *Dst,
+  IN     UINTN        DstLength,
+  IN     CONST UINT8  *Src,
+  IN     UINTN        SrcLength
+  )
+{
+  UINTN  Carry;
+  UINTN  Index;
+
+  ASSERT (SrcLength <= DstLength);
+
+  Carry = 0;
+  for (Index = 1; Index <= DstLength; Index++) {
+    if (Index <= SrcLength) {
+      Carry += Src[SrcLength - Index];
+    } else if (Carry == 0) {
+      break;
+    }
+    Carry += Dst[DstLength - Index];
+    Dst[DstLength - Index] = (UINT8)Carry;
+    Carry >>= 8;
+  }
+}
+
+STATIC
+EFI_STATUS
+DrbgSeed (
+  IN OUT DRBG_STATE        *State,
+  IN     CONST DRBG_INPUT  *Inputs,
+  IN     UINTN             InputCount,
+  IN     BOOLEAN           Reseed
+  )
+{
+  EFI_STATUS  Status;
+
+  switch (State->Mechanism) {
+  case DrbgCtrAes256:
+    Status = CtrDrbgSeed (State, Inputs, InputCount, Reseed);
+    break;
+  case DrbgHmacSha256:
+    Status = HmacDrbgSeed (State, Inputs, InputCount, Reseed);
+    break;
+  case DrbgHashSha256:
+    Status = HashDrbgSeed (State, Inputs, InputCount, Reseed);
+    break;
+  default:
+    Status = EFI_INVALID_PARAMETER;
+    break;
+  }
+
+  if (!EFI_ERROR (Status)) {
+    State->ReseedCounter = 1;
+  }
+  return Status;
+}
+
+EFI_STATUS
+DrbgInstantiate (
+  OUT DRBG_STATE        *State,
+  IN  DRBG_MECHANISM    Mechanism,
+  IN  DRBG_GET_ENTROPY  GetEntropy,
+  IN  VOID              *EntropyContext,
+  IN  CONST UINT8       *Personalization OPTIONAL,
+  IN  UINTN             PersonalizationLength
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       Entropy[DRBG_SECURITY_STRENGTH_BYTES];
+  UINT8       Nonce[DRBG_NONCE_BYTES];
+  DRBG_INPUT  Inputs[3];
+
+  if ((State == NULL) || (GetEntropy == NULL) ||
+      ((Personalization == NULL) && (PersonalizationLength != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ZeroMem (State, sizeof (DRBG_STATE));
+  State->Mechanism      = Mechanism;
+  State->GetEntropy     = GetEntropy;
+  State->EntropyContext = EntropyContext;
+  State->ReseedInterval = MAX (PcdGet32 (PcdDrbgReseedInterval), 1);
+
+  switch (Mechanism) {
+  case DrbgCtrAes256:
+    State->CryptoContextSize = CtrDrbgContextSize ();
+    break;
+  case DrbgHmacSha256:
+    State->CryptoContextSize = HmacDrbgContextSize ();
+    break;
+  case DrbgHashSha256:
+    State->CryptoContextSize = HashDrbgContextSize ();
+    break;
+  default:
+    return EFI_INVALID_PARAMETER;
+  }
+
+  State->CryptoContext = AllocatePool (State->CryptoContextSize);
+  if (State->CryptoContext == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  //
+  // The nonce is taken from the entropy source as well (SP800-90A 8.6.7).
+  //
+  Status = GetEntropy (EntropyContext, sizeof (Entropy), Entropy);
+  if (!EFI_ERROR (Status)) {
+    Status = GetEntropy (EntropyContext, sizeof (Nonce), Nonce);
+  }
+  if (!EFI_ERROR (Status)) {
+    Inputs[0].Data   = Entropy;
+    Inputs[0].Length = sizeof (Entropy);
+    Inputs[1].Data   = Nonce;
+    Inputs[1].Length = sizeof (Nonce);
+    Inputs[2].Data   = Personalization;
+    Inputs[2].Length = PersonalizationLength;
+    Status = DrbgSeed (State, Inputs, 3, FALSE);
+  }
+
+  ZeroMem (Entropy, sizeof (Entropy));
+  ZeroMem (Nonce, sizeof (Nonce));
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "DRBG instantiation failed: %r\n", Status));
+    DrbgUninstantiate (State);
+    return Status;
+  }
+
+  State->Instantiated = TRUE;
+  return EFI_SUCCESS;
+}
+
+EFI_STATUS
+DrbgReseed (
+  IN OUT DRBG_STATE   *State,
+  IN     CONST UINT8  *AdditionalInput OPTIONAL,
+  IN     UINTN        AdditionalInputLength
+  )
+{
+  EFI_STATUS  Status;
+  UINT8       Entropy[DRBG_SECURITY_STRENGTH_BYTES];
+  DRBG_INPUT  Inputs[2];
+
+  if ((State == NULL) || !State->Instantiated ||
+      ((AdditionalInput == NULL) && (AdditionalInputLength != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = State->GetEntropy (State->EntropyContext, sizeof (Entropy), Entropy);
+  if (!EFI_ERROR (Status)) {
+    Inputs[0].Data   = Entropy;
+    Inputs[0].Length = sizeof (Entropy);
+    Inputs[1].Data   = AdditionalInput;
+    Inputs[1].Length = AdditionalInputLength;
+    Status = DrbgSeed (State, Inputs, 2, TRUE);
+  }
+
+  ZeroMem (Entropy, sizeof (Entropy));
+
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR, "DRBG reseed failed: %r\n", Status));
+  }
+  return Status;
+}
+
+EFI_STATUS
+DrbgGenerate (
+  IN OUT DRBG_STATE   *State,
+  IN     CONST UINT8  *AdditionalInput OPTIONAL,
+  IN     UINTN        AdditionalInputLength,
+  IN     UINTN        Length,
+  OUT    UINT8        *Output
+  )
+{
+  EFI_STATUS  Status;
+  UINTN       Chunk;
+
+  if ((State == NULL) || !State->Instantiated ||
+      ((Output == NULL) && (Length != 0)) ||
+      ((AdditionalInput == NULL) && (AdditionalInputLength != 0))) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  while (Length > 0) {
+    Chunk = MIN (Length, DRBG_MAX_BYTES_PER_REQUEST);
+
+    //
+    // When a reseed is due the additional input is consumed by the reseed
+    // and not used again by the generate (SP800-90A 9.3.1).
+    //
+    if (State->ReseedCounter > State->ReseedInterval) {
+      Status = DrbgReseed (State, AdditionalInput, AdditionalInputLength);
+      if (EFI_ERROR (Status)) {
+        return Status;
+      }
+      AdditionalInput       = NULL;
+      AdditionalInputLength = 0;
+    }
+
+    switch (State->Mechanism) {
+    case DrbgCtrAes256:
+      Status = CtrDrbgGenerate (State, AdditionalInput, AdditionalInputLength, Chunk, Output);
+      break;
+    case DrbgHmacSha256:
+      Status = HmacDrbgGenerate (State, AdditionalInput, AdditionalInputLength, Chunk, Output);
+      break;
+    case DrbgHashSha256:
+      Status = HashDrbgGenerate (State, AdditionalInput, AdditionalInputLength, Chunk, Output);
+      break;
+    default:
+      Status = EFI_INVALID_PARAMETER;
+      break;
+    }
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+
+    State->ReseedCounter++;
+    AdditionalInput       = NULL;
+    AdditionalInputLength = 0;
+    Output += Chunk;
+    Length -= Chunk;
+  }
+
+  return EFI_SUCCESS;
+}
+
+VOID
+DrbgUninstantiate (
+  IN OUT DRBG_STATE  *State
+  )
+{
+  if (State == NULL) {
+    return;
+  }
+
+  if (State->CryptoContext != NULL) {
+    ZeroMem (State->CryptoContext, State->CryptoContextSize);
+    FreePool (State->CryptoContext);
+  }
+  ZeroMem (State, sizeof (DRBG_STATE));
+}
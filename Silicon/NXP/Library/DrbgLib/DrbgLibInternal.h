@@ -0,0 +1,111 @@
+/** @file
+  Internal definitions shared by the DRBG mechanisms
+
+  Copyright 2020 NXP
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __DRBG_LIB_INTERNAL_H__
+#define __DRBG_LIB_INTERNAL_H__
+
+#include <Library/BaseCryptLib.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DrbgLib.h>
+
+//
+// The SP800-90A algorithms are written in terms of concatenated bit strings.
+// The inputs are passed as a list of pieces instead of being copied into a
+// single buffer.
+//
+typedef struct {
+  CONST UINT8  *Data;
+  UINTN        Length;
+} DRBG_INPUT;
+
+/**
+  Add Src to the big endian integer Dst, modulo 2^(8 * DstLength).
+
+  @param[in, out] Dst        Big endian integer to update
+  @param[in]      DstLength  Length of Dst in bytes
+  @param[in]      Src        Big endian integer to add
+  @param[in]      SrcLength  Length of Src in bytes, at most DstLength
+**/
+VOID
+DrbgAddBigEndian (
+  IN OUT UINT8        *Dst,
+  IN     UINTN        DstLength,
+  IN     CONST UINT8  *Src,
+  IN     UINTN        SrcLength
+  );
+
+UINTN
+CtrDrbgContextSize (
+  VOID
+  );
+
+EFI_STATUS
+CtrDrbgSeed (
+  IN OUT DRBG_STATE        *State,
+  IN     CONST DRBG_INPUT  *Inputs,
+  IN     UINTN             InputCount,
+  IN     BOOLEAN           Reseed
+  );
+
+EFI_STATUS
+CtrDrbgGenerate (
+  IN OUT DRBG_STATE   *State,
+  IN     CONST UINT8  *AdditionalInput,
+  IN     UINTN        AdditionalInputLength,
+  IN     UINTN        Length,
+  OUT    UINT8        *Output
+  );
+
+UINTN
+HmacDrbgContextSize (
+  VOID
+  );
+
+EFI_STATUS
+HmacDrbgSeed (
+  IN OUT DRBG_STATE        *State,
+  IN     CONST DRBG_INPUT  *Inputs,
+  IN     UINTN             InputCount,
+  IN     BOOLEAN           Reseed
+  );
+
+EFI_STATUS
+HmacDrbgGenerate (
+  IN OUT DRBG_STATE   *State,
+  IN     CONST UINT8  *AdditionalInput,
+  IN     UINTN        AdditionalInputLength,
+  IN     UINTN        Length,
+  OUT    UINT8        *Output
+  );
+
+UINTN
+HashDrbgContextSize (
+  VOID
+  );
+
+EFI_STATUS
+HashDrbgSeed (
+  IN OUT DRBG_STATE        *State,
+  IN     CONST DRBG_INPUT  *Inputs,
+  IN     UINTN             InputCount,
+  IN     BOOLEAN           Reseed
+  );
+
+EFI_STATUS
+HashDrbgGenerate (
+  IN OUT DRBG_STATE   *State,
+  IN     CONST UINT8  *AdditionalInput,
+  IN     UINTN        AdditionalInputLength,
+  IN     UINTN        Length,
+  OUT    UINT8        *Output
+  );
+
+#endif
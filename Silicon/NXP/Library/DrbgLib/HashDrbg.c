@@ -0,0 +1,202 @@
+/** HashDrbg.c
+  Hash_DRBG mechanism of SP800-90A section 10.1.1, using SHA-256.
+
+  Copyright 2020 NXP
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DrbgLibInternal.h"
+
+/**
+  Hash_df of SP800-90A 10.3.1, always returning seedlen bits. The optional
+  Prefix byte and Prefix V are hashed in front of the inputs.
+**/
+STATIC
+BOOLEAN
+HashDrbgDerive (
+  IN  VOID              *Sha,
+  IN  CONST UINT8       *PrefixByte OPTIONAL,
+  IN  CONST UINT8       *PrefixV OPTIONAL,
+  IN  CONST DRBG_INPUT  *Inputs,
+  IN  UINTN             InputCount,
+  OUT UINT8             *Output
+  )
+{
+  UINT8    Header[5];
+  UINT8    Digest[DRBG_SHA256_BYTES];
+  UINTN    Offset;
+  UINTN    Index;
+  BOOLEAN  Result;
+
+  //
+  // Hash (counter || no_of_bits_to_return || input_string)
+  //
+  Header[0] = 1;
+  WriteUnaligned32 ((UINT32 *)(Header + 1), SwapBytes32 (DRBG_HASH_SEED_BYTES * 8));
+
+  Result = TRUE;
+  for (Offset = 0; Result && (Offset < DRBG_HASH_SEED_BYTES); Offset += DRBG_SHA256_BYTES) {
+    Result = Sha256Init (Sha) && Sha256Update (Sha, Header, sizeof (Header));
+    if (Result && (PrefixByte != NULL)) {
+      Result = Sha256Update (Sha, PrefixByte, 1);
+    }
+    if (Result && (PrefixV != NULL)) {
+      Result = Sha256Update (Sha, PrefixV, DRBG_HASH_SEED_BYTES);
+    }
+    for (Index = 0; Result && (Index < InputCount); Index++) {
+      if (Inputs[Index].Length != 0) {
+        Result = Sha256Update (Sha, Inputs[Index].Data, Inputs[Index].Length);
+      }
+    }
+    if (Result) {
+      Result = Sha256Final (Sha, Digest);
+      CopyMem (Output + Offset, Digest, MIN (DRBG_SHA256_BYTES, DRBG_HASH_SEED_BYTES - Offset));
+    }
+    Header[0]++;
+  }
+
+  ZeroMem (Digest, sizeof (Digest));
+  return Result;
+}
+
+/**
+  Hash (Prefix || V || Data) into Digest.
+**/
+STATIC
+BOOLEAN
+HashDrbgHash (
+  IN  VOID         *Sha,
+  IN  UINT8        Prefix,
+  IN  CONST UINT8  *V,
+  IN  CONST UINT8  *Data OPTIONAL,
+  IN  UINTN        DataLength,
+  OUT UINT8        *Digest
+  )
+{
+  BOOLEAN  Result;
+
+  Result = Sha256Init (Sha) &&
+           Sha256Update (Sha, &Prefix, 1) &&
+           Sha256Update (Sha, V, DRBG_HASH_SEED_BYTES);
+  if (Result && (DataLength != 0)) {
+    Result = Sha256Update (Sha, Data, DataLength);
+  }
+  return Result && Sha256Final (Sha, Digest);
+}
+
+UINTN
+HashDrbgContextSize (
+  VOID
+  )
+{
+  return Sha256GetContextSize ();
+}
+
+/**
+  Hash_DRBG_Instantiate_algorithm (10.1.1.2) when Reseed is FALSE and
+  Hash_DRBG_Reseed_algorithm (10.1.1.3) otherwise.
+**/
+EFI_STATUS
+HashDrbgSeed (
+  IN OUT DRBG_STATE        *State,
+  IN     CONST DRBG_INPUT  *Inputs,
+  IN     UINTN             InputCount,
+  IN     BOOLEAN           Reseed
+  )
+{
+  UINT8    Seed[DRBG_HASH_SEED_BYTES];
+  UINT8    Prefix;
+  BOOLEAN  Result;
+
+  //
+  // seed = Hash_df (0x01 || V || entropy_input || additional_input) on reseed,
+  // Hash_df (entropy_input || nonce || personalization_string) otherwise.
+  //
+  Prefix = 0x01;
+  Result = HashDrbgDerive (
+             State->CryptoContext,
+             Reseed ? &Prefix : NULL,
+             Reseed ? State->u.Hash.V : NULL,
+             Inputs,
+             InputCount,
+             Seed
+             );
+  if (Result) {
+    CopyMem (State->u.Hash.V, Seed, sizeof (Seed));
+
+    //
+    // C = Hash_df (0x00 || V)
+    //
+    Prefix = 0x00;
+    Result = HashDrbgDerive (State->CryptoContext, &Prefix, State->u.Hash.V, NULL, 0, State->u.Hash.C);
+  }
+
+  ZeroMem (Seed, sizeof (Seed));
+  return Result ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
+
+/**
+  Hash_DRBG_Generate_algorithm of SP800-90A 10.1.1.4.
+**/
+EFI_STATUS
+HashDrbgGenerate (
+  IN OUT DRBG_STATE   *State,
+  IN     CONST UINT8  *AdditionalInput,
+  IN     UINTN        AdditionalInputLength,
+  IN     UINTN        Length,
+  OUT    UINT8        *Output
+  )
+{
+  UINT8    Data[DRBG_HASH_SEED_BYTES];
+  UINT8    Digest[DRBG_SHA256_BYTES];
+  UINT8    Counter[sizeof (UINT64)];
+  UINT8    One;
+  UINTN    Copy;
+  BOOLEAN  Result;
+
+  Result = TRUE;
+  if (AdditionalInputLength != 0) {
+    //
+    // w = Hash (0x02 || V || additional_input), V = (V + w) mod 2^seedlen
+    //
+    Result = HashDrbgHash (State->CryptoContext, 0x02, State->u.Hash.V, AdditionalInput, AdditionalInputLength, Digest);
+    if (Result) {
+      DrbgAddBigEndian (State->u.Hash.V, DRBG_HASH_SEED_BYTES, Digest, sizeof (Digest));
+    }
+  }
+
+  //
+  // Hashgen: hash V, V + 1, V + 2, ... until enough bytes are returned.
+  //
+  CopyMem (Data, State->u.Hash.V, sizeof (Data));
+  One = 1;
+  while (Result && (Length > 0)) {
+    Result = Sha256Init (State->CryptoContext) &&
+             Sha256Update (State->CryptoContext, Data, sizeof (Data)) &&
+             Sha256Final (State->CryptoContext, Digest);
+    Copy = MIN (Length, DRBG_SHA256_BYTES);
+    CopyMem (Output, Digest, Copy);
+    Output += Copy;
+    Length -= Copy;
+    DrbgAddBigEndian (Data, sizeof (Data), &One, sizeof (One));
+  }
+
+  //
+  // H = Hash (0x03 || V), V = (V + H + C + reseed_counter) mod 2^seedlen
+  //
+  if (Result) {
+    Result = HashDrbgHash (State->CryptoContext, 0x03, State->u.Hash.V, NULL, 0, Digest);
+  }
+  if (Result) {
+    WriteUnaligned64 ((UINT64 *)Counter, SwapBytes64 (State->ReseedCounter));
+    DrbgAddBigEndian (State->u.Hash.V, DRBG_HASH_SEED_BYTES, Digest, sizeof (Digest));
+    DrbgAddBigEndian (State->u.Hash.V, DRBG_HASH_SEED_BYTES, State->u.Hash.C, DRBG_HASH_SEED_BYTES);
+    DrbgAddBigEndian (State->u.Hash.V, DRBG_HASH_SEED_BYTES, Counter, sizeof (Counter));
+  }
+
+  ZeroMem (Data, sizeof (Data));
+  ZeroMem (Digest, sizeof (Digest));
+  return Result ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
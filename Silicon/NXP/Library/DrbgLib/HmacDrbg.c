@@ -0,0 +1,196 @@
+/** HmacDrbg.c
+  HMAC_DRBG mechanism of SP800-90A section 10.1.2, using HMAC-SHA-256.
+
+  Copyright 2020 NXP
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include "DrbgLibInternal.h"
+
+#define HMAC_SHA256_BLOCK_BYTES   64
+
+/**
+  Compute HMAC-SHA-256 (Key, Prefix || Separator || Inputs) into Mac. The
+  separator byte is omitted when Separator is NULL.
+**/
+STATIC
+BOOLEAN
+HmacDrbgMac (
+  IN  VOID              *Sha,
+  IN  CONST UINT8       *Key,
+  IN  CONST UINT8       *Prefix,
+  IN  CONST UINT8       *Separator OPTIONAL,
+  IN  CONST DRBG_INPUT  *Inputs OPTIONAL,
+  IN  UINTN             InputCount,
+  OUT UINT8             *Mac
+  )
+{
+  UINT8    Pad[HMAC_SHA256_BLOCK_BYTES];
+  UINT8    Inner[DRBG_SHA256_BYTES];
+  UINTN    Index;
+  BOOLEAN  Result;
+
+  SetMem (Pad, sizeof (Pad), 0x36);
+  for (Index = 0; Index < DRBG_SHA256_BYTES; Index++) {
+    Pad[Index] ^= Key[Index];
+  }
+
+  Result = Sha256Init (Sha) &&
+           Sha256Update (Sha, Pad, sizeof (Pad)) &&
+           Sha256Update (Sha, Prefix, DRBG_SHA256_BYTES);
+  if (Result && (Separator != NULL)) {
+    Result = Sha256Update (Sha, Separator, 1);
+  }
+  for (Index = 0; Result && (Index < InputCount); Index++) {
+    if (Inputs[Index].Length != 0) {
+      Result = Sha256Update (Sha, Inputs[Index].Data, Inputs[Index].Length);
+    }
+  }
+  if (Result) {
+    Result = Sha256Final (Sha, Inner);
+  }
+
+  SetMem (Pad, sizeof (Pad), 0x5c);
+  for (Index = 0; Index < DRBG_SHA256_BYTES; Index++) {
+    Pad[Index] ^= Key[Index];
+  }
+
+  Result = Result &&
+           Sha256Init (Sha) &&
+           Sha256Update (Sha, Pad, sizeof (Pad)) &&
+           Sha256Update (Sha, Inner, sizeof (Inner)) &&
+           Sha256Final (Sha, Mac);
+
+  ZeroMem (Pad, sizeof (Pad));
+  ZeroMem (Inner, sizeof (Inner));
+  return Result;
+}
+
+/**
+  HMAC_DRBG_Update of SP800-90A 10.1.2.2.
+**/
+STATIC
+BOOLEAN
+HmacDrbgUpdate (
+  IN OUT DRBG_STATE        *State,
+  IN     CONST DRBG_INPUT  *Inputs OPTIONAL,
+  IN     UINTN             InputCount
+  )
+{
+  UINTN    ProvidedLength;
+  UINTN    Index;
+  UINT8    Round;
+  BOOLEAN  Result;
+
+  ProvidedLength = 0;
+  for (Index = 0; Index < InputCount; Index++) {
+    ProvidedLength += Inputs[Index].Length;
+  }
+
+  Result = TRUE;
+  for (Round = 0; Result && (Round < 2); Round++) {
+    //
+    // K = HMAC (K, V || Round || provided_data), V = HMAC (K, V)
+    //
+    Result = HmacDrbgMac (
+               State->CryptoContext,
+               State->u.Hmac.K,
+               State->u.Hmac.V,
+               &Round,
+               Inputs,
+               InputCount,
+               State->u.Hmac.K
+               ) &&
+             HmacDrbgMac (
+               State->CryptoContext,
+               State->u.Hmac.K,
+               State->u.Hmac.V,
+               NULL,
+               NULL,
+               0,
+               State->u.Hmac.V
+               );
+    if (ProvidedLength == 0) {
+      break;
+    }
+  }
+
+  return Result;
+}
+
+UINTN
+HmacDrbgContextSize (
+  VOID
+  )
+{
+  return Sha256GetContextSize ();
+}
+
+/**
+  HMAC_DRBG_Instantiate_algorithm (10.1.2.3) when Reseed is FALSE and
+  HMAC_DRBG_Reseed_algorithm (10.1.2.4) otherwise.
+**/
+EFI_STATUS
+HmacDrbgSeed (
+  IN OUT DRBG_STATE        *State,
+  IN     CONST DRBG_INPUT  *Inputs,
+  IN     UINTN             InputCount,
+  IN     BOOLEAN           Reseed
+  )
+{
+  if (!Reseed) {
+    SetMem (State->u.Hmac.K, sizeof (State->u.Hmac.K), 0x00);
+    SetMem (State->u.Hmac.V, sizeof (State->u.Hmac.V), 0x01);
+  }
+
+  return HmacDrbgUpdate (State, Inputs, InputCount) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
+
+/**
+  HMAC_DRBG_Generate_algorithm of SP800-90A 10.1.2.5.
+**/
+EFI_STATUS
+HmacDrbgGenerate (
+  IN OUT DRBG_STATE   *State,
+  IN     CONST UINT8  *AdditionalInput,
+  IN     UINTN        AdditionalInputLength,
+  IN     UINTN        Length,
+  OUT    UINT8        *Output
+  )
+{
+  DRBG_INPUT  Input;
+  UINTN       Copy;
+  BOOLEAN     Result;
+
+  Input.Data   = AdditionalInput;
+  Input.Length = AdditionalInputLength;
+
+  Result = TRUE;
+  if (AdditionalInputLength != 0) {
+    Result = HmacDrbgUpdate (State, &Input, 1);
+  }
+
+  while (Result && (Length > 0)) {
+    Result = HmacDrbgMac (
+               State->CryptoContext,
+               State->u.Hmac.K,
+               State->u.Hmac.V,
+               NULL,
+               NULL,
+               0,
+               State->u.Hmac.V
+               );
+    Copy = MIN (Length, DRBG_SHA256_BYTES);
+    CopyMem (Output, State->u.Hmac.V, Copy);
+    Output += Copy;
+    Length -= Copy;
+  }
+
+  if (Result) {
+    Result = HmacDrbgUpdate (State, &Input, 1);
+  }
+
+  return Result ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
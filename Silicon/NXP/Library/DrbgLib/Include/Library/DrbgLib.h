@@ -0,0 +1,168 @@
+/** @file
+  SP800-90A deterministic random bit generators
+
+  Provides the CTR_DRBG (AES-256 with derivation function), HMAC_DRBG
+  (SHA-256) and Hash_DRBG (SHA-256) mechanisms of NIST SP800-90A rev 1 on top
+  of a caller supplied entropy source, typically a hardware TRNG. Once seeded,
+  a DRBG serves requests of any size at the speed of the underlying cipher and
+  only goes back to the entropy source when the reseed interval expires.
+
+  Copyright 2020 NXP
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#ifndef __DRBG_LIB_H__
+#define __DRBG_LIB_H__
+
+#include <Uefi.h>
+
+//
+// All mechanisms are instantiated at a 256 bit security strength.
+//
+#define DRBG_SECURITY_STRENGTH_BYTES    32
+#define DRBG_NONCE_BYTES                16
+
+//
+// Largest number of bytes produced by a single generate call, 2^19 bits
+// (SP800-90A table 2 and 3). DrbgGenerate splits larger requests.
+//
+#define DRBG_MAX_BYTES_PER_REQUEST      SIZE_64KB
+
+#define DRBG_CTR_KEY_BYTES              32
+#define DRBG_CTR_BLOCK_BYTES            16
+#define DRBG_SHA256_BYTES               32
+#define DRBG_HASH_SEED_BYTES            55    // seedlen of Hash_DRBG SHA-256, 440 bits
+
+typedef enum {
+  DrbgCtrAes256,
+  DrbgHmacSha256,
+  DrbgHashSha256
+} DRBG_MECHANISM;
+
+/**
+  Fill a buffer with entropy, usually from a hardware TRNG.
+
+  @param[in]  Context  Context registered with DrbgInstantiate
+  @param[in]  Length   Number of bytes to return
+  @param[out] Buffer   Buffer to fill
+
+  @retval EFI_SUCCESS  Buffer was filled with full entropy bytes.
+  @retval Others       The entropy source failed.
+**/
+typedef
+EFI_STATUS
+(EFIAPI *DRBG_GET_ENTROPY) (
+  IN  VOID   *Context,
+  IN  UINTN  Length,
+  OUT UINT8  *Buffer
+  );
+
+typedef struct {
+  DRBG_MECHANISM    Mechanism;
+  BOOLEAN           Instantiated;
+  DRBG_GET_ENTROPY  GetEntropy;
+  VOID              *EntropyContext;
+  UINT64            ReseedCounter;
+  UINT64            ReseedInterval;
+  VOID              *CryptoContext;   // AES key schedules or SHA-256 context
+  UINTN             CryptoContextSize;
+  union {
+    struct {
+      UINT8         Key[DRBG_CTR_KEY_BYTES];
+      UINT8         V[DRBG_CTR_BLOCK_BYTES];
+    } Ctr;
+    struct {
+      UINT8         K[DRBG_SHA256_BYTES];
+      UINT8         V[DRBG_SHA256_BYTES];
+    } Hmac;
+    struct {
+      UINT8         V[DRBG_HASH_SEED_BYTES];
+      UINT8         C[DRBG_HASH_SEED_BYTES];
+    } Hash;
+  } u;
+} DRBG_STATE;
+
+/**
+  Instantiate a DRBG, seeding it with entropy and a nonce from the entropy
+  source.
+
+  @param[out] State                  DRBG state to initialize
+  @param[in]  Mechanism              DRBG mechanism to use
+  @param[in]  GetEntropy             Entropy source
+  @param[in]  EntropyContext         Context passed to GetEntropy
+  @param[in]  Personalization        Optional personalization string
+  @param[in]  PersonalizationLength  Length of the personalization string
+
+  @retval EFI_SUCCESS            The DRBG is ready to generate.
+  @retval EFI_INVALID_PARAMETER  A parameter is invalid.
+  @retval EFI_OUT_OF_RESOURCES   The crypto context could not be allocated.
+  @retval Others                 The entropy source failed.
+**/
+EFI_STATUS
+DrbgInstantiate (
+  OUT DRBG_STATE        *State,
+  IN  DRBG_MECHANISM    Mechanism,
+  IN  DRBG_GET_ENTROPY  GetEntropy,
+  IN  VOID              *EntropyContext,
+  IN  CONST UINT8       *Personalization OPTIONAL,
+  IN  UINTN             PersonalizationLength
+  );
+
+/**
+  Reseed a DRBG with fresh entropy from the entropy source.
+
+  @param[in, out] State                   Instantiated DRBG state
+  @param[in]      AdditionalInput         Optional additional input
+  @param[in]      AdditionalInputLength   Length of the additional input
+
+  @retval EFI_SUCCESS            The DRBG was reseeded.
+  @retval EFI_INVALID_PARAMETER  The DRBG is not instantiated.
+  @retval Others                 The entropy source failed.
+**/
+EFI_STATUS
+DrbgReseed (
+  IN OUT DRBG_STATE   *State,
+  IN     CONST UINT8  *AdditionalInput OPTIONAL,
+  IN     UINTN        AdditionalInputLength
+  );
+
+/**
+  Generate pseudo random bytes.
+
+  The DRBG is reseeded from the entropy source first when its reseed
+  interval, PcdDrbgReseedInterval, has expired. Requests larger than
+  DRBG_MAX_BYTES_PER_REQUEST are served by several generate operations.
+
+  @param[in, out] State                   Instantiated DRBG state
+  @param[in]      AdditionalInput         Optional additional input
+  @param[in]      AdditionalInputLength   Length of the additional input
+  @param[in]      Length                  Number of bytes to generate
+  @param[out]     Output                  Buffer receiving the bytes
+
+  @retval EFI_SUCCESS            Output was filled.
+  @retval EFI_INVALID_PARAMETER  A parameter is invalid or the DRBG is not
+                                 instantiated.
+  @retval Others                 A required reseed failed.
+**/
+EFI_STATUS
+DrbgGenerate (
+  IN OUT DRBG_STATE   *State,
+  IN     CONST UINT8  *AdditionalInput OPTIONAL,
+  IN     UINTN        AdditionalInputLength,
+  IN     UINTN        Length,
+  OUT    UINT8        *Output
+  );
+
+/**
+  Wipe the internal state of a DRBG and release its resources.
+
+  @param[in, out] State  DRBG state
+**/
+VOID
+DrbgUninstantiate (
+  IN OUT DRBG_STATE  *State
+  );
+
+#endif
@@ -0,0 +1,793 @@
+/** @file
+  Host based unit test of DrbgLib against known answer vectors
+
+  Each test instantiates a DRBG from a fixed entropy input and nonce,
+  optionally reseeds it, generates twice and compares the output of the
+  second generate call, following the CAVP DRBGVS procedure.
+
+  Copyright 2020 NXP
+
+  SPDX-License-Identifier: BSD-2-Clause-Patent
+
+**/
+
+#include <Uefi.h>
+#include <Library/BaseLib.h>
+#include <Library/BaseMemoryLib.h>
+#include <Library/DebugLib.h>
+#include <Library/DrbgLib.h>
+#include <Library/UnitTestLib.h>
+
+#define UNIT_TEST_APP_NAME      "DrbgLib Unit Tests"
+#define UNIT_TEST_APP_VERSION   "1.0"
+
+#define DRBG_KAT_MAX_RETURNED_BYTES  128
+
+typedef struct {
+  CONST CHAR8       *Name;
+  DRBG_MECHANISM    Mechanism;
+  CONST UINT8       *Entropy;                   // DRBG_SECURITY_STRENGTH_BYTES
+  CONST UINT8       *Nonce;                     // DRBG_NONCE_BYTES
+  CONST UINT8       *EntropyReseed;             // NULL: no reseed
+  CONST UINT8       *AdditionalInputReseed;
+  UINTN             AdditionalInputReseedLength;
+  CONST UINT8       *Personalization;
+  UINTN             PersonalizationLength;
+  CONST UINT8       *AdditionalInput1;
+  CONST UINT8       *AdditionalInput2;
+  UINTN             AdditionalInputLength;
+  CONST UINT8       *ReturnedBits;
+  UINTN             ReturnedBitsLength;
+} DRBG_KAT;
+
+//
+// Entropy source handing out the entropy input, the nonce and the reseed
+// entropy input of a vector, in the order DrbgLib asks for them.
+//
+typedef struct {
+  CONST UINT8       *Input[3];
+  UINTN             Length[3];
+  UINTN             Next;
+} DRBG_TEST_ENTROPY;
+
+//
+// NIST CAVP DRBGVS vectors (drbgvectors_no_reseed.zip and
+// drbgvectors_pr_false.zip). Empty fields of the response files are NULL.
+//
+
+//
+// CAVP CTR_DRBG.rsp (no_reseed), [AES-256 use df], COUNT = 0
+//
+STATIC CONST UINT8 mCtrCavpNoReseedEntropy[] = {
+  0x36, 0x40, 0x19, 0x40, 0xfa, 0x8b, 0x1f, 0xba, 0x91, 0xa1, 0x66, 0x1f,
+  0x21, 0x1d, 0x78, 0xa0, 0xb9, 0x38, 0x9a, 0x74, 0xe5, 0xbc, 0xcf, 0xec,
+  0xe8, 0xd7, 0x66, 0xaf, 0x1a, 0x6d, 0x3b, 0x14
+};
+STATIC CONST UINT8 mCtrCavpNoReseedNonce[] = {
+  0x49, 0x6f, 0x25, 0xb0, 0xf1, 0x30, 0x1b, 0x4f, 0x50, 0x1b, 0xe3, 0x03,
+  0x80, 0xa1, 0x37, 0xeb
+};
+STATIC CONST UINT8 mCtrCavpNoReseedReturnedBits[] = {
+  0x58, 0x62, 0xeb, 0x38, 0xbd, 0x55, 0x8d, 0xd9, 0x78, 0xa6, 0x96, 0xe6,
+  0xdf, 0x16, 0x47, 0x82, 0xdd, 0xd8, 0x87, 0xe7, 0xe9, 0xa6, 0xc9, 0xf3,
+  0xf1, 0xfb, 0xaf, 0xb7, 0x89, 0x41, 0xb5, 0x35, 0xa6, 0x49, 0x12, 0xdf,
+  0xd2, 0x24, 0xc6, 0xdc, 0x74, 0x54, 0xe5, 0x25, 0x0b, 0x3d, 0x97, 0x16,
+  0x5e, 0x16, 0x26, 0x0c, 0x2f, 0xaf, 0x1c, 0xc7, 0x73, 0x5c, 0xb7, 0x5f,
+  0xb4, 0xf0, 0x7e, 0x1d
+};
+
+//
+// CAVP HMAC_DRBG.rsp (no_reseed), [SHA-256], COUNT = 0
+//
+STATIC CONST UINT8 mHmacCavpNoReseedEntropy[] = {
+  0xca, 0x85, 0x19, 0x11, 0x34, 0x93, 0x84, 0xbf, 0xfe, 0x89, 0xde, 0x1c,
+  0xbd, 0xc4, 0x6e, 0x68, 0x31, 0xe4, 0x4d, 0x34, 0xa4, 0xfb, 0x93, 0x5e,
+  0xe2, 0x85, 0xdd, 0x14, 0xb7, 0x1a, 0x74, 0x88
+};
+STATIC CONST UINT8 mHmacCavpNoReseedNonce[] = {
+  0x65, 0x9b, 0xa9, 0x6c, 0x60, 0x1d, 0xc6, 0x9f, 0xc9, 0x02, 0x94, 0x08,
+  0x05, 0xec, 0x0c, 0xa8
+};
+STATIC CONST UINT8 mHmacCavpNoReseedReturnedBits[] = {
+  0xe5, 0x28, 0xe9, 0xab, 0xf2, 0xde, 0xce, 0x54, 0xd4, 0x7c, 0x7e, 0x75,
+  0xe5, 0xfe, 0x30, 0x21, 0x49, 0xf8, 0x17, 0xea, 0x9f, 0xb4, 0xbe, 0xe6,
+  0xf4, 0x19, 0x96, 0x97, 0xd0, 0x4d, 0x5b, 0x89, 0xd5, 0x4f, 0xbb, 0x97,
+  0x8a, 0x15, 0xb5, 0xc4, 0x43, 0xc9, 0xec, 0x21, 0x03, 0x6d, 0x24, 0x60,
+  0xb6, 0xf7, 0x3e, 0xba, 0xd0, 0xdc, 0x2a, 0xba, 0x6e, 0x62, 0x4a, 0xbf,
+  0x07, 0x74, 0x5b, 0xc1, 0x07, 0x69, 0x4b, 0xb7, 0x54, 0x7b, 0xb0, 0x99,
+  0x5f, 0x70, 0xde, 0x25, 0xd6, 0xb2, 0x9e, 0x2d, 0x30, 0x11, 0xbb, 0x19,
+  0xd2, 0x76, 0x76, 0xc0, 0x71, 0x62, 0xc8, 0xb5, 0xcc, 0xde, 0x06, 0x68,
+  0x96, 0x1d, 0xf8, 0x68, 0x03, 0x48, 0x2c, 0xb3, 0x7e, 0xd6, 0xd5, 0xc0,
+  0xbb, 0x8d, 0x50, 0xcf, 0x1f, 0x50, 0xd4, 0x76, 0xaa, 0x04, 0x58, 0xbd,
+  0xab, 0xa8, 0x06, 0xf4, 0x8b, 0xe9, 0xdc, 0xb8
+};
+
+//
+// CAVP HMAC_DRBG.rsp (pr_false), [SHA-256], COUNT = 0
+//
+STATIC CONST UINT8 mHmacCavpReseedEntropy[] = {
+  0x06, 0x03, 0x2c, 0xd5, 0xee, 0xd3, 0x3f, 0x39, 0x26, 0x5f, 0x49, 0xec,
+  0xb1, 0x42, 0xc5, 0x11, 0xda, 0x9a, 0xff, 0x2a, 0xf7, 0x12, 0x03, 0xbf,
+  0xfa, 0xf3, 0x4a, 0x9c, 0xa5, 0xbd, 0x9c, 0x0d
+};
+STATIC CONST UINT8 mHmacCavpReseedNonce[] = {
+  0x0e, 0x66, 0xf7, 0x1e, 0xdc, 0x43, 0xe4, 0x2a, 0x45, 0xad, 0x3c, 0x6f,
+  0xc6, 0xcd, 0xc4, 0xdf
+};
+STATIC CONST UINT8 mHmacCavpReseedEntropyReseed[] = {
+  0x01, 0x92, 0x0a, 0x4e, 0x66, 0x9e, 0xd3, 0xa8, 0x5a, 0xe8, 0xa3, 0x3b,
+  0x35, 0xa7, 0x4a, 0xd7, 0xfb, 0x2a, 0x6b, 0xb4, 0xcf, 0x39, 0x5c, 0xe0,
+  0x03, 0x34, 0xa9, 0xc9, 0xa5, 0xa5, 0xd5, 0x52
+};
+STATIC CONST UINT8 mHmacCavpReseedReturnedBits[] = {
+  0x76, 0xfc, 0x79, 0xfe, 0x9b, 0x50, 0xbe, 0xcc, 0xc9, 0x91, 0xa1, 0x1b,
+  0x56, 0x35, 0x78, 0x3a, 0x83, 0x53, 0x6a, 0xdd, 0x03, 0xc1, 0x57, 0xfb,
+  0x30, 0x64, 0x5e, 0x61, 0x1c, 0x28, 0x98, 0xbb, 0x2b, 0x1b, 0xc2, 0x15,
+  0x00, 0x02, 0x09, 0x20, 0x8c, 0xd5, 0x06, 0xcb, 0x28, 0xda, 0x2a, 0x51,
+  0xbd, 0xb0, 0x38, 0x26, 0xaa, 0xf2, 0xbd, 0x23, 0x35, 0xd5, 0x76, 0xd5,
+  0x19, 0x16, 0x08, 0x42, 0xe7, 0x15, 0x8a, 0xd0, 0x94, 0x9d, 0x1a, 0x9e,
+  0xc3, 0xe6, 0x6e, 0xa1, 0xb1, 0xa0, 0x64, 0xb0, 0x05, 0xde, 0x91, 0x4e,
+  0xac, 0x2e, 0x9d, 0x4f, 0x2d, 0x72, 0xa8, 0x61, 0x6a, 0x80, 0x22, 0x54,
+  0x22, 0x91, 0x82, 0x50, 0xff, 0x66, 0xa4, 0x1b, 0xd2, 0xf8, 0x64, 0xa6,
+  0xa3, 0x8c, 0xc5, 0xb6, 0x49, 0x9d, 0xc4, 0x3f, 0x7f, 0x2b, 0xd0, 0x9e,
+  0x1e, 0x0f, 0x8f, 0x58, 0x85, 0x93, 0x51, 0x24
+};
+
+//
+// CAVP Hash_DRBG.rsp (no_reseed), [SHA-256], COUNT = 0
+//
+STATIC CONST UINT8 mHashCavpNoReseedEntropy[] = {
+  0xa6, 0x5a, 0xd0, 0xf3, 0x45, 0xdb, 0x4e, 0x0e, 0xff, 0xe8, 0x75, 0xc3,
+  0xa2, 0xe7, 0x1f, 0x42, 0xc7, 0x12, 0x9d, 0x62, 0x0f, 0xf5, 0xc1, 0x19,
+  0xa9, 0xef, 0x55, 0xf0, 0x51, 0x85, 0xe0, 0xfb
+};
+STATIC CONST UINT8 mHashCavpNoReseedNonce[] = {
+  0x85, 0x81, 0xf9, 0x31, 0x75, 0x17, 0x27, 0x6e, 0x06, 0xe9, 0x60, 0x7d,
+  0xdb, 0xcb, 0xcc, 0x2e
+};
+STATIC CONST UINT8 mHashCavpNoReseedReturnedBits[] = {
+  0xd3, 0xe1, 0x60, 0xc3, 0x5b, 0x99, 0xf3, 0x40, 0xb2, 0x62, 0x82, 0x64,
+  0xd1, 0x75, 0x10, 0x60, 0xe0, 0x04, 0x5d, 0xa3, 0x83, 0xff, 0x57, 0xa5,
+  0x7d, 0x73, 0xa6, 0x73, 0xd2, 0xb8, 0xd8, 0x0d, 0xaa, 0xf6, 0xa6, 0xc3,
+  0x5a, 0x91, 0xbb, 0x45, 0x79, 0xd7, 0x3f, 0xd0, 0xc8, 0xfe, 0xd1, 0x11,
+  0xb0, 0x39, 0x13, 0x06, 0x82, 0x8a, 0xdf, 0xed, 0x52, 0x8f, 0x01, 0x81,
+  0x21, 0xb3, 0xfe, 0xbd, 0xc3, 0x43, 0xe7, 0x97, 0xb8, 0x7d, 0xbb, 0x63,
+  0xdb, 0x13, 0x33, 0xde, 0xd9, 0xd1, 0xec, 0xe1, 0x77, 0xcf, 0xa6, 0xb7,
+  0x1f, 0xe8, 0xab, 0x1d, 0xa4, 0x66, 0x24, 0xed, 0x64, 0x15, 0xe5, 0x1c,
+  0xcd, 0xe2, 0xc7, 0xca, 0x86, 0xe2, 0x83, 0x99, 0x0e, 0xea, 0xeb, 0x91,
+  0x12, 0x04, 0x15, 0x52, 0x8b, 0x22, 0x95, 0x91, 0x02, 0x81, 0xb0, 0x2d,
+  0xd4, 0x31, 0xf4, 0xc9, 0xf7, 0x04, 0x27, 0xdf
+};
+
+STATIC CONST DRBG_KAT  mCavpKat[] = {
+  {
+    "CtrCavpNoReseed",
+    DrbgCtrAes256,
+    mCtrCavpNoReseedEntropy,
+    mCtrCavpNoReseedNonce,
+    NULL,
+    NULL,
+    0,
+    NULL,
+    0,
+    NULL,
+    NULL,
+    0,
+    mCtrCavpNoReseedReturnedBits,
+    sizeof (mCtrCavpNoReseedReturnedBits)
+  },
+  {
+    "HmacCavpNoReseed",
+    DrbgHmacSha256,
+    mHmacCavpNoReseedEntropy,
+    mHmacCavpNoReseedNonce,
+    NULL,
+    NULL,
+    0,
+    NULL,
+    0,
+    NULL,
+    NULL,
+    0,
+    mHmacCavpNoReseedReturnedBits,
+    sizeof (mHmacCavpNoReseedReturnedBits)
+  },
+  {
+    "HmacCavpReseed",
+    DrbgHmacSha256,
+    mHmacCavpReseedEntropy,
+    mHmacCavpReseedNonce,
+    mHmacCavpReseedEntropyReseed,
+    NULL,
+    0,
+    NULL,
+    0,
+    NULL,
+    NULL,
+    0,
+    mHmacCavpReseedReturnedBits,
+    sizeof (mHmacCavpReseedReturnedBits)
+  },
+  {
+    "HashCavpNoReseed",
+    DrbgHashSha256,
+    mHashCavpNoReseedEntropy,
+    mHashCavpNoReseedNonce,
+    NULL,
+    NULL,
+    0,
+    NULL,
+    0,
+    NULL,
+    NULL,
+    0,
+    mHashCavpNoReseedReturnedBits,
+    sizeof (mHashCavpNoReseedReturnedBits)
+  }
+};
+
+//
+// The CAVP files above only cover the case without personalization string
+// or additional input for each mechanism at COUNT = 0. The vectors below
+// exercise personalization, additional input and reseed with additional
+// input on all three mechanisms. Their expected output was generated with
+// the OpenSSL 3 CTR-DRBG (AES-256-CTR, use_df), HMAC-DRBG and HASH-DRBG
+// (SHA256) implementations.
+//
+STATIC CONST UINT8 mCtrAddInputEntropy[] = {
+  0x7f, 0xa5, 0xcd, 0xf7, 0x23, 0x51, 0x81, 0xb3, 0xe7, 0x1d, 0x55, 0x8f,
+  0xcb, 0x09, 0x49, 0x8b, 0xcf, 0x15, 0x5d, 0xa7, 0xf3, 0x41, 0x91, 0xe3,
+  0x37, 0x8d, 0xe5, 0x3f, 0x9b, 0xf9, 0x59, 0xbb
+};
+STATIC CONST UINT8 mCtrAddInputNonce[] = {
+  0xf1, 0x89, 0x23, 0xbf, 0x5d, 0xfd, 0x9f, 0x43, 0xe9, 0x91, 0x3b, 0xe7,
+  0x95, 0x45, 0xf7, 0xab
+};
+STATIC CONST UINT8 mCtrAddInputPersonalization[] = {
+  0xd5, 0x51, 0xcf, 0x4f, 0xd1, 0x55, 0xdb, 0x63, 0xed, 0x79, 0x07, 0x97,
+  0x29, 0xbd, 0x53, 0xeb, 0x85, 0x21, 0xbf, 0x5f, 0x01, 0xa5, 0x4b, 0xf3,
+  0x9d, 0x49, 0xf7, 0xa7, 0x59, 0x0d, 0xc3, 0x7b
+};
+STATIC CONST UINT8 mCtrAddInputAdditionalInput1[] = {
+  0xb9, 0x19, 0x7b, 0xdf, 0x45, 0xad, 0x17, 0x83, 0xf1, 0x61, 0xd3, 0x47,
+  0xbd, 0x35, 0xaf, 0x2b, 0xa9, 0x29, 0xab, 0x2f, 0xb5, 0x3d, 0xc7, 0x53,
+  0xe1, 0x71, 0x03, 0x97, 0x2d, 0xc5, 0x5f, 0xfb
+};
+STATIC CONST UINT8 mCtrAddInputAdditionalInput2[] = {
+  0x2b, 0xfd, 0xd1, 0xa7, 0x7f, 0x59, 0x35, 0x13, 0xf3, 0xd5, 0xb9, 0x9f,
+  0x87, 0x71, 0x5d, 0x4b, 0x3b, 0x2d, 0x21, 0x17, 0x0f, 0x09, 0x05, 0x03,
+  0x03, 0x05, 0x09, 0x0f, 0x17, 0x21, 0x2d, 0x3b
+};
+STATIC CONST UINT8 mCtrAddInputReturnedBits[] = {
+  0x76, 0x49, 0x8f, 0x5e, 0xf9, 0xdc, 0x8a, 0x0a, 0x76, 0x1a, 0x69, 0x52,
+  0xbb, 0x5c, 0x64, 0xfb, 0xc2, 0x95, 0xa1, 0xf2, 0xf2, 0x8e, 0xb7, 0xca,
+  0xa5, 0xa8, 0xa1, 0xad, 0x63, 0x5b, 0x4e, 0x11, 0x7c, 0xef, 0x74, 0x09,
+  0xaa, 0xa6, 0xc1, 0x8c, 0x87, 0x69, 0x44, 0xc0, 0x1d, 0xd5, 0xb5, 0xef,
+  0x98, 0x47, 0xf9, 0xcf, 0x86, 0xf1, 0x32, 0x53, 0x4f, 0xcb, 0x70, 0xdc,
+  0x81, 0x2f, 0xa8, 0xf8
+};
+
+STATIC CONST UINT8 mCtrReseedAddInputEntropy[] = {
+  0xa4, 0xef, 0x3c, 0x8b, 0xdc, 0x2f, 0x84, 0xdb, 0x34, 0x8f, 0xec, 0x4b,
+  0xac, 0x0f, 0x74, 0xdb, 0x44, 0xaf, 0x1c, 0x8b, 0xfc, 0x6f, 0xe4, 0x5b,
+  0xd4, 0x4f, 0xcc, 0x4b, 0xcc, 0x4f, 0xd4, 0x5b
+};
+STATIC CONST UINT8 mCtrReseedAddInputNonce[] = {
+  0x16, 0xd3, 0x92, 0x53, 0x16, 0xdb, 0xa2, 0x6b, 0x36, 0x03, 0xd2, 0xa3,
+  0x76, 0x4b, 0x22, 0xfb
+};
+STATIC CONST UINT8 mCtrReseedAddInputEntropyReseed[] = {
+  0x88, 0xb7, 0xe8, 0x1b, 0x50, 0x87, 0xc0, 0xfb, 0x38, 0x77, 0xb8, 0xfb,
+  0x40, 0x87, 0xd0, 0x1b, 0x68, 0xb7, 0x08, 0x5b, 0xb0, 0x07, 0x60, 0xbb,
+  0x18, 0x77, 0xd8, 0x3b, 0xa0, 0x07, 0x70, 0xdb
+};
+STATIC CONST UINT8 mCtrReseedAddInputAdditionalInputReseed[] = {
+  0x6c, 0x7f, 0x94, 0xab, 0xc4, 0xdf, 0xfc, 0x1b, 0x3c, 0x5f, 0x84, 0xab,
+  0xd4, 0xff, 0x2c, 0x5b, 0x8c, 0xbf, 0xf4, 0x2b, 0x64, 0x9f, 0xdc, 0x1b,
+  0x5c, 0x9f, 0xe4, 0x2b, 0x74, 0xbf, 0x0c, 0x5b
+};
+STATIC CONST UINT8 mCtrReseedAddInputPersonalization[] = {
+  0xfa, 0x9b, 0x3e, 0xe3, 0x8a, 0x33, 0xde, 0x8b, 0x3a, 0xeb, 0x9e, 0x53,
+  0x0a, 0xc3, 0x7e, 0x3b, 0xfa, 0xbb, 0x7e, 0x43, 0x0a, 0xd3, 0x9e, 0x6b,
+  0x3a, 0x0b, 0xde, 0xb3, 0x8a, 0x63, 0x3e, 0x1b
+};
+STATIC CONST UINT8 mCtrReseedAddInputAdditionalInput1[] = {
+  0xde, 0x63, 0xea, 0x73, 0xfe, 0x8b, 0x1a, 0xab, 0x3e, 0xd3, 0x6a, 0x03,
+  0x9e, 0x3b, 0xda, 0x7b, 0x1e, 0xc3, 0x6a, 0x13, 0xbe, 0x6b, 0x1a, 0xcb,
+  0x7e, 0x33, 0xea, 0xa3, 0x5e, 0x1b, 0xda, 0x9b
+};
+STATIC CONST UINT8 mCtrReseedAddInputAdditionalInput2[] = {
+  0x50, 0x47, 0x40, 0x3b, 0x38, 0x37, 0x38, 0x3b, 0x40, 0x47, 0x50, 0x5b,
+  0x68, 0x77, 0x88, 0x9b, 0xb0, 0xc7, 0xe0, 0xfb, 0x18, 0x37, 0x58, 0x7b,
+  0xa0, 0xc7, 0xf0, 0x1b, 0x48, 0x77, 0xa8, 0xdb
+};
+STATIC CONST UINT8 mCtrReseedAddInputReturnedBits[] = {
+  0xa5, 0x66, 0xf2, 0x78, 0x11, 0xa2, 0xab, 0xe2, 0x6a, 0xc2, 0x38, 0x61,
+  0x7e, 0xb0, 0xfe, 0x71, 0x2c, 0x1a, 0xbf, 0xf7, 0x8a, 0x1f, 0xb1, 0x53,
+  0xb3, 0x19, 0x4f, 0xf7, 0x35, 0xd0, 0x13, 0x9b, 0x2c, 0x87, 0xf4, 0x6a,
+  0x30, 0x8a, 0xba, 0x58, 0x01, 0xb5, 0x21, 0x08, 0x0f, 0xd6, 0x8e, 0xec,
+  0x38, 0xcf, 0xb5, 0x06, 0x4d, 0xc4, 0x82, 0xab, 0xde, 0xb9, 0x32, 0x17,
+  0xfd, 0x74, 0x74, 0x06
+};
+
+STATIC CONST UINT8 mHmacAddInputEntropy[] = {
+  0xc9, 0x39, 0xab, 0x1f, 0x95, 0x0d, 0x87, 0x03, 0x81, 0x01, 0x83, 0x07,
+  0x8d, 0x15, 0x9f, 0x2b, 0xb9, 0x49, 0xdb, 0x6f, 0x05, 0x9d, 0x37, 0xd3,
+  0x71, 0x11, 0xb3, 0x57, 0xfd, 0xa5, 0x4f, 0xfb
+};
+STATIC CONST UINT8 mHmacAddInputNonce[] = {
+  0x3b, 0x1d, 0x01, 0xe7, 0xcf, 0xb9, 0xa5, 0x93, 0x83, 0x75, 0x69, 0x5f,
+  0x57, 0x51, 0x4d, 0x4b
+};
+STATIC CONST UINT8 mHmacAddInputPersonalization[] = {
+  0x1f, 0xe5, 0xad, 0x77, 0x43, 0x11, 0xe1, 0xb3, 0x87, 0x5d, 0x35, 0x0f,
+  0xeb, 0xc9, 0xa9, 0x8b, 0x6f, 0x55, 0x3d, 0x27, 0x13, 0x01, 0xf1, 0xe3,
+  0xd7, 0xcd, 0xc5, 0xbf, 0xbb, 0xb9, 0xb9, 0xbb
+};
+STATIC CONST UINT8 mHmacAddInputAdditionalInput1[] = {
+  0x03, 0xad, 0x59, 0x07, 0xb7, 0x69, 0x1d, 0xd3, 0x8b, 0x45, 0x01, 0xbf,
+  0x7f, 0x41, 0x05, 0xcb, 0x93, 0x5d, 0x29, 0xf7, 0xc7, 0x99, 0x6d, 0x43,
+  0x1b, 0xf5, 0xd1, 0xaf, 0x8f, 0x71, 0x55, 0x3b
+};
+STATIC CONST UINT8 mHmacAddInputAdditionalInput2[] = {
+  0x75, 0x91, 0xaf, 0xcf, 0xf1, 0x15, 0x3b, 0x63, 0x8d, 0xb9, 0xe7, 0x17,
+  0x49, 0x7d, 0xb3, 0xeb, 0x25, 0x61, 0x9f, 0xdf, 0x21, 0x65, 0xab, 0xf3,
+  0x3d, 0x89, 0xd7, 0x27, 0x79, 0xcd, 0x23, 0x7b
+};
+STATIC CONST UINT8 mHmacAddInputReturnedBits[] = {
+  0xb7, 0x2e, 0x92, 0x86, 0x54, 0x57, 0xbb, 0xf0, 0x44, 0xd6, 0x86, 0xbf,
+  0xb2, 0x47, 0x7d, 0x0a, 0x1b, 0xa5, 0x4e, 0xf0, 0x5a, 0x8f, 0x7c, 0xc2,
+  0x76, 0x73, 0xcf, 0xf3, 0x28, 0xce, 0x28, 0x6f, 0xa1, 0x2c, 0x88, 0x29,
+  0xf6, 0x3a, 0xb2, 0x7c, 0x43, 0x3e, 0xbe, 0xd3, 0x0c, 0xc8, 0xbf, 0xcb,
+  0x4a, 0x05, 0x46, 0x0c, 0x84, 0xff, 0x67, 0x6e, 0x65, 0xc0, 0x07, 0x3b,
+  0xd9, 0x63, 0x6d, 0xd3, 0xb1, 0x40, 0x94, 0xac, 0x09, 0x1f, 0x1b, 0x28,
+  0x73, 0x55, 0x11, 0xcb, 0x4a, 0x1a, 0xa5, 0xcf, 0x7a, 0x01, 0x2c, 0x7f,
+  0x9c, 0x66, 0x55, 0xc5, 0x8d, 0xc3, 0xa7, 0x61, 0x02, 0x06, 0x0b, 0x5d,
+  0x80, 0x94, 0x93, 0x24, 0x16, 0x61, 0x5c, 0xad, 0x53, 0x0b, 0xdb, 0xb5,
+  0x37, 0xfb, 0xee, 0x30, 0x8b, 0xd6, 0xec, 0xd0, 0xcc, 0x61, 0xb0, 0x77,
+  0x7b, 0x06, 0x25, 0x94, 0x4a, 0x27, 0x3c, 0xbd
+};
+
+STATIC CONST UINT8 mHmacReseedAddInputEntropy[] = {
+  0xee, 0x83, 0x1a, 0xb3, 0x4e, 0xeb, 0x8a, 0x2b, 0xce, 0x73, 0x1a, 0xc3,
+  0x6e, 0x1b, 0xca, 0x7b, 0x2e, 0xe3, 0x9a, 0x53, 0x0e, 0xcb, 0x8a, 0x4b,
+  0x0e, 0xd3, 0x9a, 0x63, 0x2e, 0xfb, 0xca, 0x9b
+};
+STATIC CONST UINT8 mHmacReseedAddInputNonce[] = {
+  0x60, 0x67, 0x70, 0x7b, 0x88, 0x97, 0xa8, 0xbb, 0xd0, 0xe7, 0x00, 0x1b,
+  0x38, 0x57, 0x78, 0x9b
+};
+STATIC CONST UINT8 mHmacReseedAddInputEntropyReseed[] = {
+  0xd2, 0x4b, 0xc6, 0x43, 0xc2, 0x43, 0xc6, 0x4b, 0xd2, 0x5b, 0xe6, 0x73,
+  0x02, 0x93, 0x26, 0xbb, 0x52, 0xeb, 0x86, 0x23, 0xc2, 0x63, 0x06, 0xab,
+  0x52, 0xfb, 0xa6, 0x53, 0x02, 0xb3, 0x66, 0x1b
+};
+STATIC CONST UINT8 mHmacReseedAddInputAdditionalInputReseed[] = {
+  0xb6, 0x13, 0x72, 0xd3, 0x36, 0x9b, 0x02, 0x6b, 0xd6, 0x43, 0xb2, 0x23,
+  0x96, 0x0b, 0x82, 0xfb, 0x76, 0xf3, 0x72, 0xf3, 0x76, 0xfb, 0x82, 0x0b,
+  0x96, 0x23, 0xb2, 0x43, 0xd6, 0x6b, 0x02, 0x9b
+};
+STATIC CONST UINT8 mHmacReseedAddInputPersonalization[] = {
+  0x44, 0x2f, 0x1c, 0x0b, 0xfc, 0xef, 0xe4, 0xdb, 0xd4, 0xcf, 0xcc, 0xcb,
+  0xcc, 0xcf, 0xd4, 0xdb, 0xe4, 0xef, 0xfc, 0x0b, 0x1c, 0x2f, 0x44, 0x5b,
+  0x74, 0x8f, 0xac, 0xcb, 0xec, 0x0f, 0x34, 0x5b
+};
+STATIC CONST UINT8 mHmacReseedAddInputAdditionalInput1[] = {
+  0x28, 0xf7, 0xc8, 0x9b, 0x70, 0x47, 0x20, 0xfb, 0xd8, 0xb7, 0x98, 0x7b,
+  0x60, 0x47, 0x30, 0x1b, 0x08, 0xf7, 0xe8, 0xdb, 0xd0, 0xc7, 0xc0, 0xbb,
+  0xb8, 0xb7, 0xb8, 0xbb, 0xc0, 0xc7, 0xd0, 0xdb
+};
+STATIC CONST UINT8 mHmacReseedAddInputAdditionalInput2[] = {
+  0x9a, 0xdb, 0x1e, 0x63, 0xaa, 0xf3, 0x3e, 0x8b, 0xda, 0x2b, 0x7e, 0xd3,
+  0x2a, 0x83, 0xde, 0x3b, 0x9a, 0xfb, 0x5e, 0xc3, 0x2a, 0x93, 0xfe, 0x6b,
+  0xda, 0x4b, 0xbe, 0x33, 0xaa, 0x23, 0x9e, 0x1b
+};
+STATIC CONST UINT8 mHmacReseedAddInputReturnedBits[] = {
+  0x37, 0xa3, 0xfe, 0x6b, 0xd3, 0x07, 0x14, 0xc3, 0xa4, 0x0d, 0x68, 0xde,
+  0x76, 0x27, 0x12, 0x6a, 0xed, 0xbc, 0xb9, 0x51, 0x20, 0xd7, 0x71, 0x95,
+  0x6e, 0xeb, 0x5c, 0x56, 0x75, 0xc5, 0xa0, 0x55, 0x11, 0x67, 0x57, 0xb4,
+  0x62, 0xf0, 0xe8, 0x2f, 0xe3, 0x73, 0x78, 0xde, 0x9d, 0xb3, 0x13, 0x14,
+  0x55, 0xbf, 0x74, 0xec, 0xde, 0xca, 0xfe, 0xaa, 0xc1, 0x84, 0x99, 0xb9,
+  0x07, 0xfa, 0xe7, 0x30, 0x71, 0x2a, 0xd7, 0x74, 0x1b, 0x96, 0xac, 0x5e,
+  0xe9, 0xb0, 0x8b, 0x57, 0x0e, 0x8c, 0xa8, 0xd3, 0x59, 0xd0, 0x13, 0x0a,
+  0x9b, 0x22, 0xb3, 0xc8, 0x8a, 0x9e, 0xf0, 0x27, 0x96, 0x0c, 0x7a, 0x10,
+  0x0c, 0x0c, 0x20, 0x51, 0x8b, 0x55, 0x5a, 0x0a, 0x77, 0xf1, 0xb0, 0x8f,
+  0xf3, 0x4e, 0x58, 0x05, 0xe7, 0x60, 0x3d, 0x09, 0x72, 0xf4, 0x4a, 0x94,
+  0xe0, 0x7e, 0x6b, 0x30, 0x64, 0x9a, 0xaf, 0x66
+};
+
+STATIC CONST UINT8 mHashAddInputEntropy[] = {
+  0x13, 0xcd, 0x89, 0x47, 0x07, 0xc9, 0x8d, 0x53, 0x1b, 0xe5, 0xb1, 0x7f,
+  0x4f, 0x21, 0xf5, 0xcb, 0xa3, 0x7d, 0x59, 0x37, 0x17, 0xf9, 0xdd, 0xc3,
+  0xab, 0x95, 0x81, 0x6f, 0x5f, 0x51, 0x45, 0x3b
+};
+STATIC CONST UINT8 mHashAddInputNonce[] = {
+  0x85, 0xb1, 0xdf, 0x0f, 0x41, 0x75, 0xab, 0xe3, 0x1d, 0x59, 0x97, 0xd7,
+  0x19, 0x5d, 0xa3, 0xeb
+};
+STATIC CONST UINT8 mHashAddInputPersonalization[] = {
+  0x69, 0x79, 0x8b, 0x9f, 0xb5, 0xcd, 0xe7, 0x03, 0x21, 0x41, 0x63, 0x87,
+  0xad, 0xd5, 0xff, 0x2b, 0x59, 0x89, 0xbb, 0xef, 0x25, 0x5d, 0x97, 0xd3,
+  0x11, 0x51, 0x93, 0xd7, 0x1d, 0x65, 0xaf, 0xfb
+};
+STATIC CONST UINT8 mHashAddInputAdditionalInput1[] = {
+  0x4d, 0x41, 0x37, 0x2f, 0x29, 0x25, 0x23, 0x23, 0x25, 0x29, 0x2f, 0x37,
+  0x41, 0x4d, 0x5b, 0x6b, 0x7d, 0x91, 0xa7, 0xbf, 0xd9, 0xf5, 0x13, 0x33,
+  0x55, 0x79, 0x9f, 0xc7, 0xf1, 0x1d, 0x4b, 0x7b
+};
+STATIC CONST UINT8 mHashAddInputAdditionalInput2[] = {
+  0xbf, 0x25, 0x8d, 0xf7, 0x63, 0xd1, 0x41, 0xb3, 0x27, 0x9d, 0x15, 0x8f,
+  0x0b, 0x89, 0x09, 0x8b, 0x0f, 0x95, 0x1d, 0xa7, 0x33, 0xc1, 0x51, 0xe3,
+  0x77, 0x0d, 0xa5, 0x3f, 0xdb, 0x79, 0x19, 0xbb
+};
+STATIC CONST UINT8 mHashAddInputReturnedBits[] = {
+  0xb8, 0xda, 0x2a, 0x4d, 0xf0, 0x66, 0xd0, 0x36, 0x97, 0xdc, 0xbb, 0x9a,
+  0xa0, 0x04, 0xa6, 0xfb, 0xd7, 0xf6, 0xaf, 0x42, 0x58, 0xeb, 0xc6, 0x8a,
+  0x10, 0x54, 0x60, 0x56, 0x2c, 0xeb, 0xd7, 0xfe, 0xdf, 0xf2, 0x17, 0x1c,
+  0x73, 0x9d, 0x6a, 0x01, 0x51, 0xa9, 0xb0, 0x22, 0x49, 0x0d, 0x21, 0x53,
+  0xc4, 0xb5, 0x9d, 0x21, 0x5b, 0x26, 0x82, 0xee, 0x0e, 0x61, 0x01, 0x3e,
+  0xa2, 0xbb, 0x4e, 0xd3, 0x06, 0x2a, 0x00, 0xd9, 0xe7, 0x37, 0x40, 0x71,
+  0x80, 0x03, 0x4f, 0xe7, 0x40, 0xcf, 0x5a, 0x54, 0x64, 0xff, 0x60, 0x22,
+  0xdb, 0x69, 0xb5, 0xb7, 0xe0, 0xbe, 0x13, 0x34, 0xba, 0x26, 0x63, 0x0d,
+  0x49, 0x23, 0x0d, 0x2f, 0x1f, 0xee, 0x19, 0x59, 0x28, 0x6a, 0xf5, 0x26,
+  0xf0, 0xe1, 0xd1, 0xd5, 0x16, 0x6c, 0x97, 0x5a, 0xc7, 0x63, 0x4c, 0x00,
+  0x53, 0xa9, 0x59, 0x50, 0x07, 0x2f, 0xd0, 0x14
+};
+
+STATIC CONST UINT8 mHashReseedAddInputEntropy[] = {
+  0x38, 0x17, 0xf8, 0xdb, 0xc0, 0xa7, 0x90, 0x7b, 0x68, 0x57, 0x48, 0x3b,
+  0x30, 0x27, 0x20, 0x1b, 0x18, 0x17, 0x18, 0x1b, 0x20, 0x27, 0x30, 0x3b,
+  0x48, 0x57, 0x68, 0x7b, 0x90, 0xa7, 0xc0, 0xdb
+};
+STATIC CONST UINT8 mHashReseedAddInputNonce[] = {
+  0xaa, 0xfb, 0x4e, 0xa3, 0xfa, 0x53, 0xae, 0x0b, 0x6a, 0xcb, 0x2e, 0x93,
+  0xfa, 0x63, 0xce, 0x3b
+};
+STATIC CONST UINT8 mHashReseedAddInputEntropyReseed[] = {
+  0x1c, 0xdf, 0xa4, 0x6b, 0x34, 0xff, 0xcc, 0x9b, 0x6c, 0x3f, 0x14, 0xeb,
+  0xc4, 0x9f, 0x7c, 0x5b, 0x3c, 0x1f, 0x04, 0xeb, 0xd4, 0xbf, 0xac, 0x9b,
+  0x8c, 0x7f, 0x74, 0x6b, 0x64, 0x5f, 0x5c, 0x5b
+};
+STATIC CONST UINT8 mHashReseedAddInputAdditionalInputReseed[] = {
+  0x00, 0xa7, 0x50, 0xfb, 0xa8, 0x57, 0x08, 0xbb, 0x70, 0x27, 0xe0, 0x9b,
+  0x58, 0x17, 0xd8, 0x9b, 0x60, 0x27, 0xf0, 0xbb, 0x88, 0x57, 0x28, 0xfb,
+  0xd0, 0xa7, 0x80, 0x5b, 0x38, 0x17, 0xf8, 0xdb
+};
+STATIC CONST UINT8 mHashReseedAddInputPersonalization[] = {
+  0x8e, 0xc3, 0xfa, 0x33, 0x6e, 0xab, 0xea, 0x2b, 0x6e, 0xb3, 0xfa, 0x43,
+  0x8e, 0xdb, 0x2a, 0x7b, 0xce, 0x23, 0x7a, 0xd3, 0x2e, 0x8b, 0xea, 0x4b,
+  0xae, 0x13, 0x7a, 0xe3, 0x4e, 0xbb, 0x2a, 0x9b
+};
+STATIC CONST UINT8 mHashReseedAddInputAdditionalInput1[] = {
+  0x72, 0x8b, 0xa6, 0xc3, 0xe2, 0x03, 0x26, 0x4b, 0x72, 0x9b, 0xc6, 0xf3,
+  0x22, 0x53, 0x86, 0xbb, 0xf2, 0x2b, 0x66, 0xa3, 0xe2, 0x23, 0x66, 0xab,
+  0xf2, 0x3b, 0x86, 0xd3, 0x22, 0x73, 0xc6, 0x1b
+};
+STATIC CONST UINT8 mHashReseedAddInputAdditionalInput2[] = {
+  0xe4, 0x6f, 0xfc, 0x8b, 0x1c, 0xaf, 0x44, 0xdb, 0x74, 0x0f, 0xac, 0x4b,
+  0xec, 0x8f, 0x34, 0xdb, 0x84, 0x2f, 0xdc, 0x8b, 0x3c, 0xef, 0xa4, 0x5b,
+  0x14, 0xcf, 0x8c, 0x4b, 0x0c, 0xcf, 0x94, 0x5b
+};
+STATIC CONST UINT8 mHashReseedAddInputReturnedBits[] = {
+  0xa5, 0xf0, 0x21, 0x32, 0xa7, 0x10, 0x9e, 0xfd, 0x93, 0xda, 0x43, 0x2e,
+  0xd7, 0x1c, 0x0c, 0xda, 0x14, 0xdb, 0x92, 0x54, 0x14, 0x5e, 0x15, 0xab,
+  0x26, 0x5b, 0xc8, 0x4f, 0x8a, 0xaf, 0xac, 0x96, 0xd1, 0xf0, 0xc9, 0x05,
+  0x51, 0xa0, 0xf5, 0x69, 0x00, 0x3b, 0xbc, 0xd1, 0xa3, 0x35, 0xcd, 0x4a,
+  0x10, 0x1e, 0x2a, 0x16, 0x67, 0x3f, 0x24, 0xfa, 0xa1, 0x8c, 0x47, 0x6f,
+  0x96, 0x4b, 0x2a, 0x86, 0x04, 0xa3, 0x5c, 0x28, 0x36, 0xc9, 0xd7, 0xfd,
+  0x3c, 0xa8, 0x1f, 0xd9, 0x30, 0xc8, 0x09, 0xd9, 0x93, 0x9b, 0xdb, 0xdb,
+  0x3b, 0xf9, 0xfd, 0x0f, 0x33, 0x18, 0xe6, 0x82, 0x46, 0xa6, 0x92, 0x01,
+  0xa8, 0xd3, 0xe2, 0xf3, 0x60, 0x3f, 0xdf, 0xf4, 0x14, 0xca, 0x24, 0xe2,
+  0x62, 0xe0, 0xd3, 0x80, 0xb1, 0xab, 0xa8, 0xeb, 0x31, 0xa0, 0x24, 0x9d,
+  0x93, 0x00, 0x15, 0x71, 0x83, 0x07, 0xae, 0x3c
+};
+
+STATIC CONST DRBG_KAT  mKat[] = {
+  {
+    "CtrAddInput",
+    DrbgCtrAes256,
+    mCtrAddInputEntropy,
+    mCtrAddInputNonce,
+    NULL,
+    NULL,
+    0,
+    mCtrAddInputPersonalization,
+    sizeof (mCtrAddInputPersonalization),
+    mCtrAddInputAdditionalInput1,
+    mCtrAddInputAdditionalInput2,
+    sizeof (mCtrAddInputAdditionalInput1),
+    mCtrAddInputReturnedBits,
+    sizeof (mCtrAddInputReturnedBits)
+  },
+  {
+    "CtrReseedAddInput",
+    DrbgCtrAes256,
+    mCtrReseedAddInputEntropy,
+    mCtrReseedAddInputNonce,
+    mCtrReseedAddInputEntropyReseed,
+    mCtrReseedAddInputAdditionalInputReseed,
+    sizeof (mCtrReseedAddInputAdditionalInputReseed),
+    mCtrReseedAddInputPersonalization,
+    sizeof (mCtrReseedAddInputPersonalization),
+    mCtrReseedAddInputAdditionalInput1,
+    mCtrReseedAddInputAdditionalInput2,
+    sizeof (mCtrReseedAddInputAdditionalInput1),
+    mCtrReseedAddInputReturnedBits,
+    sizeof (mCtrReseedAddInputReturnedBits)
+  },
+  {
+    "HmacAddInput",
+    DrbgHmacSha256,
+    mHmacAddInputEntropy,
+    mHmacAddInputNonce,
+    NULL,
+    NULL,
+    0,
+    mHmacAddInputPersonalization,
+    sizeof (mHmacAddInputPersonalization),
+    mHmacAddInputAdditionalInput1,
+    mHmacAddInputAdditionalInput2,
+    sizeof (mHmacAddInputAdditionalInput1),
+    mHmacAddInputReturnedBits,
+    sizeof (mHmacAddInputReturnedBits)
+  },
+  {
+    "HmacReseedAddInput",
+    DrbgHmacSha256,
+    mHmacReseedAddInputEntropy,
+    mHmacReseedAddInputNonce,
+    mHmacReseedAddInputEntropyReseed,
+    mHmacReseedAddInputAdditionalInputReseed,
+    sizeof (mHmacReseedAddInputAdditionalInputReseed),
+    mHmacReseedAddInputPersonalization,
+    sizeof (mHmacReseedAddInputPersonalization),
+    mHmacReseedAddInputAdditionalInput1,
+    mHmacReseedAddInputAdditionalInput2,
+    sizeof (mHmacReseedAddInputAdditionalInput1),
+    mHmacReseedAddInputReturnedBits,
+    sizeof (mHmacReseedAddInputReturnedBits)
+  },
+  {
+    "HashAddInput",
+    DrbgHashSha256,
+    mHashAddInputEntropy,
+    mHashAddInputNonce,
+    NULL,
+    NULL,
+    0,
+    mHashAddInputPersonalization,
+    sizeof (mHashAddInputPersonalization),
+    mHashAddInputAdditionalInput1,
+    mHashAddInputAdditionalInput2,
+    sizeof (mHashAddInputAdditionalInput1),
+    mHashAddInputReturnedBits,
+    sizeof (mHashAddInputReturnedBits)
+  },
+  {
+    "HashReseedAddInput",
+    DrbgHashSha256,
+    mHashReseedAddInputEntropy,
+    mHashReseedAddInputNonce,
+    mHashReseedAddInputEntropyReseed,
+    mHashReseedAddInputAdditionalInputReseed,
+    sizeof (mHashReseedAddInputAdditionalInputReseed),
+    mHashReseedAddInputPersonalization,
+    sizeof (mHashReseedAddInputPersonalization),
+    mHashReseedAddInputAdditionalInput1,
+    mHashReseedAddInputAdditionalInput2,
+    sizeof (mHashReseedAddInputAdditionalInput1),
+    mHashReseedAddInputReturnedBits,
+    sizeof (mHashReseedAddInputReturnedBits)
+  }
+};
+
+STATIC DRBG_STATE  mState;
+
+STATIC
+EFI_STATUS
+EFIAPI
+TestGetEntropy (
+  IN  VOID   *Context,
+  IN  UINTN  Length,
+  OUT UINT8  *Buffer
+  )
+{
+  DRBG_TEST_ENTROPY  *Source;
+
+  Source = (DRBG_TEST_ENTROPY *)Context;
+  if ((Source->Next >= ARRAY_SIZE (Source->Input)) ||
+      (Source->Input[Source->Next] == NULL) ||
+      (Source->Length[Source->Next] != Length)) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  CopyMem (Buffer, Source->Input[Source->Next], Length);
+  Source->Next++;
+  return EFI_SUCCESS;
+}
+
+/**
+  Run one known answer vector.
+
+  @param[in]  Context  DRBG_KAT to run
+
+  @retval UNIT_TEST_PASSED  The DRBG produced the expected output.
+  @retval Others            A DrbgLib call failed or the output differs.
+**/
+STATIC
+UNIT_TEST_STATUS
+EFIAPI
+DrbgKnownAnswerTest (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  CONST DRBG_KAT     *Kat;
+  DRBG_TEST_ENTROPY  Source;
+  UINT8              Output[DRBG_KAT_MAX_RETURNED_BYTES];
+  EFI_STATUS         Status;
+
+  Kat = (CONST DRBG_KAT *)Context;
+  UT_ASSERT_TRUE (Kat->ReturnedBitsLength <= sizeof (Output));
+
+  ZeroMem (&Source, sizeof (Source));
+  Source.Input[0]  = Kat->Entropy;
+  Source.Length[0] = DRBG_SECURITY_STRENGTH_BYTES;
+  Source.Input[1]  = Kat->Nonce;
+  Source.Length[1] = DRBG_NONCE_BYTES;
+  Source.Input[2]  = Kat->EntropyReseed;
+  Source.Length[2] = DRBG_SECURITY_STRENGTH_BYTES;
+
+  Status = DrbgInstantiate (
+             &mState,
+             Kat->Mechanism,
+             TestGetEntropy,
+             &Source,
+             Kat->Personalization,
+             Kat->PersonalizationLength
+             );
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_EQUAL (Source.Next, 2);
+
+  if (Kat->EntropyReseed != NULL) {
+    Status = DrbgReseed (
+               &mState,
+               Kat->AdditionalInputReseed,
+               Kat->AdditionalInputReseedLength
+               );
+    UT_ASSERT_NOT_EFI_ERROR (Status);
+    UT_ASSERT_EQUAL (Source.Next, 3);
+  }
+
+  //
+  // The output of the first generate call is not part of the vector.
+  //
+  Status = DrbgGenerate (
+             &mState,
+             Kat->AdditionalInput1,
+             Kat->AdditionalInputLength,
+             Kat->ReturnedBitsLength,
+             Output
+             );
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+
+  Status = DrbgGenerate (
+             &mState,
+             Kat->AdditionalInput2,
+             Kat->AdditionalInputLength,
+             Kat->ReturnedBitsLength,
+             Output
+             );
+  UT_ASSERT_NOT_EFI_ERROR (Status);
+  UT_ASSERT_MEM_EQUAL (Output, Kat->ReturnedBits, Kat->ReturnedBitsLength);
+
+  //
+  // No request may have gone back to the entropy source.
+  //
+  UT_ASSERT_EQUAL (Source.Next, (Kat->EntropyReseed != NULL) ? 3 : 2);
+
+  return UNIT_TEST_PASSED;
+}
+
+/**
+  Release the DRBG state of a test, whether or not it passed.
+
+  @param[in]  Context  Unused
+**/
+STATIC
+VOID
+EFIAPI
+DrbgKnownAnswerCleanup (
+  IN UNIT_TEST_CONTEXT  Context
+  )
+{
+  DrbgUninstantiate (&mState);
+}
+
+STATIC
+EFI_STATUS
+AddKatSuite (
+  IN UNIT_TEST_FRAMEWORK_HANDLE  Framework,
+  IN CHAR8                       *Title,
+  IN CHAR8                       *Name,
+  IN CONST DRBG_KAT              *Kat,
+  IN UINTN                       Count
+  )
+{
+  UNIT_TEST_SUITE_HANDLE  Suite;
+  EFI_STATUS              Status;
+  UINTN                   Index;
+
+  Status = CreateUnitTestSuite (&Suite, Framework, Title, Name, NULL, NULL);
+  if (EFI_ERROR (Status)) {
+    return Status;
+  }
+
+  for (Index = 0; Index < Count; Index++) {
+    Status = AddTestCase (
+               Suite,
+               (CHAR8 *)Kat[Index].Name,
+               (CHAR8 *)Kat[Index].Name,
+               DrbgKnownAnswerTest,
+               NULL,
+               DrbgKnownAnswerCleanup,
+               (UNIT_TEST_CONTEXT)&Kat[Index]
+               );
+    if (EFI_ERROR (Status)) {
+      return Status;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+int
+main (
+  int   argc,
+  char  *argv[]
+  )
+{
+  UNIT_TEST_FRAMEWORK_HANDLE  Framework;
+  EFI_STATUS                  Status;
+
+  DEBUG ((DEBUG_INFO, "%a v%a\n", UNIT_TEST_APP_NAME, UNIT_TEST_APP_VERSION));
+
+  Framework = NULL;
+  Status = InitUnitTestFramework (
+             &Framework,
+             UNIT_TEST_APP_NAME,
+             gEfiCallerBaseName,
+             UNIT_TEST_APP_VERSION
+             );
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  Status = AddKatSuite (
+             Framework,
+             "NIST CAVP DRBGVS vectors",
+             "DrbgLib.Cavp",
+             mCavpKat,
+             ARRAY_SIZE (mCavpKat)
+             );
+  if (!EFI_ERROR (Status)) {
+    Status = AddKatSuite (
+               Framework,
+               "Personalization, additional input and reseed",
+               "DrbgLib.AdditionalInput",
+               mKat,
+               ARRAY_SIZE (mKat)
+               );
+  }
+  if (EFI_ERROR (Status)) {
+    goto Done;
+  }
+
+  Status = RunAllTestSuites (Framework);
+
+Done:
+  if (Framework != NULL) {
+    FreeUnitTestFramework (Framework);
+  }
+
+  return (int)Status;
+}
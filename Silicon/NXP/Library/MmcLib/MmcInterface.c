@@ -321,9 +321,9 @@ ReadBlock (
   Temp = NULL;
 
   DmaData.Bytes = Length;
-  DmaData.MapOperation = MapOperationBusMasterRead;
+  DmaData.MapOperation = MapOperationBusMasterWrite;
 
-  Temp = GetDmaBuffer (&DmaData);
+  Temp = MmcDmaMap (&DmaData, Buffer);
   if (Temp == NULL) {
     DEBUG ((DEBUG_ERROR,"Mmc Read : Failed to get DMA buffer \n"));
     return EFI_OUT_OF_RESOURCES;
@@ -341,10 +341,12 @@ ReadBlock (
     goto ReadExit;
   }
 
-  InternalMemCopyMem (Buffer, Temp , DmaData.Bytes);
+  if (DmaData.Type != MmcDmaDirect) {
+    InternalMemCopyMem (Buffer, Temp , Length);
+  }
 
 ReadExit:
-  FreeDmaBuffer (&DmaData);
+  MmcDmaUnmap (&DmaData);
   return Status;
 }
 
@@ -375,15 +377,17 @@ WriteBlock (
   Temp = NULL;
 
   DmaData.Bytes = Length;
-  DmaData.MapOperation = MapOperationBusMasterWrite;
+  DmaData.MapOperation = MapOperationBusMasterRead;
 
-  Temp = GetDmaBuffer (&DmaData);
+  Temp = MmcDmaMap (&DmaData, Buffer);
   if (Temp == NULL) {
     DEBUG ((DEBUG_ERROR,"Mmc Write : Failed to get DMA buffer \n"));
     return EFI_OUT_OF_RESOURCES;
   }
 
-  InternalMemCopyMem (Temp, Buffer, DmaData.Bytes);
+  if (DmaData.Type != MmcDmaDirect) {
+    InternalMemCopyMem (Temp, Buffer, Length);
+  }
 
   Status = PrepareTransfer (BaseAddress, MMC_DATA_WRITE, Length, Temp, &Cmd);
   if (Status) {
@@ -397,7 +401,7 @@ WriteBlock (
   }
 
 WriteExit:
-  FreeDmaBuffer (&DmaData);
+  MmcDmaUnmap (&DmaData);
   return Status;
 }
 
@@ -591,6 +595,8 @@ MmcInitialize (
   mMmc->FMin = MIN_CLK_FREQUENCY;
   mMmc->FMax = MIN ((UINT32)mMmc->SdhcClk, MAX_CLK_FREQUENCY);
 
+  MmcDmaInit (Regs);
+
   Status = InitMmc (Regs);
   if (Status != EFI_SUCCESS) {
       DEBUG ((DEBUG_ERROR,"Failed to initialize MMC\n"));
@@ -60,6 +60,7 @@
 #define SDXC_HOSTCAPBLT_SRS        0x00800000
 #define SDXC_HOSTCAPBLT_DMAS       0x00400000
 #define SDXC_HOSTCAPBLT_HSS        0x00200000
+#define SDXC_HOSTCAPBLT_ADMAS      0x00100000
 
 /**
   VDD Voltage Range
@@ -192,6 +193,8 @@
 #define PRCTL_DTW_4                0x00000002
 #define PRCTL_DTW_8                0x00000004
 #define PRCTL_BE                   0x00000030
+#define PRCTL_DMAS_MASK            0x00000300
+#define PRCTL_DMAS_ADMA2           0x00000200
 #define PROCTL_1_8_VOLT_SEL        0x00000400
 
 typedef struct {
@@ -236,11 +239,40 @@ typedef struct {
   UINT32 Scr;            // SDXC Control Register
 } SDXC_REGS;
 
+/**
+  ADMA2 descriptor attributes and limits
+**/
+#define ADMA2_ATTR_VALID           BIT0
+#define ADMA2_ATTR_END             BIT1
+#define ADMA2_ATTR_ACT_TRAN        BIT5
+#define ADMA2_MAX_DESC_LEN         SIZE_32KB
+#define ADMA2_MAX_DESC             ((MAX_UINT16 * MMC_MAX_BLOCK_LEN) / ADMA2_MAX_DESC_LEN + 1)
+
+/**
+  Persistent DMA bounce buffer size, and alignment needed for the caller's
+  buffer to be used for DMA directly
+**/
+#define MMC_DMA_BUFFER_SIZE        SIZE_1MB
+#define MMC_DMA_ALIGNMENT          4
+
+typedef struct {
+  UINT16 Attr;
+  UINT16 Len;
+  UINT32 Addr;
+} ADMA2_DESC;
+
+typedef enum {
+  MmcDmaDirect,          // Caller's buffer mapped in place
+  MmcDmaBounce,          // Persistent bounce buffer
+  MmcDmaAllocated        // Bounce buffer allocated for this transfer
+} MMC_DMA_TYPE;
+
 typedef struct {
   VOID *DmaAddr;
   UINTN Bytes;
   VOID *Mapping;
   DMA_MAP_OPERATION MapOperation;
+  MMC_DMA_TYPE Type;
 } DMA_DATA;
 
 typedef struct {
@@ -304,6 +336,43 @@ FreeDmaBuffer (
   IN  DMA_DATA      *DmaData
   );
 
+/**
+  Function to allocate the DMA resources kept for the lifetime of the driver
+
+  @param   Regs     Pointer to MMC host Controller
+
+**/
+VOID
+MmcDmaInit (
+  IN  SDXC_REGS     *Regs
+  );
+
+/**
+  Function to get a device address for a read/write operation
+
+  @param   DmaData  Pointer to Dma data Structure
+  @param   Buffer   Caller's data buffer
+
+  @retval           Device address to be used for the transfer
+
+**/
+VOID *
+MmcDmaMap (
+  IN  DMA_DATA      *DmaData,
+  IN  VOID          *Buffer
+  );
+
+/**
+  Function to release a device address returned by MmcDmaMap
+
+  @param   DmaData  Pointer to Dma data Structure
+
+**/
+VOID
+MmcDmaUnmap (
+  IN  DMA_DATA      *DmaData
+  );
+
 /**
   Function to set up MMC data (timeout value,watermark level,
   system address,block attributes etc.)
@@ -12,6 +12,7 @@
 
 **/
 
+#include <Library/BaseLib.h>
 #include <Library/IoAccessLib.h>
 #include <Library/IoLib.h>
 #include <Library/MmcLib.h>
@@ -20,6 +21,17 @@
 
 extern MMC *mMmc;
 
+//
+// DMA resources kept across transfers. They are shared by all controller
+// instances, since transfers are serialized by the host driver.
+//
+STATIC VOID                 *mDmaBuffer;
+STATIC EFI_PHYSICAL_ADDRESS mDmaBufferAddr;
+STATIC VOID                 *mDmaBufferMapping;
+STATIC ADMA2_DESC           *mAdmaTable;
+STATIC EFI_PHYSICAL_ADDRESS mAdmaTableAddr;
+STATIC VOID                 *mAdmaTableMapping;
+
 /**
   Function to read from MMC depending upon pcd
 
@@ -240,6 +252,192 @@ FreeDmaBuffer (
   return EFI_SUCCESS;
 }
 
+/**
+  Function to allocate and map a DMA common buffer
+
+  @param   Bytes    Size of the buffer
+  @param   Buffer   Returns the buffer
+  @param   PhyAddr  Returns the device address of the buffer
+  @param   Mapping  Returns the mapping of the buffer
+
+  @retval           Returns the allocation status
+
+**/
+STATIC
+EFI_STATUS
+AllocateCommonBuffer (
+  IN  UINTN                 Bytes,
+  OUT VOID                  **Buffer,
+  OUT EFI_PHYSICAL_ADDRESS  *PhyAddr,
+  OUT VOID                  **Mapping
+  )
+{
+  EFI_STATUS        Status;
+  UINTN             MappedBytes;
+
+  Status = DmaAllocateBuffer (EfiBootServicesData, EFI_SIZE_TO_PAGES (Bytes),
+                              Buffer);
+  if (Status) {
+    return Status;
+  }
+
+  MappedBytes = Bytes;
+  Status = DmaMap (MapOperationBusMasterCommonBuffer, *Buffer, &MappedBytes,
+                   PhyAddr, Mapping);
+  if (Status == EFI_SUCCESS && MappedBytes != Bytes) {
+    DmaUnmap (*Mapping);
+    Status = EFI_OUT_OF_RESOURCES;
+  }
+
+  if (Status) {
+    DmaFreeBuffer (EFI_SIZE_TO_PAGES (Bytes), *Buffer);
+    *Buffer = NULL;
+  }
+
+  return Status;
+}
+
+/**
+  Function to allocate the DMA resources kept for the lifetime of the driver
+
+  Failures are not fatal: transfers then fall back to a bounce buffer
+  allocated per transfer and to SDMA.
+
+  @param   Regs     Pointer to MMC host Controller
+
+**/
+VOID
+MmcDmaInit (
+  IN  SDXC_REGS     *Regs
+  )
+{
+  EFI_STATUS        Status;
+
+  if (mDmaBuffer == NULL) {
+    Status = AllocateCommonBuffer (MMC_DMA_BUFFER_SIZE, &mDmaBuffer,
+                                   &mDmaBufferAddr, &mDmaBufferMapping);
+    if (Status) {
+      DEBUG ((DEBUG_WARN, "MMC: no persistent DMA buffer (0x%x)\n", Status));
+    }
+  }
+
+  if (mAdmaTable == NULL && FixedPcdGetBool (PcdMmcAdma2Enable) &&
+      (MmcRead ((UINTN)&Regs->Hostcapblt) & SDXC_HOSTCAPBLT_ADMAS)) {
+    Status = AllocateCommonBuffer (ADMA2_MAX_DESC * sizeof (ADMA2_DESC),
+                                   (VOID **)&mAdmaTable, &mAdmaTableAddr,
+                                   &mAdmaTableMapping);
+    if (Status) {
+      DEBUG ((DEBUG_WARN, "MMC: no ADMA2 descriptor table (0x%x)\n", Status));
+    }
+  }
+}
+
+/**
+  Function to get a device address for a read/write operation
+
+  The caller's buffer is mapped in place when the controller can reach it,
+  otherwise the persistent bounce buffer is used. Only transfers larger than
+  the bounce buffer get a buffer allocated for them.
+
+  @param   DmaData  Pointer to Dma data Structure
+  @param   Buffer   Caller's data buffer
+
+  @retval           Device address to be used for the transfer
+
+**/
+VOID *
+MmcDmaMap (
+  IN  DMA_DATA      *DmaData,
+  IN  VOID          *Buffer
+  )
+{
+  EFI_STATUS        Status;
+  EFI_PHYSICAL_ADDRESS PhyAddr;
+  UINTN             Bytes;
+
+  if ((((UINTN)Buffer | DmaData->Bytes) & (MMC_DMA_ALIGNMENT - 1)) == 0) {
+    Bytes = DmaData->Bytes;
+    Status = DmaMap (DmaData->MapOperation, Buffer, &Bytes, &PhyAddr,
+                     &DmaData->Mapping);
+    if (Status == EFI_SUCCESS) {
+      // Address registers and ADMA2 descriptors are 32 bit wide
+      if ((Bytes == DmaData->Bytes) && (PhyAddr + Bytes <= BASE_4GB)) {
+        DmaData->Type = MmcDmaDirect;
+        DmaData->DmaAddr = Buffer;
+        return (VOID *)(UINTN)PhyAddr;
+      }
+      DmaUnmap (DmaData->Mapping);
+    }
+  }
+
+  if ((mDmaBuffer != NULL) && (DmaData->Bytes <= MMC_DMA_BUFFER_SIZE)) {
+    DmaData->Type = MmcDmaBounce;
+    DmaData->DmaAddr = mDmaBuffer;
+    return (VOID *)(UINTN)mDmaBufferAddr;
+  }
+
+  DmaData->Type = MmcDmaAllocated;
+  return GetDmaBuffer (DmaData);
+}
+
+/**
+  Function to release a device address returned by MmcDmaMap
+
+  @param   DmaData  Pointer to Dma data Structure
+
+**/
+VOID
+MmcDmaUnmap (
+  IN  DMA_DATA      *DmaData
+  )
+{
+  switch (DmaData->Type) {
+  case MmcDmaDirect:
+    DmaUnmap (DmaData->Mapping);
+    break;
+  case MmcDmaAllocated:
+    FreeDmaBuffer (DmaData);
+    break;
+  default:
+    break;
+  }
+}
+
+/**
+  Function to fill the ADMA2 descriptor table for a contiguous buffer
+
+  @param   Addr     Device address of the buffer
+  @param   Length   Length of the transfer
+
+**/
+STATIC
+VOID
+SdxcSetupAdma2 (
+  IN  EFI_PHYSICAL_ADDRESS Addr,
+  IN  UINTN                Length
+  )
+{
+  ADMA2_DESC        *Desc;
+  UINTN             Chunk;
+
+  ASSERT (Length > 0 && Length <= ADMA2_MAX_DESC * ADMA2_MAX_DESC_LEN);
+
+  Desc = mAdmaTable;
+  while (Length > 0) {
+    Chunk = MIN (Length, ADMA2_MAX_DESC_LEN);
+    Desc->Attr = ADMA2_ATTR_VALID | ADMA2_ATTR_ACT_TRAN;
+    Desc->Len = (UINT16)Chunk;
+    Desc->Addr = (UINT32)Addr;
+    Addr += Chunk;
+    Length -= Chunk;
+    Desc++;
+  }
+  Desc[-1].Attr |= ADMA2_ATTR_END;
+
+  // Descriptors must be in memory before the controller fetches them
+  MemoryFence ();
+}
+
 /**
   Function to select the transfer type flags depending upon given
   command and data packet
@@ -343,7 +541,20 @@ SdxcSetupData (
   }
 
   Addr = (EFI_PHYSICAL_ADDRESS)Data->Addr;
-  MmcWrite ((UINTN)&Regs->Dsaddr, Addr);
+
+  //
+  // With ADMA2 the whole multi-block transfer runs off one descriptor
+  // table, without SDMA stopping at buffer boundaries.
+  //
+  if ((mAdmaTable != NULL) &&
+      (MmcRead ((UINTN)&Regs->Hostcapblt) & SDXC_HOSTCAPBLT_ADMAS)) {
+    SdxcSetupAdma2 (Addr, Data->Blocks * Data->Blocksize);
+    MmcAndThenOr ((UINTN)&Regs->Proctl, ~PRCTL_DMAS_MASK, PRCTL_DMAS_ADMA2);
+    MmcWrite ((UINTN)&Regs->Adsaddr, (UINT32)mAdmaTableAddr);
+  } else {
+    MmcAnd ((UINTN)&Regs->Proctl, ~PRCTL_DMAS_MASK);
+    MmcWrite ((UINTN)&Regs->Dsaddr, Addr);
+  }
 
   MmcWrite ((UINTN)&Regs->Blkattr, Data->Blocks << 16 | Data->Blocksize);
 
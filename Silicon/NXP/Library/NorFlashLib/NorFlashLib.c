@@ -485,6 +485,89 @@ EXIT:
   return (Status);
 }
 
+/**
+  Program a run of whole blocks as one stream of write buffer pages.
+
+  The run is split into CFI write buffer sized pages, which may cross block
+  boundaries. A page whose flash contents already equal the source is not
+  programmed, so pages left in the erased state by a preceding erase and
+  pages that did not change cost one read instead of a buffer program.
+  The device is reset once for the whole run rather than once per block.
+
+  @param  Instance    NOR flash instance.
+  @param  Lba         First block of the run.
+  @param  NumBytes    Number of bytes to program, multiple of the block size.
+  @param  Buffer      Data to program.
+
+  @retval EFI_SUCCESS            The run was programmed.
+  @retval EFI_INVALID_PARAMETER  The run exceeds the device.
+  @retval EFI_DEVICE_ERROR       A page program timed out.
+**/
+EFI_STATUS
+NorFlashPlatformWriteBlocks (
+  IN  NOR_FLASH_INSTANCE  *Instance,
+  IN  EFI_LBA             Lba,
+  IN  UINTN               NumBytes,
+  IN  UINT8               *Buffer
+  )
+{
+  EFI_STATUS              Status;
+  FLASH_DATA              *SrcBuffer;
+  UINTN                   WordOffset;
+  UINTN                   NumWords;
+  UINTN                   PageWords;
+  UINTN                   IntWords;
+  UINTN                   Index;
+
+  if ((Buffer == NULL) ||
+      ((NumBytes % Instance->Media.BlockSize) != 0) ||
+      (((Lba * Instance->Media.BlockSize) + NumBytes) > Instance->Size)) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  Status = EFI_SUCCESS;
+  SrcBuffer = (FLASH_DATA *)Buffer;
+  WordOffset = GET_BLOCK_OFFSET (Lba) / sizeof (FLASH_DATA);
+  NumWords = NumBytes / sizeof (FLASH_DATA);
+  PageWords = mNorFlashDevices[Instance->Media.MediaId].MultiByteWordCount;
+
+  // Pages are compared against the array, so start from Read Array mode
+  NorFlashPlatformReset (Instance->DeviceBaseAddress);
+
+  while (NumWords > 0) {
+    // Stop each chunk at the next write buffer page boundary
+    IntWords = PageWords - (WordOffset & (PageWords - 1));
+    if (IntWords > NumWords) {
+      IntWords = NumWords;
+    }
+
+    for (Index = 0; Index < IntWords; Index++) {
+      if (FLASH_READ_DATA (CREATE_NOR_ADDRESS (Instance->DeviceBaseAddress,
+                     CREATE_BYTE_OFFSET (WordOffset + Index))) != SrcBuffer[Index]) {
+        break;
+      }
+    }
+
+    if (Index < IntWords) {
+      Status = NorFlashPlatformWritePageBuffer (Instance, WordOffset,
+                              IntWords, SrcBuffer);
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR, "%a: Failed to Write @TargetOffset 0x%x (%r)\n",
+                    __FUNCTION__, CREATE_BYTE_OFFSET (WordOffset), Status));
+        break;
+      }
+    }
+
+    WordOffset += IntWords;
+    NumWords -= IntWords;
+    SrcBuffer += IntWords;
+  }
+
+  // Put device back into Read Array mode (via Reset)
+  NorFlashPlatformReset (Instance->DeviceBaseAddress);
+  return Status;
+}
+
 EFI_STATUS
 NorFlashPlatformRead (
   IN  NOR_FLASH_INSTANCE  *Instance,
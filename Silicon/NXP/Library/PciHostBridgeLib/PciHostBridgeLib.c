@@ -18,6 +18,8 @@
 #include <Library/MemoryAllocationLib.h>
 #include <Library/PcdLib.h>
 #include <Library/PciHostBridgeLib.h>
+#include <Library/TimerExtensionLib.h>
+#include <Library/TimerLib.h>
 #include <Library/UefiBootServicesTableLib.h>
 #include <Library/UefiLib.h>
 #include <Pcie.h>
@@ -396,18 +398,19 @@ PcieOutboundSet (
 
 /**
 
-   Function to check PCIe controller LTSSM state
+   Function to read PCIe controller LTSSM state
 
    @param Pcie Address of PCIe host controller.
 
+   @return The LTSSM state, LTSSM_PCIE_L0 or above once the link is up.
+
 **/
 STATIC
-INTN
+UINT32
 PcieLinkState (
   IN EFI_PHYSICAL_ADDRESS Pcie
   )
 {
-  UINT32 State;
   UINT32 LtssmMask;
 
   if (PCI_LS_GEN4_CTRL) {
@@ -419,54 +422,127 @@ PcieLinkState (
   // Reading PCIe controller LTSSM state
   //
   if (FeaturePcdGet (PcdPciLutBigEndian)) {
-    State = SwapMmioRead32 ((UINTN)Pcie + PCI_LUT_BASE + PCI_LUT_DBG) &
-            LtssmMask;
+    return SwapMmioRead32 ((UINTN)Pcie + PCI_LUT_BASE + PCI_LUT_DBG) &
+           LtssmMask;
   } else {
-   State = MmioRead32 ((UINTN)Pcie + PCI_LUT_BASE + PCI_LUT_DBG) &
+    return MmioRead32 ((UINTN)Pcie + PCI_LUT_BASE + PCI_LUT_DBG) &
            LtssmMask;
   }
-
-  if (State < LTSSM_PCIE_L0) {
-    DEBUG ((DEBUG_INFO," Pcie Link error. LTSSM=0x%2x\n", State));
-    return EFI_SUCCESS;
-  }
-
-  return EFI_UNSUPPORTED;
 }
 
 /**
-   Helper function to check PCIe link state
+   Helper function to bring up the links of all enabled PCIe controllers
 
-   @param Pcie Address of PCIe host controller.
+   The LTSSM of all the controllers is polled together, for up to
+   PcdPcieLinkTrainTimeout us, so a slow link does not hold up the others.
+   The controllers which did not reach L0 but did detect a receiver are
+   then downgraded to Gen1 and polled again the same way. An empty slot
+   never leaves Detect and is not retried. The link capability of a
+   controller which still has no link is restored.
+
+   @param LsPcie   Array of NUM_PCIE_CONTROLLER PCIe controllers.
+   @param Enabled  Per controller, TRUE if the controller is to be trained.
+   @param LinkUp   Per controller, set to TRUE if the link came up.
 
 **/
 STATIC
-INTN
-PcieLinkUp (
-  IN EFI_PHYSICAL_ADDRESS Pcie
+VOID
+PcieLinkUpAll (
+  IN  LS_PCIE  *LsPcie,
+  IN  BOOLEAN  *Enabled,
+  OUT BOOLEAN  *LinkUp
   )
 {
-  INTN State;
-  UINT32 Cap;
-
-  State = PcieLinkState (Pcie);
-  if (State) {
-    return State;
+  UINT32  Cap[NUM_PCIE_CONTROLLER];
+  BOOLEAN Gen1[NUM_PCIE_CONTROLLER];
+  BOOLEAN Polled[NUM_PCIE_CONTROLLER];
+  BOOLEAN Receiver[NUM_PCIE_CONTROLLER];
+  UINTN   Idx;
+  UINTN   Pending;
+  UINTN   Pass;
+  UINT32  Timeout;
+  UINT32  State;
+  UINT64  Start;
+  UINT64  PassStart;
+  UINT64  Now;
+  UINTN   Pcie;
+
+  Timeout = PcdGet32 (PcdPcieLinkTrainTimeout);
+  Pending = 0;
+  for (Idx = 0; Idx < NUM_PCIE_CONTROLLER; Idx++) {
+    LinkUp[Idx] = FALSE;
+    Gen1[Idx] = FALSE;
+    Polled[Idx] = Enabled[Idx];
+    Receiver[Idx] = FALSE;
+    if (Enabled[Idx]) {
+      Pending++;
+    }
   }
 
-  //
-  // Try to download speed to gen1
-  //
-  Cap = MmioRead32 ((UINTN)Pcie + PCI_LINK_CAP);
-  MmioWrite32 ((UINTN)Pcie + PCI_LINK_CAP, (UINT32)(Cap & (~PCI_LINK_SPEED_MASK)) | BIT0);
-  State = PcieLinkState (Pcie);
-  if (State) {
-    return State;
+  Start = GetPerformanceCounter ();
+  for (Pass = 0; Pass < 2 && Pending != 0; Pass++) {
+    if (Pass != 0) {
+      //
+      // Try to download speed to gen1 on the controllers still down,
+      // unless there is nothing in the slot
+      //
+      for (Idx = 0; Idx < NUM_PCIE_CONTROLLER; Idx++) {
+        if (Polled[Idx] && !LinkUp[Idx] && !Receiver[Idx]) {
+          Polled[Idx] = FALSE;
+          Pending--;
+        }
+        if (Polled[Idx] && !LinkUp[Idx]) {
+          Pcie = LsPcie[Idx].ControllerAddress;
+          Cap[Idx] = MmioRead32 (Pcie + PCI_LINK_CAP);
+          MmioWrite32 (Pcie + PCI_LINK_CAP,
+            (Cap[Idx] & (~PCI_LINK_SPEED_MASK)) | BIT0);
+          Gen1[Idx] = TRUE;
+        }
+      }
+    }
+
+    PassStart = GetPerformanceCounter ();
+    for (;;) {
+      for (Idx = 0; Idx < NUM_PCIE_CONTROLLER; Idx++) {
+        if (!Polled[Idx] || LinkUp[Idx]) {
+          continue;
+        }
+
+        State = PcieLinkState (LsPcie[Idx].ControllerAddress);
+        if (State > LTSSM_PCIE_DETECT_ACTIVE) {
+          Receiver[Idx] = TRUE;
+        }
+        if (State >= LTSSM_PCIE_L0) {
+          LinkUp[Idx] = TRUE;
+          Pending--;
+          DEBUG ((DEBUG_INFO, "PCIE%d link up%a after %Lu us\n", Idx + BIT0,
+            Gen1[Idx] ? " at Gen1" : "",
+            GetMicroSecondDifference (Start, GetPerformanceCounter ())));
+        }
+      }
+
+      Now = GetPerformanceCounter ();
+      if (Pending == 0 ||
+          GetMicroSecondDifference (PassStart, Now) >= Timeout) {
+        break;
+      }
+      MicroSecondDelay (PCIE_LINK_POLL_INTERVAL);
+    }
   }
 
-  MmioWrite32 ((UINTN)Pcie + PCI_LINK_CAP, Cap);
+  for (Idx = 0; Idx < NUM_PCIE_CONTROLLER; Idx++) {
+    if (!Enabled[Idx] || LinkUp[Idx]) {
+      continue;
+    }
 
-  return EFI_SUCCESS;
+    Pcie = LsPcie[Idx].ControllerAddress;
+    DEBUG ((DEBUG_INFO, "PCIE%d Pcie Link error. LTSSM=0x%2x after %Lu us\n",
+      Idx + BIT0, PcieLinkState (Pcie),
+      GetMicroSecondDifference (Start, GetPerformanceCounter ())));
+    if (Gen1[Idx]) {
+      MmioWrite32 (Pcie + PCI_LINK_CAP, Cap[Idx]);
+    }
+  }
 }
 
 /**
@@ -1399,7 +1475,8 @@ PciHostBridgeGetRootBridges (
   )
 {
   UINTN         Idx;
-  INTN          LinkUp;
+  BOOLEAN       Enabled[NUM_PCIE_CONTROLLER];
+  BOOLEAN       LinkUp[NUM_PCIE_CONTROLLER];
   UINT64        PciPhyMemAddr;
   UINT64        PciPhyMem64Addr;
   UINT64        PciPhyCfg0Addr;
@@ -1428,11 +1505,6 @@ PciHostBridgeGetRootBridges (
   }
 
   for (Idx = 0; Idx < NUM_PCIE_CONTROLLER; Idx++) {
-    PciPhyMemAddr = PCI_SEG0_PHY_MEM_BASE + (PCI_BASE_DIFF * Idx);
-    PciPhyMem64Addr = PCI_SEG0_PHY_MEM64_BASE + (PCI_BASE_DIFF * Idx);
-    PciPhyCfg0Addr = PCI_SEG0_PHY_CFG0_BASE + (PCI_BASE_DIFF * Idx);
-    PciPhyCfg1Addr = PCI_SEG0_PHY_CFG1_BASE + (PCI_BASE_DIFF * Idx);
-    PciPhyIoAddr  =  PCI_SEG0_PHY_IO_BASE + (PCI_BASE_DIFF * Idx);
     Regs =  PCI_SEG0_DBI_BASE + (PCI_DBI_SIZE_DIFF * Idx);
 
     // Filling local array for
@@ -1447,7 +1519,8 @@ PciHostBridgeGetRootBridges (
     //
     // Verify PCIe controller is enabled in Soc Serdes Map
     //
-    if (!IsPcieNumEnabled (Idx)) {
+    Enabled[Idx] = IsPcieNumEnabled (Idx);
+    if (!Enabled[Idx]) {
       DEBUG ((DEBUG_ERROR, "PCIE%d is disabled\n", (Idx + BIT0)));
 
       if (Dtb != NULL) {
@@ -1472,11 +1545,26 @@ PciHostBridgeGetRootBridges (
       }
     }
 
-    //
-    // Verify PCIe controller LTSSM state
-    //
-    LinkUp = PcieLinkUp(Regs);
-    if (!LinkUp) {
+  }
+
+  //
+  // Verify PCIe controllers LTSSM state, all of them at once
+  //
+  PcieLinkUpAll (LsPcie, Enabled, LinkUp);
+
+  for (Idx = 0; Idx < NUM_PCIE_CONTROLLER; Idx++) {
+    if (!Enabled[Idx]) {
+      continue;
+    }
+
+    PciPhyMemAddr = PCI_SEG0_PHY_MEM_BASE + (PCI_BASE_DIFF * Idx);
+    PciPhyMem64Addr = PCI_SEG0_PHY_MEM64_BASE + (PCI_BASE_DIFF * Idx);
+    PciPhyCfg0Addr = PCI_SEG0_PHY_CFG0_BASE + (PCI_BASE_DIFF * Idx);
+    PciPhyCfg1Addr = PCI_SEG0_PHY_CFG1_BASE + (PCI_BASE_DIFF * Idx);
+    PciPhyIoAddr  =  PCI_SEG0_PHY_IO_BASE + (PCI_BASE_DIFF * Idx);
+    Regs =  PCI_SEG0_DBI_BASE + (PCI_DBI_SIZE_DIFF * Idx);
+
+    if (!LinkUp[Idx]) {
       //
       // Let the user know there's no PCIe link
       //
@@ -37,6 +37,82 @@ typedef enum {
 static BOOLEAN PciLsGen4Ctrl;
 static BOOLEAN CfgShiftEnable;
 
+//
+// Per controller shadow of the LsGen4 state programmed for config accesses:
+// the PAB_CTRL page select, the outbound window 0 target and whether the
+// Bus Master enable of the RC has already been checked.
+//
+// Every copy of this library, and PciHostBridgeLib, programs the same
+// registers, so the shadow is checked against the hardware before it is
+// trusted: each call path re-reads PAB_CTRL and drops the Bus Master check,
+// and a cached window target is confirmed by reading PAB_AXI_AMAP_PEX_WIN_L
+// back. The window is then only reprogrammed when the target changes or
+// another writer moved it.
+//
+typedef struct {
+  BOOLEAN PageValid;
+  UINT8   Page;
+  BOOLEAN TargetValid;
+  UINT32  Target;
+  BOOLEAN BusMasterSet;
+} PCI_LS_GEN4_CFG_CACHE;
+
+STATIC PCI_LS_GEN4_CFG_CACHE mPciLsGen4CfgCache[NUM_PCIE_CONTROLLER];
+
+/**
+  Function to get the cached config access state of a LsGen4 controller
+
+  @param[in]  Dbi    GPEX host controller address.
+
+  @return Pointer to the cache entry, NULL if Dbi is not a known controller.
+
+**/
+STATIC
+PCI_LS_GEN4_CFG_CACHE *
+PciLsGen4GetCache (
+  IN EFI_PHYSICAL_ADDRESS Dbi
+  )
+{
+  UINTN Idx;
+
+  if (Dbi < PCI_SEG0_DBI_BASE) {
+    return NULL;
+  }
+
+  Idx = (UINTN)(Dbi - PCI_SEG0_DBI_BASE) / PCI_DBI_SIZE_DIFF;
+  if (Idx >= NUM_PCIE_CONTROLLER) {
+    return NULL;
+  }
+
+  return &mPciLsGen4CfgCache[Idx];
+}
+
+/**
+  Function to resynchronize the cached config access state of a LsGen4
+  controller with the hardware, at the start of a call path. Another image
+  may have changed the page select or the command register since the last
+  call. The window target is checked by PcieCfgSetTarget instead.
+
+  @param[in]  Dbi    GPEX host controller address.
+
+**/
+STATIC
+VOID
+PciLsGen4SyncCache (
+  IN EFI_PHYSICAL_ADDRESS Dbi
+  )
+{
+  PCI_LS_GEN4_CFG_CACHE *Cache;
+
+  Cache = PciLsGen4GetCache (Dbi);
+  if (Cache != NULL) {
+    Cache->Page = (MmioRead32 ((UINTN)Dbi + PAB_CTRL) >> PAB_CTRL_PAGE_SEL_SHIFT) &
+                  PAB_CTRL_PAGE_SEL_MASK;
+    Cache->PageValid = TRUE;
+    Cache->BusMasterSet = FALSE;
+  }
+}
+
 /**
   Function to select page among the 48 1KB pages for
   AXI access
@@ -52,7 +128,15 @@ CcsrSetPg (
   IN UINT8 PgIdx
   )
 {
-  UINTN Val;
+  UINTN                 Val;
+  PCI_LS_GEN4_CFG_CACHE *Cache;
+
+  PgIdx &= PAB_CTRL_PAGE_SEL_MASK;
+  Cache = PciLsGen4GetCache (Dbi);
+  if (Cache != NULL && Cache->PageValid && Cache->Page == PgIdx) {
+    return;
+  }
+
   Val = MmioRead32 ((UINTN)Dbi + PAB_CTRL);
   // Bit 18:13 of Bridge Control Register(PAB) denotes page select
   // Mask is 6 bits and shift is 13 to select page
@@ -60,6 +144,11 @@ CcsrSetPg (
   Val |= (PgIdx & PAB_CTRL_PAGE_SEL_MASK) << PAB_CTRL_PAGE_SEL_SHIFT;
 
   MmioWrite32 ((UINTN)Dbi + PAB_CTRL, Val);
+
+  if (Cache != NULL) {
+    Cache->Page = PgIdx;
+    Cache->PageValid = TRUE;
+  }
 }
 
 STATIC
@@ -102,13 +191,23 @@ PciLsGen4SetBusMaster (
   IN EFI_PHYSICAL_ADDRESS Dbi
   )
 {
-  UINT32 Val;
+  UINT32                Val;
+  PCI_LS_GEN4_CFG_CACHE *Cache;
+
+  Cache = PciLsGen4GetCache (Dbi);
+  if (Cache != NULL && Cache->BusMasterSet) {
+    return;
+  }
 
   /* Make sure the Master Enable bit not cleared */
   Val = CcsrRead32 ((UINTN)Dbi, PCI_COMMAND_OFFSET);
   if (!(Val & EFI_PCI_COMMAND_BUS_MASTER)) {
     CcsrWrite32 ((UINTN)Dbi, PCI_COMMAND_OFFSET, Val | EFI_PCI_COMMAND_BUS_MASTER);
   }
+
+  if (Cache != NULL) {
+    Cache->BusMasterSet = TRUE;
+  }
 }
 
 STATIC
@@ -117,8 +216,21 @@ PcieCfgSetTarget (
   IN EFI_PHYSICAL_ADDRESS Dbi,
   IN UINT32 Target)
 {
+    PCI_LS_GEN4_CFG_CACHE *Cache;
+
+    Cache = PciLsGen4GetCache (Dbi);
+    if (Cache != NULL && Cache->TargetValid && Cache->Target == Target &&
+        (UINT32)CcsrRead32 ((UINTN)Dbi, PAB_AXI_AMAP_PEX_WIN_L(0)) == Target) {
+      return;
+    }
+
     CcsrWrite32 ((UINTN)Dbi, PAB_AXI_AMAP_PEX_WIN_L(0), Target);
     CcsrWrite32 ((UINTN)Dbi, PAB_AXI_AMAP_PEX_WIN_H(0), 0);
+
+    if (Cache != NULL) {
+      Cache->Target = Target;
+      Cache->TargetValid = TRUE;
+    }
 }
 
 STATIC
@@ -132,6 +244,8 @@ PciLsGen4GetConfigBase (
 {
   UINT32 Target;
 
+  PciLsGen4SyncCache (PCI_SEG0_DBI_BASE + PCI_DBI_SIZE_DIFF * Segment);
+
   if (Bus) {
     PciLsGen4SetBusMaster (PCI_SEG0_DBI_BASE + PCI_DBI_SIZE_DIFF* Segment);
 
@@ -550,6 +664,67 @@ PciSegmentWrite32 (
   return PciSegmentLibWriteWorker (Address, PciCfgWidthUint32, Value);
 }
 
+/**
+  Reads a range of LsGen4 config space behind the RC into a buffer.
+
+  The outbound window target only depends on Bus, Device and Function, so it
+  is programmed once and the whole range is then read straight from the
+  window instead of going through PciSegmentLibGetConfigBase for every access.
+
+  @param  StartAddress  The starting address that encodes the PCI Segment, Bus,
+                        Device, Function and Register.
+  @param  Size          The size in bytes of the transfer.
+  @param  Buffer        The pointer to a buffer receiving the data read.
+
+**/
+STATIC
+VOID
+PciLsGen4ReadBuffer (
+  IN  UINT64                   StartAddress,
+  IN  UINTN                    Size,
+  OUT VOID                     *Buffer
+  )
+{
+  UINT64    Base;
+  UINT16    Segment;
+
+  Segment = (StartAddress >> 32);
+  Base = PciSegmentLibGetConfigBase (StartAddress, Segment,
+           (UINT16)(StartAddress & 0xfff));
+
+  if ((Base & BIT0) != 0) {
+    *(volatile UINT8 *)Buffer = MmioRead8 (Base);
+    Base += sizeof (UINT8);
+    Size -= sizeof (UINT8);
+    Buffer = (UINT8*)Buffer + BIT0;
+  }
+
+  if (Size >= sizeof (UINT16) && (Base & BIT1) != 0) {
+    WriteUnaligned16 (Buffer, MmioRead16 (Base));
+    Base += sizeof (UINT16);
+    Size -= sizeof (UINT16);
+    Buffer = (UINT16*)Buffer + BIT0;
+  }
+
+  while (Size >= sizeof (UINT32)) {
+    WriteUnaligned32 (Buffer, MmioRead32 (Base));
+    Base += sizeof (UINT32);
+    Size -= sizeof (UINT32);
+    Buffer = (UINT32*)Buffer + BIT0;
+  }
+
+  if (Size >= sizeof (UINT16)) {
+    WriteUnaligned16 (Buffer, MmioRead16 (Base));
+    Base += sizeof (UINT16);
+    Size -= sizeof (UINT16);
+    Buffer = (UINT16*)Buffer + BIT0;
+  }
+
+  if (Size >= sizeof (UINT8)) {
+    *(volatile UINT8 *)Buffer = MmioRead8 (Base);
+  }
+}
+
 /**
   Reads a range of PCI configuration registers into a caller supplied buffer.
 
@@ -595,6 +770,17 @@ PciSegmentReadBuffer (
   //
   ReturnValue = Size;
 
+  //
+  // Behind a LsGen4 RC all of the function's config space is reachable
+  // through the same outbound window target. Devices > 0 on bus 1 are left
+  // to the generic path which reports them as absent.
+  //
+  if (PciLsGen4Ctrl && (StartAddress & 0xff00000) != 0 &&
+      ((StartAddress & 0xfe00000) != 0 || (StartAddress & 0xf8000) == 0)) {
+    PciLsGen4ReadBuffer (StartAddress, Size, Buffer);
+    return ReturnValue;
+  }
+
   if ((StartAddress & BIT0) != 0) {
     //
     // Read a byte if StartAddress is byte aligned
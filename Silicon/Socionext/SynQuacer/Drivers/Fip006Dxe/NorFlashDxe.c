@@ -121,10 +121,12 @@ GenCSDC (
   IN  BOOLEAN   AddrMode4Byte,
   IN  BOOLEAN   HighZ,
   IN  UINT8     TransferMode,
+  IN  BOOLEAN   Continuous,
   OUT UINT16    *CmdSeq
   )
 {
   UINTN         Index;
+  UINT8         Cont;
 
   if (!CmdSeq) {
     return EFI_INVALID_PARAMETER;
@@ -133,23 +135,23 @@ GenCSDC (
   Index = 0;
   CopyMem (CmdSeq, mFip006NullCmdSeq, sizeof (mFip006NullCmdSeq));
 
-  CmdSeq[Index++] = CSDC (Cmd, CSDC_CONT_NON_CONTINUOUS, TransferMode,
-                          CSDC_DEC_LEAVE_ASIS);
+  Cont = Continuous ? CSDC_CONT_CONTINUOUS : CSDC_CONT_NON_CONTINUOUS;
+
+  CmdSeq[Index++] = CSDC (Cmd, Cont, TransferMode, CSDC_DEC_LEAVE_ASIS);
   if (AddrAccess) {
     if (AddrMode4Byte) {
-      CmdSeq[Index++] = CSDC (CSDC_ADDRESS_31_24, CSDC_CONT_NON_CONTINUOUS,
-                              TransferMode, CSDC_DEC_DECODE);
+      CmdSeq[Index++] = CSDC (CSDC_ADDRESS_31_24, Cont, TransferMode,
+                              CSDC_DEC_DECODE);
     }
-    CmdSeq[Index++] = CSDC (CSDC_ADDRESS_23_16, CSDC_CONT_NON_CONTINUOUS,
-                            TransferMode, CSDC_DEC_DECODE);
-    CmdSeq[Index++] = CSDC (CSDC_ADDRESS_15_8, CSDC_CONT_NON_CONTINUOUS,
-                            TransferMode, CSDC_DEC_DECODE);
-    CmdSeq[Index++] = CSDC (CSDC_ADDRESS_7_0, CSDC_CONT_NON_CONTINUOUS,
-                            TransferMode, CSDC_DEC_DECODE);
+    CmdSeq[Index++] = CSDC (CSDC_ADDRESS_23_16, Cont, TransferMode,
+                            CSDC_DEC_DECODE);
+    CmdSeq[Index++] = CSDC (CSDC_ADDRESS_15_8, Cont, TransferMode,
+                            CSDC_DEC_DECODE);
+    CmdSeq[Index++] = CSDC (CSDC_ADDRESS_7_0, Cont, TransferMode,
+                            CSDC_DEC_DECODE);
   }
   if (HighZ) {
-    CmdSeq[Index++] = CSDC (CSDC_HIGH_Z, CSDC_CONT_NON_CONTINUOUS,
-                            TransferMode, CSDC_DEC_DECODE);
+    CmdSeq[Index++] = CSDC (CSDC_HIGH_Z, Cont, TransferMode, CSDC_DEC_DECODE);
   }
 
   return EFI_SUCCESS;
@@ -157,9 +159,10 @@ GenCSDC (
 
 STATIC
 EFI_STATUS
-NorFlashSetHostCommand (
+NorFlashSetHostCommandMode (
   IN  NOR_FLASH_INSTANCE    *Instance,
-  IN  UINT8                 Code
+  IN  UINT8                 Code,
+  IN  BOOLEAN               Continuous
   )
 {
   CONST CSDC_DEFINITION     *Cmd;
@@ -175,12 +178,23 @@ NorFlashSetHostCommand (
       Cmd->AddrMode4Byte,
       Cmd->HighZ,
       Cmd->CsdcTrp,
+      Continuous,
       CSDC
       );
   NorFlashSetHostCSDC (Instance, Cmd->ReadWrite, CSDC);
   return EFI_SUCCESS;
 }
 
+STATIC
+EFI_STATUS
+NorFlashSetHostCommand (
+  IN  NOR_FLASH_INSTANCE    *Instance,
+  IN  UINT8                 Code
+  )
+{
+  return NorFlashSetHostCommandMode (Instance, Code, FALSE);
+}
+
 STATIC
 UINT8
 NorFlashReadStatusRegister (
@@ -433,6 +447,132 @@ NorFlashWriteSingleWord (
   return Status;
 }
 
+/**
+  Program up to one page with a single Page Program command.
+
+  The write command sequence is set up in continuous mode, so the consecutive
+  words stored to the direct mode window are sent as the data phase of one PP
+  transaction instead of as one PP transaction each. The page is read back
+  afterwards and any word that did not make it is programmed on its own.
+
+  @param[in]  Instance      The NOR flash instance.
+  @param[in]  WordAddress   Word aligned address in the direct mode window.
+  @param[in]  Buffer        Data to program, no alignment requirement.
+  @param[in]  Words         Number of words to program, not crossing a page.
+
+**/
+STATIC
+EFI_STATUS
+NorFlashWritePage (
+  IN NOR_FLASH_INSTANCE     *Instance,
+  IN UINTN                  WordAddress,
+  IN CONST UINT8            *Buffer,
+  IN UINTN                  Words
+  )
+{
+  UINTN                 Index;
+  UINT32                Data;
+
+  DEBUG ((DEBUG_BLKIO,
+    "NorFlashWritePage(WordAddress=0x%08x, Words=0x%x)\n",
+    WordAddress, Words));
+
+  if (EFI_ERROR (NorFlashEnableWrite (Instance))) {
+    return EFI_DEVICE_ERROR;
+  }
+  NorFlashSetHostCommandMode (Instance, SPINOR_OP_PP, TRUE);
+  for (Index = 0; Index < Words; Index++) {
+    MmioWrite32 (WordAddress + Index * sizeof (UINT32),
+                 ReadUnaligned32 ((UINT32 *)(Buffer + Index * sizeof (UINT32))));
+  }
+  MemoryFence ();
+  NorFlashWaitProgramErase (Instance);
+
+  NorFlashDisableWrite (Instance);
+  NorFlashSetHostCSDC (Instance, TRUE, mFip006NullCmdSeq);
+
+  for (Index = 0; Index < Words; Index++) {
+    Data = ReadUnaligned32 ((UINT32 *)(Buffer + Index * sizeof (UINT32)));
+    if (MmioRead32 (WordAddress + Index * sizeof (UINT32)) == Data) {
+      continue;
+    }
+    NorFlashWriteSingleWord (Instance, WordAddress + Index * sizeof (UINT32),
+      Data);
+    if (MmioRead32 (WordAddress + Index * sizeof (UINT32)) != Data) {
+      return EFI_DEVICE_ERROR;
+    }
+  }
+  return EFI_SUCCESS;
+}
+
+/**
+  Check whether programming Buffer over the flash contents at Address needs
+  an erase first, i.e. whether any bit has to go from 0 to 1.
+
+**/
+STATIC
+BOOLEAN
+NorFlashNeedsErase (
+  IN UINTN                  Address,
+  IN CONST UINT8            *Buffer,
+  IN UINTN                  Size
+  )
+{
+  UINTN                 Index;
+  UINT32                Data;
+
+  for (Index = 0; Index < Size; Index += sizeof (UINT32)) {
+    Data = ReadUnaligned32 ((UINT32 *)(Buffer + Index));
+    if ((MmioRead32 (Address + Index) & Data) != Data) {
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/**
+  Program a word aligned range of an erased or bit clearing region, one page
+  at a time. Pages whose contents already match are skipped, which includes
+  all-ones pages right after an erase.
+
+**/
+STATIC
+EFI_STATUS
+NorFlashProgramRange (
+  IN NOR_FLASH_INSTANCE     *Instance,
+  IN UINTN                  Address,
+  IN CONST UINT8            *Buffer,
+  IN UINTN                  Size
+  )
+{
+  EFI_STATUS            Status;
+  UINTN                 Chunk;
+
+  ASSERT ((Address % sizeof (UINT32)) == 0);
+  ASSERT ((Size % sizeof (UINT32)) == 0);
+
+  // Put the device into Read Array mode for the comparisons
+  NorFlashSetHostCommand (Instance, SPINOR_OP_READ_4B);
+  NorFlashSetHostCSDC (Instance, TRUE, mFip006NullCmdSeq);
+
+  while (Size > 0) {
+    Chunk = MIN (Size, Instance->PageSize - (Address % Instance->PageSize));
+    if (CompareMem ((VOID *)Address, Buffer, Chunk) != 0) {
+      Status = NorFlashWritePage (Instance, Address, Buffer,
+                 Chunk / sizeof (UINT32));
+      if (EFI_ERROR (Status)) {
+        DEBUG ((DEBUG_ERROR,
+          "NorFlashProgramRange: page program failed at 0x%08x\n", Address));
+        return Status;
+      }
+    }
+    Address += Chunk;
+    Buffer += Chunk;
+    Size -= Chunk;
+  }
+  return EFI_SUCCESS;
+}
+
 STATIC
 EFI_STATUS
 NorFlashWriteFullBlock (
@@ -443,8 +583,6 @@ NorFlashWriteFullBlock (
   )
 {
   EFI_STATUS    Status;
-  UINTN         WordAddress;
-  UINT32        WordIndex;
   UINTN         BlockAddress;
   EFI_TPL       OriginalTPL;
   BOOLEAN       InterruptsEnabled;
@@ -457,9 +595,6 @@ NorFlashWriteFullBlock (
   BlockAddress = GET_NOR_BLOCK_ADDRESS (Instance->RegionBaseAddress, Lba,
                    BlockSizeInWords * 4);
 
-  // Start writing from the first address at the start of the block
-  WordAddress = BlockAddress;
-
   if (!EfiAtRuntime ()) {
     // Raise TPL to TPL_HIGH to stop anyone from interrupting us.
     OriginalTPL = gBS->RaiseTPL (TPL_HIGH_LEVEL);
@@ -467,23 +602,30 @@ NorFlashWriteFullBlock (
     InterruptsEnabled = SaveAndDisableInterrupts ();
   }
 
-  Status = NorFlashUnlockAndEraseSingleBlock (Instance, BlockAddress);
-  if (EFI_ERROR (Status)) {
-    DEBUG ((DEBUG_ERROR,
-      "WriteSingleBlock: ERROR - Failed to Unlock and Erase the single block at 0x%X\n",
-      BlockAddress));
-    goto EXIT;
-  }
+  // Put the device into Read Array mode for the comparison
+  NorFlashSetHostCommand (Instance, SPINOR_OP_READ_4B);
+  NorFlashSetHostCSDC (Instance, TRUE, mFip006NullCmdSeq);
 
-  for (WordIndex=0;
-       WordIndex < BlockSizeInWords;
-       WordIndex++, DataBuffer++, WordAddress += 4) {
-    Status = NorFlashWriteSingleWord (Instance, WordAddress, *DataBuffer);
+  // Only erase if some bit has to go from 0 to 1
+  if (NorFlashNeedsErase (BlockAddress, (UINT8 *)DataBuffer,
+        BlockSizeInWords * 4)) {
+    Status = NorFlashUnlockAndEraseSingleBlock (Instance, BlockAddress);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_ERROR,
+        "WriteSingleBlock: ERROR - Failed to Unlock and Erase the single block at 0x%X\n",
+        BlockAddress));
+      goto EXIT;
+    }
+  } else {
+    Status = NorFlashUnlockSingleBlockIfNecessary (Instance, BlockAddress);
     if (EFI_ERROR (Status)) {
       goto EXIT;
     }
   }
 
+  Status = NorFlashProgramRange (Instance, BlockAddress, (UINT8 *)DataBuffer,
+             BlockSizeInWords * 4);
+
 EXIT:
   if (!EfiAtRuntime ()) {
     // Interruptions can resume.
@@ -495,7 +637,7 @@ EXIT:
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR,
       "NOR FLASH Programming [WriteSingleBlock] failed at address 0x%08x. Exit Status = \"%r\".\n",
-      WordAddress, Status));
+      BlockAddress, Status));
   }
   return Status;
 }
@@ -689,19 +831,10 @@ NorFlashWriteSingleBlock (
   )
 {
   EFI_STATUS  TempStatus;
-  UINT32      Tmp;
-  UINT32      TmpBuf;
-  UINT32      WordToWrite;
-  UINT32      Mask;
-  BOOLEAN     DoErase;
-  UINTN       BytesToWrite;
-  UINTN       CurOffset;
-  UINTN       WordAddr;
+  UINTN       Start;
+  UINTN       End;
   UINTN       BlockSize;
   UINTN       BlockAddress;
-  UINTN       PrevBlockAddress;
-
-  PrevBlockAddress = 0;
 
   if (!Instance->Initialized && Instance->Initialize) {
     Instance->Initialize(Instance);
@@ -742,136 +875,45 @@ NorFlashWriteSingleBlock (
     return EFI_BAD_BUFFER_SIZE;
   }
 
-  // Pick 128bytes as a good start for word operations as opposed to erasing the
-  // block and writing the data regardless if an erase is really needed.
-  // It looks like most individual NV variable writes are smaller than 128bytes.
-  if (*NumBytes <= 128) {
-    // Check to see if we need to erase before programming the data into NOR.
-    // If the destination bits are only changing from 1s to 0s we can just write.
-    // After a block is erased all bits in the block is set to 1.
-    // If any byte requires us to erase we just give up and rewrite all of it.
-    DoErase      = FALSE;
-    BytesToWrite = *NumBytes;
-    CurOffset    = Offset;
-
-    while (BytesToWrite > 0) {
-      // Read full word from NOR, splice as required. A word is the smallest
-      // unit we can write.
-      TempStatus = NorFlashRead (Instance, Lba, CurOffset & ~(0x3), sizeof(Tmp),
-                     &Tmp);
-      if (EFI_ERROR (TempStatus)) {
-        return EFI_DEVICE_ERROR;
-      }
+  // Check we did get some memory. Buffer is BlockSize.
+  if (Instance->ShadowBuffer == NULL) {
+    DEBUG ((DEBUG_ERROR, "FvbWrite: ERROR - Buffer not ready\n"));
+    return EFI_DEVICE_ERROR;
+  }
 
-      // Physical address of word in NOR to write.
-      WordAddr = (CurOffset & ~(0x3)) +
-                 GET_NOR_BLOCK_ADDRESS (Instance->RegionBaseAddress, Lba,
+  // Check to see if we need to erase before programming the data into NOR.
+  // If the destination bits are only changing from 1s to 0s we can just
+  // program the word aligned span covering the update, page by page.
+  // After a block is erased all bits in the block is set to 1.
+  Start = Offset & ~(sizeof (UINT32) - 1);
+  End = ALIGN_VALUE (Offset + *NumBytes, sizeof (UINT32));
+  BlockAddress = GET_NOR_BLOCK_ADDRESS (Instance->RegionBaseAddress, Lba,
                    BlockSize);
 
-      // The word of data that is to be written.
-      TmpBuf = *((UINT32*)(Buffer + (*NumBytes - BytesToWrite)));
-
-      // First do word aligned chunks.
-      if ((CurOffset & 0x3) == 0) {
-        if (BytesToWrite >= 4) {
-          // Is the destination still in 'erased' state?
-          if (~Tmp != 0) {
-            // Check to see if we are only changing bits to zero.
-            if ((Tmp ^ TmpBuf) & TmpBuf) {
-              DoErase = TRUE;
-              break;
-            }
-          }
-          // Write this word to NOR
-          WordToWrite = TmpBuf;
-          CurOffset += sizeof(TmpBuf);
-          BytesToWrite -= sizeof(TmpBuf);
-        } else {
-          // BytesToWrite < 4. Do small writes and left-overs
-          Mask = ~((~0) << (BytesToWrite * 8));
-          // Mask out the bytes we want.
-          TmpBuf &= Mask;
-          // Is the destination still in 'erased' state?
-          if ((Tmp & Mask) != Mask) {
-            // Check to see if we are only changing bits to zero.
-            if ((Tmp ^ TmpBuf) & TmpBuf) {
-              DoErase = TRUE;
-              break;
-            }
-          }
-          // Merge old and new data. Write merged word to NOR
-          WordToWrite = (Tmp & ~Mask) | TmpBuf;
-          CurOffset += BytesToWrite;
-          BytesToWrite = 0;
-        }
-      } else {
-        // Do multiple words, but starting unaligned.
-        if (BytesToWrite > (4 - (CurOffset & 0x3))) {
-          Mask = ((~0) << ((CurOffset & 0x3) * 8));
-          // Mask out the bytes we want.
-          TmpBuf &= Mask;
-          // Is the destination still in 'erased' state?
-          if ((Tmp & Mask) != Mask) {
-            // Check to see if we are only changing bits to zero.
-            if ((Tmp ^ TmpBuf) & TmpBuf) {
-              DoErase = TRUE;
-              break;
-            }
-          }
-          // Merge old and new data. Write merged word to NOR
-          WordToWrite = (Tmp & ~Mask) | TmpBuf;
-          BytesToWrite -= (4 - (CurOffset & 0x3));
-          CurOffset += (4 - (CurOffset & 0x3));
-        } else {
-          // Unaligned and fits in one word.
-          Mask = (~((~0) << (BytesToWrite * 8))) << ((CurOffset & 0x3) * 8);
-          // Mask out the bytes we want.
-          TmpBuf = (TmpBuf << ((CurOffset & 0x3) * 8)) & Mask;
-          // Is the destination still in 'erased' state?
-          if ((Tmp & Mask) != Mask) {
-            // Check to see if we are only changing bits to zero.
-            if ((Tmp ^ TmpBuf) & TmpBuf) {
-              DoErase = TRUE;
-              break;
-            }
-          }
-          // Merge old and new data. Write merged word to NOR
-          WordToWrite = (Tmp & ~Mask) | TmpBuf;
-          CurOffset += BytesToWrite;
-          BytesToWrite = 0;
-        }
-      }
+  // Splice the data into the current contents of that span. The span is
+  // programmed before returning even if it only covers part of a page:
+  // FvbWrite callers (variable services, fault tolerant write) rely on the
+  // data being on the flash when the call returns, also at runtime where
+  // there is no later point to flush a page held back for the next write.
+  TempStatus = NorFlashRead (Instance, Lba, Start, End - Start,
+                 (UINT8 *)Instance->ShadowBuffer + Start);
+  if (EFI_ERROR (TempStatus)) {
+    return EFI_DEVICE_ERROR;
+  }
+  CopyMem ((UINT8 *)Instance->ShadowBuffer + Offset, Buffer, *NumBytes);
 
-      //
-      // Write the word to NOR.
-      //
-
-      BlockAddress = GET_NOR_BLOCK_ADDRESS (Instance->RegionBaseAddress, Lba,
-        BlockSize);
-      if (BlockAddress != PrevBlockAddress) {
-        TempStatus = NorFlashUnlockSingleBlockIfNecessary (Instance,
-                       BlockAddress);
-        if (EFI_ERROR (TempStatus)) {
-          return EFI_DEVICE_ERROR;
-        }
-        PrevBlockAddress = BlockAddress;
-      }
-      TempStatus = NorFlashWriteSingleWord (Instance, WordAddr, WordToWrite);
-      if (EFI_ERROR (TempStatus)) {
-        return EFI_DEVICE_ERROR;
-      }
+  if (!NorFlashNeedsErase (BlockAddress + Start,
+         (UINT8 *)Instance->ShadowBuffer + Start, End - Start)) {
+    TempStatus = NorFlashUnlockSingleBlockIfNecessary (Instance, BlockAddress);
+    if (EFI_ERROR (TempStatus)) {
+      return EFI_DEVICE_ERROR;
     }
-    // Exit if we got here and could write all the data. Otherwise do the
-    // Erase-Write cycle.
-    if (!DoErase) {
-      return EFI_SUCCESS;
+    TempStatus = NorFlashProgramRange (Instance, BlockAddress + Start,
+                   (UINT8 *)Instance->ShadowBuffer + Start, End - Start);
+    if (EFI_ERROR (TempStatus)) {
+      return EFI_DEVICE_ERROR;
     }
-  }
-
-  // Check we did get some memory. Buffer is BlockSize.
-  if (Instance->ShadowBuffer == NULL) {
-    DEBUG ((DEBUG_ERROR, "FvbWrite: ERROR - Buffer not ready\n"));
-    return EFI_DEVICE_ERROR;
+    return EFI_SUCCESS;
   }
 
   // Read NOR Flash data into shadow buffer
@@ -1108,7 +1150,8 @@ STATIC CONST NOR_FLASH_INSTANCE mNorFlashInstanceTemplate = {
 
   NULL, // CmdTable
   0, // CmdTableSize
-  0 // Flags
+  0, // Flags
+  0 // PageSize ... NEED TO BE FILLED
 };
 
 STATIC
@@ -1170,6 +1213,11 @@ NorFlashCreateInstance (
     Instance->Flags = NOR_FLASH_POLL_FSR;
   }
 
+  Instance->PageSize = FlashInfo->PageSize;
+  if (Instance->PageSize == 0 || (BlockSize % Instance->PageSize) != 0) {
+    Instance->PageSize = 256;
+  }
+
   Instance->ShadowBuffer = AllocateRuntimePool (BlockSize);;
   if (Instance->ShadowBuffer == NULL) {
     Status = EFI_OUT_OF_RESOURCES;
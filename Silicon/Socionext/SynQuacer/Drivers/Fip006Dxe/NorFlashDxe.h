@@ -116,6 +116,8 @@ struct _NOR_FLASH_INSTANCE {
 
   UINT32                              Flags;
 #define NOR_FLASH_POLL_FSR      BIT0
+
+  UINT32                              PageSize;
 };
 
 EFI_STATUS
@@ -121,6 +121,86 @@ Probe (
   return EFI_SUCCESS;
 }
 
+//
+// Reclaim all TX descriptors the hardware is done with, in one go. The
+// buffers of the corresponding packets are marked as released, and are
+// handed back to the caller by GetStatus ().
+//
+STATIC
+EFI_STATUS
+NetsecReclaimTxDescriptors (
+  IN  NETSEC_DRIVER       *LanDriver
+  )
+{
+  ogma_err_t    ogma_err;
+
+  ogma_clear_desc_ring_irq_status (LanDriver->Handle,
+                                   OGMA_DESC_RING_ID_NRM_TX,
+                                   OGMA_CH_IRQ_REG_EMPTY);
+
+  ogma_err = ogma_clean_tx_desc_ring (LanDriver->Handle,
+                                      OGMA_DESC_RING_ID_NRM_TX);
+  if (ogma_err != OGMA_ERR_OK) {
+    DEBUG ((DEBUG_ERROR,
+      "NETSEC: ogma_clean_tx_desc_ring failed with error code: %d\n",
+      (INT32)ogma_err));
+    return EFI_DEVICE_ERROR;
+  }
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+EFIAPI
+NetsecTxReclaimTimer (
+  IN EFI_EVENT  Event,
+  IN VOID       *Context
+  )
+{
+  NETSEC_DRIVER   *LanDriver;
+
+  LanDriver = Context;
+
+  if (LanDriver->SnpMode.State == EfiSimpleNetworkInitialized) {
+    NetsecReclaimTxDescriptors (LanDriver);
+  }
+}
+
+STATIC
+pfdep_pkt_handle_t
+NetsecGetTxHandle (
+  IN  NETSEC_DRIVER       *LanDriver
+  )
+{
+  pfdep_pkt_handle_t  pkt_handle;
+  LIST_ENTRY          *Link;
+
+  if (IsListEmpty (&LanDriver->TxHandleFreeList)) {
+    pkt_handle = AllocateZeroPool (sizeof (*pkt_handle));
+    if (pkt_handle == NULL) {
+      return NULL;
+    }
+  } else {
+    Link = GetFirstNode (&LanDriver->TxHandleFreeList);
+    RemoveEntryList (Link);
+    pkt_handle = BASE_CR (Link, PACKET_HANDLE, Link);
+    ZeroMem (pkt_handle, sizeof (*pkt_handle));
+  }
+
+  pkt_handle->RecycleForTx = TRUE;
+  return pkt_handle;
+}
+
+STATIC
+VOID
+NetsecPutTxHandle (
+  IN  NETSEC_DRIVER       *LanDriver,
+  IN  pfdep_pkt_handle_t  pkt_handle
+  )
+{
+  InsertHeadList (&LanDriver->TxHandleFreeList, &pkt_handle->Link);
+}
+
 /*
  *  UEFI Stop() function
  */
@@ -317,6 +397,23 @@ SnpInitialize (
     ReturnUnlock (EFI_DEVICE_ERROR);
   }
 
+  // Reclaim completed TX descriptors in the background
+  Status = gBS->CreateEvent (EVT_TIMER | EVT_NOTIFY_SIGNAL, TPL_CALLBACK,
+                  NetsecTxReclaimTimer, LanDriver, &LanDriver->TxReclaimEvent);
+  if (EFI_ERROR (Status)) {
+    DEBUG ((DEBUG_ERROR,
+      "NETSEC: failed to create TX reclaim event - %r\n", Status));
+    ReturnUnlock (Status);
+  }
+
+  Status = gBS->SetTimer (LanDriver->TxReclaimEvent, TimerPeriodic,
+                  TX_RECLAIM_PERIOD);
+  if (EFI_ERROR (Status)) {
+    gBS->CloseEvent (LanDriver->TxReclaimEvent);
+    LanDriver->TxReclaimEvent = NULL;
+    ReturnUnlock (Status);
+  }
+
   // Declare the driver as initialized
   Snp->Mode->State = EfiSimpleNetworkInitialized;
   Status = EFI_SUCCESS;
@@ -370,6 +467,9 @@ SnpShutdown (
   // Find the LanDriver structure
   LanDriver = INSTANCE_FROM_SNP_THIS (Snp);
 
+  gBS->CloseEvent (LanDriver->TxReclaimEvent);
+  LanDriver->TxReclaimEvent = NULL;
+
   ogma_stop_gmac (LanDriver->Handle, OGMA_TRUE, OGMA_TRUE);
 
   ogma_stop_desc_ring (LanDriver->Handle, OGMA_DESC_RING_ID_NRM_RX);
@@ -571,11 +671,23 @@ SnpGetStatus (
 
   Snp->Mode->MediaPresent = phy_link_status.up_flag;
 
-  ogma_err = ogma_clean_tx_desc_ring (LanDriver->Handle,
-                                      OGMA_DESC_RING_ID_NRM_TX);
+  if (IrqStat != 0) {
+    *IrqStat = 0;
+  }
 
   if (TxBuff != NULL) {
     *TxBuff = NULL;
+
+    //
+    // Only reclaim TX descriptors if the timer has not already released
+    // the oldest buffer that is still outstanding.
+    //
+    Link = GetFirstNode (&LanDriver->TxBufferList);
+    if (!IsNull (&LanDriver->TxBufferList, Link) &&
+        !BASE_CR (Link, PACKET_HANDLE, Link)->Released) {
+      NetsecReclaimTxDescriptors (LanDriver);
+    }
+
     //
     // Find a buffer in the list that has been released
     //
@@ -587,16 +699,15 @@ SnpGetStatus (
       if (pkt_handle->Released) {
         *TxBuff = pkt_handle->Buffer;
         RemoveEntryList (Link);
-        FreePool (pkt_handle);
+        NetsecPutTxHandle (LanDriver, pkt_handle);
+        if (IrqStat != NULL) {
+          *IrqStat |= EFI_SIMPLE_NETWORK_TRANSMIT_INTERRUPT;
+        }
         break;
       }
     }
   }
 
-  if (IrqStat != 0) {
-    *IrqStat = 0;
-  }
-
   Status = EFI_SUCCESS;
 
   // Restore TPL and return
@@ -639,14 +750,6 @@ SnpTransmit (
     return EFI_DEVICE_ERROR;
   }
 
-  pkt_handle = AllocateZeroPool (sizeof (*pkt_handle));
-  if (pkt_handle == NULL) {
-    return EFI_OUT_OF_RESOURCES;
-  }
-
-  pkt_handle->Buffer = BufAddr;
-  pkt_handle->RecycleForTx = TRUE;
-
   // Serialize access to data and registers
   SavedTpl = gBS->RaiseTPL (TPL_CALLBACK);
 
@@ -669,25 +772,6 @@ SnpTransmit (
   // Find the LanDriver structure
   LanDriver = INSTANCE_FROM_SNP_THIS (Snp);
 
-  ogma_err = ogma_clear_desc_ring_irq_status (LanDriver->Handle,
-                                              OGMA_DESC_RING_ID_NRM_TX,
-                                              OGMA_CH_IRQ_REG_EMPTY);
-  if (ogma_err != OGMA_ERR_OK) {
-    DEBUG ((DEBUG_ERROR,
-      "NETSEC: ogma_clear_desc_ring_irq_status failed with error code: %d\n",
-      (INT32)ogma_err));
-    ReturnUnlock (EFI_DEVICE_ERROR);
-  }
-
-  ogma_err = ogma_clean_tx_desc_ring (LanDriver->Handle,
-                                      OGMA_DESC_RING_ID_NRM_TX);
-  if (ogma_err != OGMA_ERR_OK) {
-    DEBUG ((DEBUG_ERROR,
-      "NETSEC: ogma_clean_tx_desc_ring failed with error code: %d\n",
-      (INT32)ogma_err));
-    ReturnUnlock (EFI_DEVICE_ERROR);
-  }
-
   // Ensure header is correct size if non-zero
   if (HdrSize) {
     if (HdrSize != Snp->Mode->MediaHeaderSize) {
@@ -713,9 +797,37 @@ SnpTransmit (
       sizeof (UINT16));
   }
 
+  //
+  // Completed descriptors are reclaimed in batches by the timer and by
+  // GetStatus (), so only do it here if the ring has run out of free slots.
+  // Don't wait for the hardware: let the caller retry instead.
+  //
+  tx_avail_num = ogma_get_tx_avail_num (LanDriver->Handle,
+                                        OGMA_DESC_RING_ID_NRM_TX);
+  if (tx_avail_num < SCAT_NUM) {
+    Status = NetsecReclaimTxDescriptors (LanDriver);
+    if (EFI_ERROR (Status)) {
+      goto ExitUnlock;
+    }
+
+    tx_avail_num = ogma_get_tx_avail_num (LanDriver->Handle,
+                                          OGMA_DESC_RING_ID_NRM_TX);
+    if (tx_avail_num < SCAT_NUM) {
+      ReturnUnlock (EFI_NOT_READY);
+    }
+  }
+
+  pkt_handle = NetsecGetTxHandle (LanDriver);
+  if (pkt_handle == NULL) {
+    ReturnUnlock (EFI_OUT_OF_RESOURCES);
+  }
+
+  pkt_handle->Buffer = BufAddr;
+
   Status = DmaMap (MapOperationBusMasterRead, BufAddr, &BufSize,
              &scat_info.phys_addr, &pkt_handle->Mapping);
   if (EFI_ERROR (Status)) {
+    NetsecPutTxHandle (LanDriver, pkt_handle);
     goto ExitUnlock;
   }
 
@@ -727,12 +839,6 @@ SnpTransmit (
   tx_pkt_ctrl.pass_through_flag     = OGMA_TRUE;
   tx_pkt_ctrl.target_desc_ring_id   = OGMA_DESC_RING_ID_GMAC;
 
-  // check empty slot
-  do {
-    tx_avail_num = ogma_get_tx_avail_num (LanDriver->Handle,
-                                          OGMA_DESC_RING_ID_NRM_TX);
-  } while (tx_avail_num < SCAT_NUM);
-
   // send
   ogma_err = ogma_set_tx_pkt_data (LanDriver->Handle,
                                    OGMA_DESC_RING_ID_NRM_TX,
@@ -743,7 +849,7 @@ SnpTransmit (
 
   if (ogma_err != OGMA_ERR_OK) {
     DmaUnmap (pkt_handle->Mapping);
-    FreePool (pkt_handle);
+    NetsecPutTxHandle (LanDriver, pkt_handle);
     DEBUG ((DEBUG_ERROR,
       "NETSEC: ogma_set_tx_pkt_data failed with error code: %d\n",
       (INT32)ogma_err));
@@ -756,12 +862,10 @@ SnpTransmit (
   //
   InsertTailList (&LanDriver->TxBufferList, &pkt_handle->Link);
 
-  gBS->RestoreTPL (SavedTpl);
-  return EFI_SUCCESS;
+  Status = EFI_SUCCESS;
 
   // Restore TPL and return
 ExitUnlock:
-  FreePool (pkt_handle);
   gBS->RestoreTPL (SavedTpl);
   return Status;
 }
@@ -830,8 +934,10 @@ SnpReceive (
       ReturnUnlock (EFI_DEVICE_ERROR);
     }
 
-    DmaUnmap (pkt_handle->Mapping);
-    pkt_handle->Mapping = NULL;
+    if (pkt_handle->Mapping != NULL) {
+      DmaUnmap (pkt_handle->Mapping);
+      pkt_handle->Mapping = NULL;
+    }
 
     CopyMem (Data, (VOID *)rx_data.addr, len);
     *BuffSize = len;
@@ -847,12 +953,6 @@ SnpReceive (
     *HdrSize = LanDriver->SnpMode.MediaHeaderSize;
   }
 
-  ogma_clear_desc_ring_irq_status (LanDriver->Handle,
-                                   OGMA_DESC_RING_ID_NRM_TX,
-                                   OGMA_CH_IRQ_REG_EMPTY);
-
-  ogma_clean_tx_desc_ring (LanDriver->Handle, OGMA_DESC_RING_ID_NRM_TX);
-
   ogma_enable_top_irq (LanDriver->Handle,
                        OGMA_TOP_IRQ_REG_NRM_TX | OGMA_TOP_IRQ_REG_NRM_RX);
 
@@ -904,6 +1004,8 @@ NetsecInit (
   if (EFI_ERROR (Status)) {
     DEBUG ((DEBUG_ERROR,
       "NETSEC:%a(): Probe failed with status %d\n", __FUNCTION__, Status));
+    // ogma_init () may have created the packet buffer pool before failing
+    pfdep_free_pkt_buf_pool (LanDriver->Handle);
     goto CloseDeviceProtocol;
   }
 
@@ -955,8 +1057,8 @@ NetsecInit (
   // Mac address is changeable
   SnpMode->MacAddressChangeable = TRUE;
 
-  // We can only transmit one packet at a time
-  SnpMode->MultipleTxSupported = FALSE;
+  // Transmit () returns as soon as the packet is queued
+  SnpMode->MultipleTxSupported = TRUE;
 
   // MediaPresent checks for cable connection and partner link
   SnpMode->MediaPresentSupported = TRUE;
@@ -966,6 +1068,7 @@ NetsecInit (
   SetMem (&SnpMode->BroadcastAddress, sizeof (EFI_MAC_ADDRESS), 0xFF);
 
   InitializeListHead (&LanDriver->TxBufferList);
+  InitializeListHead (&LanDriver->TxHandleFreeList);
 
   LanDriver->DevicePath.Netsec.Header.Type = MESSAGING_DEVICE_PATH;
   LanDriver->DevicePath.Netsec.Header.SubType = MSG_MAC_ADDR_DP;
@@ -991,6 +1094,7 @@ NetsecInit (
     DEBUG ((DEBUG_ERROR, "%a: InstallMultipleProtocolInterfaces failed - %r\n",
       __FUNCTION__, Status));
     ogma_terminate (LanDriver->Handle);
+    pfdep_free_pkt_buf_pool (LanDriver->Handle);
     goto CloseDeviceProtocol;
   }
   return EFI_SUCCESS;
@@ -1014,6 +1118,7 @@ NetsecRelease (
   EFI_SIMPLE_NETWORK_PROTOCOL   *Snp;
   NETSEC_DRIVER                 *LanDriver;
   EFI_STATUS                    Status;
+  LIST_ENTRY                    *Link;
 
   Status = gBS->HandleProtocol (ControllerHandle,
                                 &gEfiSimpleNetworkProtocolGuid,
@@ -1038,9 +1143,16 @@ NetsecRelease (
   }
 
   ogma_terminate (LanDriver->Handle);
+  pfdep_free_pkt_buf_pool (LanDriver->Handle);
 
   gBS->CloseEvent (LanDriver->ExitBootEvent);
 
+  while (!IsListEmpty (&LanDriver->TxHandleFreeList)) {
+    Link = GetFirstNode (&LanDriver->TxHandleFreeList);
+    RemoveEntryList (Link);
+    FreePool (BASE_CR (Link, PACKET_HANDLE, Link));
+  }
+
   Status = gBS->CloseProtocol (ControllerHandle,
                                &gEdkiiNonDiscoverableDeviceProtocolGuid,
                                DriverBindingHandle,
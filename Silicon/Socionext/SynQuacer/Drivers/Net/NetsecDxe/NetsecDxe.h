@@ -69,6 +69,12 @@ typedef struct {
   // List of submitted TX buffers
   LIST_ENTRY                        TxBufferList;
 
+  // List of TX packet handles available for reuse
+  LIST_ENTRY                        TxHandleFreeList;
+
+  // Periodic event reclaiming completed TX descriptors
+  EFI_EVENT                         TxReclaimEvent;
+
   EFI_EVENT                         ExitBootEvent;
 
   NON_DISCOVERABLE_DEVICE           *Dev;
@@ -115,4 +121,7 @@ NetsecRelease (
 #define RXINT_TMR_CNT_US            0
 #define RXINT_PKTCNT                1
 
+// Period of the TX reclaim timer, in 100 ns units
+#define TX_RECLAIM_PERIOD           EFI_TIMER_PERIOD_MILLISECONDS (1)
+
 #endif
@@ -66,6 +66,8 @@ typedef struct {
     VOID        *Mapping;
     BOOLEAN     RecycleForTx;
     BOOLEAN     Released;
+    BOOLEAN     Pooled;
+    EFI_PHYSICAL_ADDRESS PhysAddr;
 } PACKET_HANDLE;
 
 typedef VOID *pfdep_dev_handle_t;
@@ -149,6 +151,10 @@ void pfdep_free_pkt_buf (
     pfdep_pkt_handle_t pkt_handle
     );
 
+void pfdep_free_pkt_buf_pool (
+    pfdep_dev_handle_t dev_handle
+    );
+
 static __inline pfdep_err_t pfdep_init_hard_lock(pfdep_hard_lock_t *hard_lock_p)
 {
     (void)hard_lock_p; /* suppress compiler warning */
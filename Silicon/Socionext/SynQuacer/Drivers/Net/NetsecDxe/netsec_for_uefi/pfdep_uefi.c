@@ -102,14 +102,86 @@ pfdep_dma_free (
 }
 
 //
-// On the receive path, we allocate a new packet and link it into the RX ring
-// before returning the received packet to the caller. This means we perform
-// one allocation and one free operation for each buffer received.
-// So let's cache a single packet, and get rid of most of the alloc/free
-// overhead on the RX path.
+// Packet buffers are taken from a pool of buffers that are allocated and
+// mapped for DMA only once, when ogma_init () first populates the RX ring,
+// and are then recycled between the RX ring and SnpReceive (). On the
+// receive path, a replacement buffer is linked into the RX ring before the
+// received one is given back, so the pool holds a few spare buffers on top
+// of one per RX descriptor. Should it ever run dry, buffers are allocated
+// and mapped one by one.
 //
-STATIC pfdep_pkt_handle_t mSparePacketBuffer;
-STATIC UINT32 mSparePacketBufferSize;
+#define PKT_BUF_POOL_SPARE    4
+
+STATIC LIST_ENTRY     mPktBufPoolFreeList =
+                        INITIALIZE_LIST_HEAD_VARIABLE (mPktBufPoolFreeList);
+STATIC BOOLEAN        mPktBufPoolInitialized;
+STATIC PACKET_HANDLE  *mPktBufPoolHandles;
+STATIC VOID           *mPktBufPoolBase;
+STATIC VOID           *mPktBufPoolMapping;
+STATIC UINTN          mPktBufPoolPages;
+STATIC UINTN          mPktBufPoolBufSize;
+
+STATIC
+EFI_STATUS
+PktBufPoolCreate (
+  IN  UINTN                     BufSize
+  )
+{
+  EFI_STATUS            Status;
+  EFI_PHYSICAL_ADDRESS  PhysAddr;
+  PACKET_HANDLE         *Handle;
+  UINTN                 NumBuffers;
+  UINTN                 NumBytes;
+  UINTN                 Index;
+
+  NumBuffers = FixedPcdGet16 (PcdDecRxDescNum) + PKT_BUF_POOL_SPARE;
+  BufSize = ALIGN_VALUE (BufSize, mCpu->DmaBufferAlignment);
+
+  mPktBufPoolHandles = AllocateZeroPool (NumBuffers * sizeof (PACKET_HANDLE));
+  if (mPktBufPoolHandles == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  mPktBufPoolPages = EFI_SIZE_TO_PAGES (NumBuffers * BufSize);
+  Status = DmaAllocateBuffer (EfiBootServicesData, mPktBufPoolPages,
+             &mPktBufPoolBase);
+  if (EFI_ERROR (Status)) {
+    goto FreeHandles;
+  }
+
+  NumBytes = EFI_PAGES_TO_SIZE (mPktBufPoolPages);
+  Status = DmaMap (MapOperationBusMasterCommonBuffer, mPktBufPoolBase,
+             &NumBytes, &PhysAddr, &mPktBufPoolMapping);
+  if (EFI_ERROR (Status)) {
+    goto FreeBuffer;
+  }
+
+  if (NumBytes < NumBuffers * BufSize) {
+    DmaUnmap (mPktBufPoolMapping);
+    Status = EFI_OUT_OF_RESOURCES;
+    goto FreeBuffer;
+  }
+
+  for (Index = 0; Index < NumBuffers; Index++) {
+    Handle = &mPktBufPoolHandles[Index];
+    Handle->Buffer = (UINT8 *)mPktBufPoolBase + Index * BufSize;
+    Handle->PhysAddr = PhysAddr + Index * BufSize;
+    Handle->Pooled = TRUE;
+    InsertTailList (&mPktBufPoolFreeList, &Handle->Link);
+  }
+
+  mPktBufPoolBufSize = BufSize;
+  return EFI_SUCCESS;
+
+FreeBuffer:
+  DmaFreeBuffer (mPktBufPoolPages, mPktBufPoolBase);
+  mPktBufPoolBase = NULL;
+
+FreeHandles:
+  FreePool (mPktBufPoolHandles);
+  mPktBufPoolHandles = NULL;
+  return Status;
+}
 
 pfdep_err_t
 pfdep_alloc_pkt_buf (
@@ -122,22 +194,38 @@ pfdep_alloc_pkt_buf (
 {
   EFI_STATUS    Status;
   UINTN         NumBytes;
+  LIST_ENTRY    *Link;
 
-  NumBytes = ALIGN_VALUE (len, mCpu->DmaBufferAlignment);
-
-  if (InterlockedCompareExchange32 (&mSparePacketBufferSize, len, 0) == len) {
-    *pkt_handle_p = mSparePacketBuffer;
-  } else {
-    *pkt_handle_p = AllocateZeroPool (NumBytes + sizeof(PACKET_HANDLE) +
-                                      (mCpu->DmaBufferAlignment - 8));
-    if (*pkt_handle_p == NULL) {
-      return PFDEP_ERR_ALLOC;
+  if (!mPktBufPoolInitialized) {
+    mPktBufPoolInitialized = TRUE;
+    Status = PktBufPoolCreate (len);
+    if (EFI_ERROR (Status)) {
+      DEBUG ((DEBUG_WARN,
+        "NETSEC: failed to create packet buffer pool - %r\n", Status));
     }
+  }
 
-    (*pkt_handle_p)->Buffer = ALIGN_POINTER (*pkt_handle_p,
-                                             mCpu->DmaBufferAlignment);
+  if (len <= mPktBufPoolBufSize && !IsListEmpty (&mPktBufPoolFreeList)) {
+    Link = GetFirstNode (&mPktBufPoolFreeList);
+    RemoveEntryList (Link);
+
+    *pkt_handle_p = BASE_CR (Link, PACKET_HANDLE, Link);
+    *addr_p = (*pkt_handle_p)->Buffer;
+    *phys_addr_p = (*pkt_handle_p)->PhysAddr;
+    return PFDEP_ERR_OK;
   }
 
+  NumBytes = ALIGN_VALUE (len, mCpu->DmaBufferAlignment);
+
+  *pkt_handle_p = AllocateZeroPool (NumBytes + sizeof(PACKET_HANDLE) +
+                                    (mCpu->DmaBufferAlignment - 8));
+  if (*pkt_handle_p == NULL) {
+    return PFDEP_ERR_ALLOC;
+  }
+
+  (*pkt_handle_p)->Buffer = ALIGN_POINTER (*pkt_handle_p,
+                                           mCpu->DmaBufferAlignment);
+
   *addr_p = (*pkt_handle_p)->Buffer;
   Status = DmaMap (MapOperationBusMasterWrite, *addr_p, &NumBytes, phys_addr_p,
              &(*pkt_handle_p)->Mapping);
@@ -162,15 +250,42 @@ pfdep_free_pkt_buf (
     return;
   }
 
+  if (pkt_handle->Pooled) {
+    InsertHeadList (&mPktBufPoolFreeList, &pkt_handle->Link);
+    return;
+  }
+
   if (pkt_handle->Mapping != NULL) {
     DmaUnmap (pkt_handle->Mapping);
   }
 
   if (pkt_handle->RecycleForTx) {
       pkt_handle->Released = TRUE;
-  } else if (!InterlockedCompareExchange32 (&mSparePacketBufferSize, 0, len)) {
-    mSparePacketBuffer = pkt_handle;
   } else {
     FreePool (pkt_handle);
   }
 }
+
+//
+// Release the packet buffer pool. Must be called after ogma_terminate (),
+// once all pooled buffers have been returned.
+//
+VOID
+pfdep_free_pkt_buf_pool (
+  IN  pfdep_dev_handle_t        dev_handle
+  )
+{
+  if (mPktBufPoolHandles != NULL) {
+    DmaUnmap (mPktBufPoolMapping);
+    DmaFreeBuffer (mPktBufPoolPages, mPktBufPoolBase);
+    FreePool (mPktBufPoolHandles);
+  }
+
+  InitializeListHead (&mPktBufPoolFreeList);
+  mPktBufPoolInitialized = FALSE;
+  mPktBufPoolHandles = NULL;
+  mPktBufPoolBase = NULL;
+  mPktBufPoolMapping = NULL;
+  mPktBufPoolPages = 0;
+  mPktBufPoolBufSize = 0;
+}